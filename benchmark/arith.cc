@@ -0,0 +1,126 @@
+#include "decimal.h"
+#include "decimal_arith.h"
+#include "decimal_column.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace bignum;
+
+// Amounts of orders, prices (below 10^6, with 4 decimal places) times quantities (below 10^5).
+static constexpr size_t kNumOrders = 1 << 16;
+
+static void make_orders(std::vector<Decimal> &prices, std::vector<Decimal> &quantities) {
+        std::mt19937_64 rng(42);
+        for (size_t i = 0; i < kNumOrders; ++i) {
+                prices.push_back(Decimal(static_cast<int64_t>(rng() % 10000000000)) /
+                                 Decimal(10000));
+                quantities.push_back(Decimal(static_cast<int64_t>(rng() % 100000)));
+        }
+}
+
+static void decimal_mul_loop(benchmark::State &state) {
+        std::vector<Decimal> prices, quantities;
+        make_orders(prices, quantities);
+        std::vector<Decimal> amounts(kNumOrders);
+        for (auto _ : state) {
+                for (size_t i = 0; i < kNumOrders; ++i) {
+                        amounts[i] = prices[i];
+                        amounts[i] *= quantities[i];
+                }
+                benchmark::DoNotOptimize(amounts.data());
+        }
+        state.SetItemsProcessed(state.iterations() * kNumOrders);
+}
+
+static void decimal_mul_unchecked_loop(benchmark::State &state) {
+        std::vector<Decimal> prices, quantities;
+        make_orders(prices, quantities);
+        std::vector<Decimal> amounts(kNumOrders);
+        for (auto _ : state) {
+                for (size_t i = 0; i < kNumOrders; ++i) {
+                        amounts[i] = prices[i];
+                        amounts[i].mul_unchecked(quantities[i]);
+                }
+                benchmark::DoNotOptimize(amounts.data());
+        }
+        state.SetItemsProcessed(state.iterations() * kNumOrders);
+}
+
+static void decimal_add_loop(benchmark::State &state) {
+        std::vector<Decimal> prices, quantities;
+        make_orders(prices, quantities);
+        for (auto _ : state) {
+                Decimal sum(0);
+                for (const Decimal &price : prices) {
+                        sum += price;
+                }
+                benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * kNumOrders);
+}
+
+static void decimal_add_unchecked_loop(benchmark::State &state) {
+        std::vector<Decimal> prices, quantities;
+        make_orders(prices, quantities);
+        for (auto _ : state) {
+                Decimal sum(0);
+                for (const Decimal &price : prices) {
+                        sum.add_unchecked(price);
+                }
+                benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * kNumOrders);
+}
+
+// Columns with or without bounds, Arg(1) or Arg(0).
+static void decimal_column_mul(benchmark::State &state) {
+        std::vector<Decimal> prices, quantities;
+        make_orders(prices, quantities);
+        DecimalColumn price_column(4);
+        DecimalColumn quantity_column(0);
+        if (state.range(0)) {
+                price_column.set_bound(Decimal(1000000));
+                quantity_column.set_bound(Decimal(100000));
+        }
+        for (size_t i = 0; i < kNumOrders; ++i) {
+                price_column.push_back(prices[i]);
+                quantity_column.push_back(quantities[i]);
+        }
+        DecimalColumn amounts;
+        for (auto _ : state) {
+                mul(price_column, quantity_column, amounts);
+                benchmark::DoNotOptimize(amounts.payload().data());
+        }
+        state.SetItemsProcessed(state.iterations() * kNumOrders);
+}
+
+static void decimal_column_add(benchmark::State &state) {
+        std::vector<Decimal> prices, quantities;
+        make_orders(prices, quantities);
+        DecimalColumn price_column(4);
+        DecimalColumn other_column(4);
+        if (state.range(0)) {
+                price_column.set_bound(Decimal(1000000));
+                other_column.set_bound(Decimal(1000000));
+        }
+        for (size_t i = 0; i < kNumOrders; ++i) {
+                price_column.push_back(prices[i]);
+                other_column.push_back(prices[kNumOrders - 1 - i]);
+        }
+        DecimalColumn sums;
+        for (auto _ : state) {
+                add(price_column, other_column, sums);
+                benchmark::DoNotOptimize(sums.payload().data());
+        }
+        state.SetItemsProcessed(state.iterations() * kNumOrders);
+}
+
+BENCHMARK(decimal_mul_loop);
+BENCHMARK(decimal_mul_unchecked_loop);
+BENCHMARK(decimal_add_loop);
+BENCHMARK(decimal_add_unchecked_loop);
+BENCHMARK(decimal_column_mul)->Arg(0)->Arg(1);
+BENCHMARK(decimal_column_add)->Arg(0)->Arg(1);
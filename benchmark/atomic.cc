@@ -0,0 +1,38 @@
+#include "decimal.h"
+#include "decimal_atomic.h"
+
+#include <benchmark/benchmark.h>
+#include <mutex>
+
+using namespace bignum;
+
+// A running total shared by all threads, updated with a mutex or as an AtomicDecimal.
+static Decimal mutex_total;
+static std::mutex total_mutex;
+static AtomicDecimal atomic_total;
+
+static void decimal_mutex_add(benchmark::State &state) {
+        const Decimal amount("12.34");
+        for (auto _ : state) {
+                std::lock_guard<std::mutex> guard(total_mutex);
+                mutex_total += amount;
+        }
+}
+
+static void decimal_atomic_add(benchmark::State &state) {
+        const Decimal amount("12.34");
+        for (auto _ : state) {
+                benchmark::DoNotOptimize(atomic_total.add(amount));
+        }
+}
+
+static void decimal_atomic_load(benchmark::State &state) {
+        for (auto _ : state) {
+                Decimal total = atomic_total.load();
+                benchmark::DoNotOptimize(total);
+        }
+}
+
+BENCHMARK(decimal_mutex_add)->ThreadRange(1, 8);
+BENCHMARK(decimal_atomic_add)->ThreadRange(1, 8);
+BENCHMARK(decimal_atomic_load)->Threads(1);
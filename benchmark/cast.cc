@@ -0,0 +1,56 @@
+#include "decimal.h"
+#include "decimal_cast.h"
+#include "decimal_column.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace bignum;
+
+// CAST of a DECIMAL(18, 4) column to DECIMAL(12, 2).
+static constexpr size_t kNumValues = 1 << 16;
+
+static std::vector<Decimal> make_values() {
+        std::mt19937_64 rng(42);
+        std::vector<Decimal> values;
+        for (size_t i = 0; i < kNumValues; ++i) {
+                values.push_back(Decimal(static_cast<int64_t>(rng() % 100000000000)) /
+                                 Decimal(10000));
+        }
+        return values;
+}
+
+static void decimal_rescale_loop(benchmark::State &state) {
+        const std::vector<Decimal> values = make_values();
+        std::vector<Decimal> result(values.size());
+        for (auto _ : state) {
+                for (size_t i = 0; i < values.size(); ++i) {
+                        result[i] = values[i];
+                        if (result[i].rescale(2, RoundingMode::kHalfEven) ||
+                            result[i].precision() > 12) {
+                                result[i] = Decimal(0);
+                        }
+                }
+                benchmark::DoNotOptimize(result.data());
+        }
+        state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+static void decimal_column_cast(benchmark::State &state) {
+        DecimalColumn column(4);
+        for (const Decimal &v : make_values()) {
+                column.push_back(v);
+        }
+        DecimalColumn result(2);
+        std::vector<uint64_t> overflow(kNumValues / 64);
+        for (auto _ : state) {
+                size_t n = cast(column, 12, RoundingMode::kHalfEven, result, overflow);
+                benchmark::DoNotOptimize(n);
+        }
+        state.SetItemsProcessed(state.iterations() * column.size());
+}
+
+BENCHMARK(decimal_rescale_loop);
+BENCHMARK(decimal_column_cast);
@@ -0,0 +1,56 @@
+#include "decimal.h"
+#include "decimal_column.h"
+#include "decimal_filter.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace bignum;
+
+// A price column with 2 decimal places and `price > 5000.005`, which selects about half.
+static constexpr size_t kNumPrices = 1 << 16;
+
+static std::vector<Decimal> make_prices() {
+        std::mt19937_64 rng(42);
+        std::vector<Decimal> prices;
+        for (size_t i = 0; i < kNumPrices; ++i) {
+                prices.push_back(Decimal(static_cast<int64_t>(rng() % 1000000)) / Decimal(100));
+        }
+        return prices;
+}
+
+static void decimal_compare_loop(benchmark::State &state) {
+        const std::vector<Decimal> prices = make_prices();
+        const Decimal threshold("5000.005");
+        std::vector<uint64_t> bitmap(kNumPrices / 64);
+        for (auto _ : state) {
+                for (size_t i = 0; i < prices.size(); ++i) {
+                        if (prices[i] > threshold) {
+                                bitmap[i / 64] |= uint64_t{1} << (i % 64);
+                        } else {
+                                bitmap[i / 64] &= ~(uint64_t{1} << (i % 64));
+                        }
+                }
+                benchmark::DoNotOptimize(bitmap.data());
+        }
+        state.SetItemsProcessed(state.iterations() * prices.size());
+}
+
+static void decimal_column_filter(benchmark::State &state) {
+        DecimalColumn column(2);
+        for (const Decimal &price : make_prices()) {
+                column.push_back(price);
+        }
+        const Decimal threshold("5000.005");
+        std::vector<uint64_t> bitmap(kNumPrices / 64);
+        for (auto _ : state) {
+                filter(column, CompareOp::kGt, threshold, bitmap);
+                benchmark::DoNotOptimize(bitmap.data());
+        }
+        state.SetItemsProcessed(state.iterations() * column.size());
+}
+
+BENCHMARK(decimal_compare_loop);
+BENCHMARK(decimal_column_filter);
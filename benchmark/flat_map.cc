@@ -0,0 +1,80 @@
+#include "decimal.h"
+#include "decimal_flat_map.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace bignum;
+
+// A GROUP BY on a decimal column: 4096 rows with 256 distinct prices.
+static std::vector<Decimal> make_group_by_keys() {
+        std::vector<Decimal> keys;
+        for (int64_t i = 0; i < 4096; ++i) {
+                keys.push_back(Decimal((i * 7919) % 256 * 125) / Decimal(100));
+        }
+        return keys;
+}
+
+static void decimal_flat_map_group_by(benchmark::State &state) {
+        const std::vector<Decimal> keys = make_group_by_keys();
+        for (auto _ : state) {
+                DecimalFlatMap<int64_t> counts;
+                for (const Decimal &key : keys) {
+                        counts[key]++;
+                }
+                benchmark::DoNotOptimize(counts.size());
+        }
+        state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void string_unordered_map_group_by(benchmark::State &state) {
+        const std::vector<Decimal> keys = make_group_by_keys();
+        for (auto _ : state) {
+                std::unordered_map<std::string, int64_t> counts;
+                for (const Decimal &key : keys) {
+                        counts[key.to_string()]++;
+                }
+                benchmark::DoNotOptimize(counts.size());
+        }
+        state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void decimal_flat_map_lookup(benchmark::State &state) {
+        const std::vector<Decimal> keys = make_group_by_keys();
+        DecimalFlatMap<int64_t> counts;
+        for (const Decimal &key : keys) {
+                counts[key]++;
+        }
+        for (auto _ : state) {
+                int64_t sum = 0;
+                for (const Decimal &key : keys) {
+                        sum += *counts.find(key);
+                }
+                benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void string_unordered_map_lookup(benchmark::State &state) {
+        const std::vector<Decimal> keys = make_group_by_keys();
+        std::unordered_map<std::string, int64_t> counts;
+        for (const Decimal &key : keys) {
+                counts[key.to_string()]++;
+        }
+        for (auto _ : state) {
+                int64_t sum = 0;
+                for (const Decimal &key : keys) {
+                        sum += counts.find(key.to_string())->second;
+                }
+                benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+BENCHMARK(decimal_flat_map_group_by);
+BENCHMARK(string_unordered_map_group_by);
+BENCHMARK(decimal_flat_map_lookup);
+BENCHMARK(string_unordered_map_lookup);
@@ -0,0 +1,128 @@
+#include "decimal.h"
+#include "decimal_math.h"
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdint>
+
+using namespace bignum;
+
+// Daily compounding over a year, (1 + r)^365, by repeated multiplications or by pow().
+static void decimal_compound_mul_loop(benchmark::State &state) {
+        const Decimal rate("1.000136986301369863013698630137");
+        for (auto _ : state) {
+                Decimal factor(1);
+                for (int32_t i = 0; i < 365; ++i) {
+                        factor *= rate;
+                }
+                benchmark::DoNotOptimize(factor);
+        }
+}
+
+static void decimal_compound_pow(benchmark::State &state) {
+        const Decimal rate("1.000136986301369863013698630137");
+        for (auto _ : state) {
+                Decimal factor = pow(rate, 365);
+                benchmark::DoNotOptimize(factor);
+        }
+}
+
+// A small power, which is computed in int128
+static void decimal_small_pow(benchmark::State &state) {
+        const Decimal rate("1.05");
+        for (auto _ : state) {
+                Decimal factor = pow(rate, 10);
+                benchmark::DoNotOptimize(factor);
+        }
+}
+
+// Square roots of a variance, exactly to 10 digits or through double
+static void decimal_sqrt(benchmark::State &state) {
+        const Decimal variance("0.0004213579");
+        for (auto _ : state) {
+                Decimal vol = sqrt(variance, 10);
+                benchmark::DoNotOptimize(vol);
+        }
+}
+
+static void decimal_sqrt_double(benchmark::State &state) {
+        const Decimal variance("0.0004213579");
+        for (auto _ : state) {
+                double root = std::sqrt(variance.to_double());
+                Decimal vol(root);
+                benchmark::DoNotOptimize(vol);
+        }
+}
+
+// A root beyond int128, which goes through GMP
+static void decimal_sqrt_wide(benchmark::State &state) {
+        const Decimal d(2);
+        for (auto _ : state) {
+                Decimal root = sqrt(d, 30);
+                benchmark::DoNotOptimize(root);
+        }
+}
+
+static void decimal_nth_root(benchmark::State &state) {
+        const Decimal rate("1.05");
+        for (auto _ : state) {
+                Decimal monthly = nth_root(rate, 12, 30);
+                benchmark::DoNotOptimize(monthly);
+        }
+}
+
+// Continuous discounting e^(-rt) and log returns, exactly to 20 digits or through double
+static void decimal_exp(benchmark::State &state) {
+        const Decimal rt("-0.0375");
+        for (auto _ : state) {
+                Decimal discount = exp(rt, 20);
+                benchmark::DoNotOptimize(discount);
+        }
+}
+
+static void decimal_exp_double(benchmark::State &state) {
+        const Decimal rt("-0.0375");
+        for (auto _ : state) {
+                double discount = std::exp(rt.to_double());
+                Decimal result(discount);
+                benchmark::DoNotOptimize(result);
+        }
+}
+
+static void decimal_ln(benchmark::State &state) {
+        const Decimal ratio("1.0123456789");
+        for (auto _ : state) {
+                Decimal log_return = ln(ratio, 20);
+                benchmark::DoNotOptimize(log_return);
+        }
+}
+
+static void decimal_ln_double(benchmark::State &state) {
+        const Decimal ratio("1.0123456789");
+        for (auto _ : state) {
+                double log_return = std::log(ratio.to_double());
+                Decimal result(log_return);
+                benchmark::DoNotOptimize(result);
+        }
+}
+
+static void decimal_log10(benchmark::State &state) {
+        const Decimal d("12345.6789");
+        for (auto _ : state) {
+                Decimal result = log10(d, 30);
+                benchmark::DoNotOptimize(result);
+        }
+}
+
+BENCHMARK(decimal_compound_mul_loop);
+BENCHMARK(decimal_compound_pow);
+BENCHMARK(decimal_small_pow);
+BENCHMARK(decimal_sqrt);
+BENCHMARK(decimal_sqrt_double);
+BENCHMARK(decimal_sqrt_wide);
+BENCHMARK(decimal_nth_root);
+BENCHMARK(decimal_exp);
+BENCHMARK(decimal_exp_double);
+BENCHMARK(decimal_ln);
+BENCHMARK(decimal_ln_double);
+BENCHMARK(decimal_log10);
@@ -1,7 +1,9 @@
 #include "decimal.h"
+#include "decimal_divisor.h"
 
 #include <benchmark/benchmark.h>
 #include <cstdint>
+#include <vector>
 
 using namespace bignum;
 
@@ -25,5 +27,133 @@ static void small_decimal_zero_scale_addition(benchmark::State &state) {
         }
 }
 
+static void decimal_division(benchmark::State &state) {
+        Decimal a("123456.789");
+        Decimal b("7.0245");
+        for (auto _ : state) {
+                Decimal c = a / b;
+                benchmark::DoNotOptimize(c);
+                benchmark::ClobberMemory();
+        }
+}
+
+// A 30-scale dividend, where only 8 fractional digits are needed
+static void decimal_division_with_context(benchmark::State &state) {
+        Decimal a("123456.789012345678901234567890123456");
+        Decimal b("7.0245");
+        const int32_t max_scale = static_cast<int32_t>(state.range(0));
+        ScopedDecimalContext guard(DecimalContext{.max_scale = max_scale});
+        for (auto _ : state) {
+                Decimal c = a / b;
+                benchmark::DoNotOptimize(c);
+                benchmark::ClobberMemory();
+        }
+}
+
+static void decimal_precomputed_divisor_division(benchmark::State &state) {
+        Decimal a("123456.789");
+        DecimalDivisor b(Decimal("7.0245"));
+        for (auto _ : state) {
+                Decimal c = a / b;
+                benchmark::DoNotOptimize(c);
+                benchmark::ClobberMemory();
+        }
+}
+
+static void decimal_modulo(benchmark::State &state) {
+        Decimal a("123456.789");
+        Decimal b("7.0245");
+        for (auto _ : state) {
+                Decimal c = a % b;
+                benchmark::DoNotOptimize(c);
+                benchmark::ClobberMemory();
+        }
+}
+
+// Lots and residual, with a division and a modulo or with a single divmod()
+static void decimal_division_and_modulo(benchmark::State &state) {
+        Decimal a("123456.789");
+        Decimal b("7.0245");
+        for (auto _ : state) {
+                Decimal q = a / b;
+                q.rescale(0, RoundingMode::kDown);
+                Decimal r = a % b;
+                benchmark::DoNotOptimize(q);
+                benchmark::DoNotOptimize(r);
+                benchmark::ClobberMemory();
+        }
+}
+
+static void decimal_divmod(benchmark::State &state) {
+        Decimal a("123456.789");
+        Decimal b("7.0245");
+        for (auto _ : state) {
+                Decimal q;
+                Decimal r;
+                a.divmod(b, q, r);
+                benchmark::DoNotOptimize(q);
+                benchmark::DoNotOptimize(r);
+                benchmark::ClobberMemory();
+        }
+}
+
+// The quotient is stored as int64
+static void decimal_addition_after_division(benchmark::State &state) {
+        Decimal q = Decimal("123456.789") / Decimal("7.0245");
+        Decimal b("1.5");
+        for (auto _ : state) {
+                Decimal c = q + b;
+                benchmark::DoNotOptimize(c);
+                benchmark::ClobberMemory();
+        }
+}
+
+// 39~76 digits: handled by the Int256 tier without calling into gmp
+static void decimal_int256_addition(benchmark::State &state) {
+        Decimal a("12345678901234567890123456789012345678901.123456789");
+        Decimal b("98765432109876543210987654321098765432109.987654321");
+        for (auto _ : state) {
+                Decimal c = a + b;
+                benchmark::DoNotOptimize(c);
+                benchmark::ClobberMemory();
+        }
+}
+
+static void decimal_int256_multiplication(benchmark::State &state) {
+        Decimal a("12345678901234567890123456789.123456789");
+        Decimal b("98765432109876543210987654321.987654321");
+        for (auto _ : state) {
+                Decimal c = a * b;
+                benchmark::DoNotOptimize(c);
+                benchmark::ClobberMemory();
+        }
+}
+
+// Hash a column of mostly small keys, as when building the hash table of a join or GROUP BY
+static void decimal_batch_hash(benchmark::State &state) {
+        std::vector<Decimal> values;
+        for (int64_t i = 0; i < 1024; ++i) {
+                values.push_back(Decimal(i * 7919) / Decimal(100));
+        }
+        values.push_back(Decimal("12345678901234567890123456789.123456789"));
+        std::vector<uint64_t> hashes(values.size());
+        for (auto _ : state) {
+                hash(values, hashes);
+                benchmark::DoNotOptimize(hashes.data());
+                benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * values.size());
+}
+
 BENCHMARK(small_int64_addition);
 BENCHMARK(small_decimal_zero_scale_addition);
+BENCHMARK(decimal_division);
+BENCHMARK(decimal_division_with_context)->Arg(30)->Arg(8);
+BENCHMARK(decimal_precomputed_divisor_division);
+BENCHMARK(decimal_modulo);
+BENCHMARK(decimal_division_and_modulo);
+BENCHMARK(decimal_divmod);
+BENCHMARK(decimal_addition_after_division);
+BENCHMARK(decimal_int256_addition);
+BENCHMARK(decimal_int256_multiplication);
+BENCHMARK(decimal_batch_hash);
@@ -0,0 +1,47 @@
+#include "decimal.h"
+#include "decimal_column.h"
+#include "decimal_reduce.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace bignum;
+
+// The largest of a price column with 2 decimal places.
+static constexpr size_t kNumPrices = 1 << 16;
+
+static std::vector<Decimal> make_prices() {
+        std::mt19937_64 rng(42);
+        std::vector<Decimal> prices;
+        for (size_t i = 0; i < kNumPrices; ++i) {
+                prices.push_back(Decimal(static_cast<int64_t>(rng() % 1000000)) / Decimal(100));
+        }
+        return prices;
+}
+
+static void decimal_max_element(benchmark::State &state) {
+        const std::vector<Decimal> prices = make_prices();
+        for (auto _ : state) {
+                auto it = std::max_element(prices.begin(), prices.end());
+                benchmark::DoNotOptimize(it);
+        }
+        state.SetItemsProcessed(state.iterations() * prices.size());
+}
+
+static void decimal_column_argmax(benchmark::State &state) {
+        DecimalColumn column(2);
+        for (const Decimal &price : make_prices()) {
+                column.push_back(price);
+        }
+        for (auto _ : state) {
+                size_t i = argmax(column);
+                benchmark::DoNotOptimize(i);
+        }
+        state.SetItemsProcessed(state.iterations() * column.size());
+}
+
+BENCHMARK(decimal_max_element);
+BENCHMARK(decimal_column_argmax);
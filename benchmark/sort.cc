@@ -0,0 +1,58 @@
+#include "decimal.h"
+#include "decimal_sort.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace bignum;
+
+// A price column with 2 decimal places.
+static std::vector<Decimal> make_prices(size_t n) {
+        std::mt19937_64 rng(42);
+        std::vector<Decimal> prices;
+        for (size_t i = 0; i < n; ++i) {
+                prices.push_back(Decimal(static_cast<int64_t>(rng() % 100000000)) / Decimal(100));
+        }
+        return prices;
+}
+
+static void decimal_std_sort(benchmark::State &state) {
+        const std::vector<Decimal> prices = make_prices(state.range(0));
+        for (auto _ : state) {
+                state.PauseTiming();
+                std::vector<Decimal> values = prices;
+                state.ResumeTiming();
+                std::sort(values.begin(), values.end());
+                benchmark::DoNotOptimize(values.data());
+        }
+        state.SetItemsProcessed(state.iterations() * prices.size());
+}
+
+static void decimal_radix_sort(benchmark::State &state) {
+        const std::vector<Decimal> prices = make_prices(state.range(0));
+        for (auto _ : state) {
+                state.PauseTiming();
+                std::vector<Decimal> values = prices;
+                state.ResumeTiming();
+                sort(values, static_cast<int32_t>(state.range(1)));
+                benchmark::DoNotOptimize(values.data());
+        }
+        state.SetItemsProcessed(state.iterations() * prices.size());
+}
+
+static void decimal_radix_argsort(benchmark::State &state) {
+        const std::vector<Decimal> prices = make_prices(state.range(0));
+        std::vector<uint32_t> indices(prices.size());
+        for (auto _ : state) {
+                argsort(prices, indices, static_cast<int32_t>(state.range(1)));
+                benchmark::DoNotOptimize(indices.data());
+        }
+        state.SetItemsProcessed(state.iterations() * prices.size());
+}
+
+BENCHMARK(decimal_std_sort)->Arg(1 << 20);
+BENCHMARK(decimal_radix_sort)->Args({1 << 20, 1})->Args({1 << 20, 4});
+BENCHMARK(decimal_radix_argsort)->Args({1 << 20, 1})->Args({1 << 20, 4});
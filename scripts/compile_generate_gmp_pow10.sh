@@ -1,15 +1,24 @@
 #!/bin/bash
 
+# Regenerate src/pow10_table.h.
+#
+# Usage: GMP_PREFIX=/path/to/gmp/install ./compile_generate_gmp_pow10.sh
+#
+# GMP_PREFIX is the install prefix of gmp (with include/gmp.h and lib/libgmp.*). It defaults to
+# the gmp that the CMake build compiles under extra/.
+
 # Directory of current script
 SCRIPT_DIR=$( cd -- "$( dirname -- "${BASH_SOURCE[0]}" )" &> /dev/null && pwd )
 cd ${SCRIPT_DIR}
 
-set -x
+GMP_PREFIX=${GMP_PREFIX:-${SCRIPT_DIR}/../extra/gmp/gmp-6.3.0/gmp_install}
+
+set -ex
 g++ -Wall -std=c++20 \
-        -I/home/walkerlala/projects/tmp/gmp-6.3.0/install/include/ \
-        -L/home/walkerlala/projects/tmp/gmp-6.3.0/install/lib/ \
+        -I${GMP_PREFIX}/include/ \
+        -L${GMP_PREFIX}/lib/ \
         ./generate_gmp_pow10.cc -o generate_gmp_pow10 -lgmp
 
-./generate_gmp_pow10
+LD_LIBRARY_PATH=${GMP_PREFIX}/lib:${LD_LIBRARY_PATH} ./generate_gmp_pow10 > ../src/pow10_table.h
 
 set +x
@@ -31,7 +31,11 @@ static std::string decimal_unsigned_integral_to_string(T v, int32_t scale, bool
         // Considering that scale might be equal to the number digits, e.g., 0.12345,
         // where scale is 5, we need to add 1 more digit for the leading 0.
         // So 42 -> 43, 23 -> 24
-        constexpr size_t result_buf_size = (sizeof(T) == 16) ? 43 : 24;
+        //
+        // Scale might also be larger than the number of digits, e.g., 0.000000000000000000000001
+        // stored in a int64_t, so there are at most kDecimalMaxScale digits after the '.'.
+        constexpr int32_t max_digits = (sizeof(T) == 16) ? 39 : 20;
+        constexpr size_t result_buf_size = constexpr_max(max_digits, kDecimalMaxScale) + 4;
         char result_buffer[result_buf_size] = {0};
         char *p = &(result_buffer[0]);
         char *pstart = p;
@@ -107,6 +111,10 @@ std::string decimal_128_to_string(__int128_t v, int32_t scale) {
         return decimal_unsigned_integral_to_string(uv, scale, is_negative);
 }
 
+std::string decimal_256_to_string(const Int256 &v, int32_t scale) {
+        return decimal_gmp_to_string(conv_256_to_gmp320(v), scale);
+}
+
 std::string my_mpz_to_string(const __mpz_struct *mpz, int32_t scale) {
         if (mpz->_mp_size == 0) {
                 return "0";
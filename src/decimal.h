@@ -19,11 +19,16 @@
 #pragma once
 
 #include "assertion.h"
+#include "decimal_context.h"
+#include "decimal_stats.h"
 #include "errcode.h"
 #include "gmp_wrapper.h"
+#include "int256.h"
+#include "pow10_table.h"
 #include "float_conv/dtoa_c.h"
 
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <cmath>
 #include <cstdint>
@@ -31,6 +36,7 @@
 #include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <span>
 #include <sstream>
 #include <string_view>
 #include <type_traits>
@@ -64,10 +70,32 @@ concept FloatingPointType = (sizeof(T) <= 8 &&
                              (std::is_same_v<T, float> || std::is_same_v<T, double> ||
                               std::is_same_v<T, long double>));
 
+// How a value is rounded when fractional digits are dropped, e.g., by Decimal::rescale(), or by
+// Decimal::mul<mode>() and Decimal::div<mode>() beyond the max scale. Arithmetic operators always
+// round half up.
+enum class RoundingMode : int32_t {
+        // Half away from zero: 2.5 => 3, -2.5 => -3
+        kHalfUp = 0,
+        // Half to even (banker's rounding): 2.5 => 2, 3.5 => 4
+        kHalfEven,
+        // Half towards zero: 2.5 => 2, -2.5 => -2, 2.51 => 3
+        kHalfDown,
+        // Towards zero, i.e., truncation: 2.9 => 2, -2.9 => -2
+        kDown,
+        // Away from zero: 2.1 => 3, -2.1 => -3
+        kUp,
+        // Towards negative infinity: 2.9 => 2, -2.1 => -3
+        kFloor,
+        // Towards positive infinity: 2.1 => 3, -2.9 => -2
+        kCeiling,
+};
+
 namespace detail {
 constexpr int32_t kDecimalMaxScale = 30;
 constexpr int32_t kDecimalMaxPrecision = 96;
 constexpr int32_t kDecimalDivIncrScale = 4;
+static_assert(kDecimalMaxScale == DecimalContext::kMaxScale);
+static_assert(kDecimalDivIncrScale == DecimalContext::kDefaultDivIncreaseScale);
 
 constexpr __int128_t kInt128Max = (static_cast<__int128_t>(INT64_MAX) << 64) | UINT64_MAX;
 constexpr __int128_t kInt128Min = static_cast<__int128_t>(INT64_MIN) << 64;
@@ -119,86 +147,18 @@ constexpr auto constexpr_max(T a, U b) -> std::conditional_t<(sizeof(T) >= sizeo
 }
 
 constexpr int64_t get_int64_power10(int32_t scale) {
-        /* clang-format off */
-        constexpr int64_t kPower10[] = {
-            /* 0  */ 1LL,
-            /* 1  */ 10LL,
-            /* 2  */ 100LL,
-            /* 3  */ 1000LL,
-            /* 4  */ 10000LL,
-            /* 5  */ 100000LL,
-            /* 6  */ 1000000LL,
-            /* 7  */ 10000000LL,
-            /* 8  */ 100000000LL,
-            /* 9  */ 1000000000LL,
-            /* 10 */ 10000000000LL,
-            /* 11 */ 100000000000LL,
-            /* 12 */ 1000000000000LL,
-            /* 13 */ 10000000000000LL,
-            /* 14 */ 100000000000000LL,
-            /* 15 */ 1000000000000000LL,
-            /* 16 */ 10000000000000000LL,
-            /* 17 */ 100000000000000000LL,
-            /* 18 */ 1000000000000000000LL,
-            /* 19 would be too large to fit into a int64_t */
-        };
-        /* clang-format on */
-        constexpr int64_t num_power10 = sizeof(kPower10) / sizeof(kPower10[0]);
-        if (scale < 0 || scale >= num_power10) {
+        // 10^19 would be too large to fit into a int64_t
+        if (scale < 0 || scale >= kMaxUint64Power10) {
                 return -1;
         }
-        return kPower10[scale];
+        return static_cast<int64_t>(kUint64Power10[scale]);
 }
 
 constexpr __int128_t get_int128_power10(int32_t scale) {
-        /* clang-format off */
-        constexpr __int128_t kPower10[] = {
-            /* 0  */ static_cast<__int128_t>(1LL),
-            /* 1  */ static_cast<__int128_t>(10LL),
-            /* 2  */ static_cast<__int128_t>(100LL),
-            /* 3  */ static_cast<__int128_t>(1000LL),
-            /* 4  */ static_cast<__int128_t>(10000LL),
-            /* 5  */ static_cast<__int128_t>(100000LL),
-            /* 6  */ static_cast<__int128_t>(1000000LL),
-            /* 7  */ static_cast<__int128_t>(10000000LL),
-            /* 8  */ static_cast<__int128_t>(100000000LL),
-            /* 9  */ static_cast<__int128_t>(1000000000LL),
-            /* 10 */ static_cast<__int128_t>(10000000000LL),
-            /* 11 */ static_cast<__int128_t>(100000000000LL),
-            /* 12 */ static_cast<__int128_t>(1000000000000LL),
-            /* 13 */ static_cast<__int128_t>(10000000000000LL),
-            /* 14 */ static_cast<__int128_t>(100000000000000LL),
-            /* 15 */ static_cast<__int128_t>(1000000000000000LL),
-            /* 16 */ static_cast<__int128_t>(10000000000000000LL),
-            /* 17 */ static_cast<__int128_t>(100000000000000000LL),
-            /* 18 */ static_cast<__int128_t>(1000000000000000000LL),
-            /* 19 */ static_cast<__int128_t>(1000000000000000000LL) * 10LL,
-            /* 20 */ static_cast<__int128_t>(1000000000000000000LL) * 100LL,
-            /* 21 */ static_cast<__int128_t>(1000000000000000000LL) * 1000LL,
-            /* 22 */ static_cast<__int128_t>(1000000000000000000LL) * 10000LL,
-            /* 23 */ static_cast<__int128_t>(1000000000000000000LL) * 100000LL,
-            /* 24 */ static_cast<__int128_t>(1000000000000000000LL) * 1000000LL,
-            /* 25 */ static_cast<__int128_t>(1000000000000000000LL) * 10000000LL,
-            /* 26 */ static_cast<__int128_t>(1000000000000000000LL) * 100000000LL,
-            /* 27 */ static_cast<__int128_t>(1000000000000000000LL) * 1000000000LL,
-            /* 28 */ static_cast<__int128_t>(1000000000000000000LL) * 10000000000LL,
-            /* 29 */ static_cast<__int128_t>(1000000000000000000LL) * 100000000000LL,
-            /* 30 */ static_cast<__int128_t>(1000000000000000000LL) * 1000000000000LL,
-            /* 31 */ static_cast<__int128_t>(1000000000000000000LL) * 10000000000000LL,
-            /* 32 */ static_cast<__int128_t>(1000000000000000000LL) * 100000000000000LL,
-            /* 33 */ static_cast<__int128_t>(1000000000000000000LL) * 1000000000000000LL,
-            /* 34 */ static_cast<__int128_t>(1000000000000000000LL) * 10000000000000000LL,
-            /* 35 */ static_cast<__int128_t>(1000000000000000000LL) * 100000000000000000LL,
-            /* 36 */ static_cast<__int128_t>(1000000000000000000LL) * 1000000000000000000LL,
-            /* 37 */ static_cast<__int128_t>(1000000000000000000LL) * 1000000000000000000LL * 10LL,
-            /* 38 */ static_cast<__int128_t>(1000000000000000000LL) * 1000000000000000000LL * 100LL,
-        };
-        /* clang-format on */
-        constexpr int64_t num_power10 = sizeof(kPower10) / sizeof(kPower10[0]);
-        if (scale < 0 || scale >= num_power10) {
+        if (scale < 0 || scale > kMaxInt128Power10) {
                 return -1;
         }
-        return kPower10[scale];
+        return kInt128Power10[scale];
 }
 
 template <IntegralType T>
@@ -212,57 +172,13 @@ constexpr T get_integral_power10(int32_t scale) {
         }
 }
 
-constexpr inline Gmp320 get_gmp320_power10(int32_t scale) {
-        /* clang-format off */
-        const Gmp320 kPower10[] = {
-            /* 0 */  Gmp320(1, 0x1, 0x0, 0x0, 0x0, 0x0),
-            /* 1 */  Gmp320(1, 0xa, 0x0, 0x0, 0x0, 0x0),
-            /* 2 */  Gmp320(1, 0x64, 0x0, 0x0, 0x0, 0x0),
-            /* 3 */  Gmp320(1, 0x3e8, 0x0, 0x0, 0x0, 0x0),
-            /* 4 */  Gmp320(1, 0x2710, 0x0, 0x0, 0x0, 0x0),
-            /* 5 */  Gmp320(1, 0x186a0, 0x0, 0x0, 0x0, 0x0),
-            /* 6 */  Gmp320(1, 0xf4240, 0x0, 0x0, 0x0, 0x0),
-            /* 7 */  Gmp320(1, 0x989680, 0x0, 0x0, 0x0, 0x0),
-            /* 8 */  Gmp320(1, 0x5f5e100, 0x0, 0x0, 0x0, 0x0),
-            /* 9 */  Gmp320(1, 0x3b9aca00, 0x0, 0x0, 0x0, 0x0),
-            /* 10 */ Gmp320(1, 0x2540be400, 0x0, 0x0, 0x0, 0x0),
-            /* 11 */ Gmp320(1, 0x174876e800, 0x0, 0x0, 0x0, 0x0),
-            /* 12 */ Gmp320(1, 0xe8d4a51000, 0x0, 0x0, 0x0, 0x0),
-            /* 13 */ Gmp320(1, 0x9184e72a000, 0x0, 0x0, 0x0, 0x0),
-            /* 14 */ Gmp320(1, 0x5af3107a4000, 0x0, 0x0, 0x0, 0x0),
-            /* 15 */ Gmp320(1, 0x38d7ea4c68000, 0x0, 0x0, 0x0, 0x0),
-            /* 16 */ Gmp320(1, 0x2386f26fc10000, 0x0, 0x0, 0x0, 0x0),
-            /* 17 */ Gmp320(1, 0x16345785d8a0000, 0x0, 0x0, 0x0, 0x0),
-            /* 18 */ Gmp320(1, 0xde0b6b3a7640000, 0x0, 0x0, 0x0, 0x0),
-            /* 19 */ Gmp320(1, 0x8ac7230489e80000, 0x0, 0x0, 0x0, 0x0),
-            /* 20 */ Gmp320(2, 0x6bc75e2d63100000, 0x5, 0x0, 0x0, 0x0),
-            /* 21 */ Gmp320(2, 0x35c9adc5dea00000, 0x36, 0x0, 0x0, 0x0),
-            /* 22 */ Gmp320(2, 0x19e0c9bab2400000, 0x21e, 0x0, 0x0, 0x0),
-            /* 23 */ Gmp320(2, 0x2c7e14af6800000, 0x152d, 0x0, 0x0, 0x0),
-            /* 24 */ Gmp320(2, 0x1bcecceda1000000, 0xd3c2, 0x0, 0x0, 0x0),
-            /* 25 */ Gmp320(2, 0x161401484a000000, 0x84595, 0x0, 0x0, 0x0),
-            /* 26 */ Gmp320(2, 0xdcc80cd2e4000000, 0x52b7d2, 0x0, 0x0, 0x0),
-            /* 27 */ Gmp320(2, 0x9fd0803ce8000000, 0x33b2e3c, 0x0, 0x0, 0x0),
-            /* 28 */ Gmp320(2, 0x3e25026110000000, 0x204fce5e, 0x0, 0x0, 0x0),
-            /* 29 */ Gmp320(2, 0x6d7217caa0000000, 0x1431e0fae, 0x0, 0x0, 0x0),
-            /* 30 */ Gmp320(2, 0x4674edea40000000, 0xc9f2c9cd0, 0x0, 0x0, 0x0),
-            /* 31 */ Gmp320(2, 0xc0914b2680000000, 0x7e37be2022, 0x0, 0x0, 0x0),
-            /* 32 */ Gmp320(2, 0x85acef8100000000, 0x4ee2d6d415b, 0x0, 0x0, 0x0),
-            /* 33 */ Gmp320(2, 0x38c15b0a00000000, 0x314dc6448d93, 0x0, 0x0, 0x0),
-            /* 34 */ Gmp320(2, 0x378d8e6400000000, 0x1ed09bead87c0, 0x0, 0x0, 0x0),
-            /* 35 */ Gmp320(2, 0x2b878fe800000000, 0x13426172c74d82, 0x0, 0x0, 0x0),
-            /* 36 */ Gmp320(2, 0xb34b9f1000000000, 0xc097ce7bc90715, 0x0, 0x0, 0x0),
-            /* 37 */ Gmp320(2, 0xf436a000000000, 0x785ee10d5da46d9, 0x0, 0x0, 0x0),
-            /* 38 */ Gmp320(2, 0x98a224000000000, 0x4b3b4ca85a86c47a, 0x0, 0x0, 0x0),
-            /* 39 */ Gmp320(3, 0x5f65568000000000, 0xf050fe938943acc4, 0x2, 0x0, 0x0),
-            /* 40 */ Gmp320(3, 0xb9f5610000000000, 0x6329f1c35ca4bfab, 0x1d, 0x0, 0x0),
-        };
-        /* clang-format on */
-        constexpr int64_t num_power10 = sizeof(kPower10) / sizeof(kPower10[0]);
-        if (scale < 0 || scale >= num_power10) {
+// Return a reference into the static table, so that there is no copy of the table (nor the
+// value) on the stack. Copy it if it is to be modified.
+constexpr inline const Gmp320 &get_gmp320_power10(int32_t scale) {
+        if (scale < 0 || scale > kMaxGmp320Power10) {
                 return kGmpValueMinus1;
         }
-        return kPower10[scale];
+        return kGmp320Power10[scale];
 }
 
 constexpr inline Gmp320 conv_64_to_gmp320(int64_t i64) {
@@ -368,6 +284,437 @@ constexpr inline Gmp640 conv_128_to_gmp640(__int128_t i128) {
         return res640;
 }
 
+constexpr inline Gmp320 conv_256_to_gmp320(const Int256 &i256) {
+        Gmp320 gmp;
+        uint64_t limbs[Int256::kNumLimbs] = {0};
+        int32_t n = i256.get_magnitude(limbs);
+        for (int32_t i = 0; i < n; ++i) {
+                gmp.mpz._mp_d[i] = limbs[i];
+        }
+        gmp.mpz._mp_size = i256.is_negative() ? -n : n;
+        return gmp;
+}
+
+constexpr inline Gmp640 conv_256_to_gmp640(const Int256 &i256) {
+        Gmp320 res320 = conv_256_to_gmp320(i256);
+
+        Gmp640 res640;
+        copy_gmp_to_gmp(res640, res320);
+        return res640;
+}
+
+//=-----------------------------------------------------------------------------
+// Division by invariant integers.
+//
+// Dividing many values by the same 64-bit divisor (a fixed user divisor, or a power of 10 when
+// rounding) is much cheaper if a reciprocal of the divisor is computed beforehand, so that every
+// 2-by-1 limb division costs one multiplication plus a couple of adjustments instead of a
+// hardware division. See Möller & Granlund, "Improved division by invariant integers", 2011,
+// which is also what gmp uses internally (udiv_qrnnd_preinv).
+//
+// Limb arrays used by these functions are unsigned magnitudes, least significant limb first.
+//=-----------------------------------------------------------------------------
+struct Reciprocal64 {
+        // divisor shifted left so that its most significant bit is set
+        uint64_t d_norm = 0;
+        // floor((2^128 - 1) / d_norm) - 2^64
+        uint64_t v = 0;
+        // number of leading zero bits of the original divisor
+        int32_t shift = 0;
+
+        constexpr uint64_t divisor() const { return d_norm >> shift; }
+};
+
+constexpr inline Reciprocal64 make_reciprocal64(uint64_t d) {
+        __BIGNUM_ASSERT(d != 0, "Reciprocal of zero");
+        Reciprocal64 rcp;
+        rcp.shift = __builtin_clzll(d);
+        rcp.d_norm = d << rcp.shift;
+        __uint128_t numerator = (static_cast<__uint128_t>(~rcp.d_norm) << 64) | UINT64_MAX;
+        rcp.v = static_cast<uint64_t>(numerator / rcp.d_norm);
+        return rcp;
+}
+
+// Divide (u1, u0) by rcp.d_norm, where u1 < rcp.d_norm.
+// Return the quotient and store the remainder into `r`.
+constexpr inline uint64_t div_2by1_preinv(uint64_t &r, uint64_t u1, uint64_t u0,
+                                          const Reciprocal64 &rcp) {
+        __uint128_t q = static_cast<__uint128_t>(rcp.v) * u1;
+        q += (static_cast<__uint128_t>(u1) << 64) | u0;
+        uint64_t q1 = static_cast<uint64_t>(q >> 64) + 1;
+        uint64_t q0 = static_cast<uint64_t>(q);
+        uint64_t rem = u0 - q1 * rcp.d_norm;
+        if (rem > q0) {
+                q1--;
+                rem += rcp.d_norm;
+        }
+        if (rem >= rcp.d_norm) [[unlikely]] {
+                q1++;
+                rem -= rcp.d_norm;
+        }
+        r = rem;
+        return q1;
+}
+
+// q[0, n) = u[0, n) / divisor, return the remainder. `q` might be the same as `u`.
+constexpr inline uint64_t divrem_limbs_preinv(uint64_t *q, const uint64_t *u, int32_t n,
+                                              const Reciprocal64 &rcp) {
+        if (n <= 0) {
+                return 0;
+        }
+
+        const int32_t shift = rcp.shift;
+        uint64_t r = 0;
+        if (shift == 0) {
+                for (int32_t i = n - 1; i >= 0; --i) {
+                        q[i] = div_2by1_preinv(r, r, u[i], rcp);
+                }
+                return r;
+        }
+
+        // Shift the dividend on the fly by the same amount as the normalized divisor.
+        r = u[n - 1] >> (64 - shift);
+        for (int32_t i = n - 1; i >= 0; --i) {
+                uint64_t u0 = u[i] << shift;
+                if (i > 0) {
+                        u0 |= u[i - 1] >> (64 - shift);
+                }
+                q[i] = div_2by1_preinv(r, r, u0, rcp);
+        }
+        return r >> shift;
+}
+
+// u[0, n) *= m, return the carry limb.
+constexpr inline uint64_t mul_limbs_1(uint64_t *u, int32_t n, uint64_t m) {
+        uint64_t carry = 0;
+        for (int32_t i = 0; i < n; ++i) {
+                __uint128_t prod = static_cast<__uint128_t>(u[i]) * m + carry;
+                u[i] = static_cast<uint64_t>(prod);
+                carry = static_cast<uint64_t>(prod >> 64);
+        }
+        return carry;
+}
+
+// u[0, n) += a, return the carry.
+constexpr inline uint64_t add_limbs_1(uint64_t *u, int32_t n, uint64_t a) {
+        for (int32_t i = 0; i < n && a; ++i) {
+                u[i] += a;
+                a = (u[i] < a) ? 1 : 0;
+        }
+        return a;
+}
+
+// Reciprocals of 10^0 .. 10^19, i.e., all powers of 10 that fit into a 64-bit limb.
+// Evaluated at compile time from kUint64Power10.
+inline constexpr std::array<Reciprocal64, kMaxUint64Power10 + 1> kPower10Reciprocals = [] {
+        std::array<Reciprocal64, kMaxUint64Power10 + 1> rcps;
+        for (int32_t i = 0; i <= kMaxUint64Power10; ++i) {
+                rcps[i] = make_reciprocal64(kUint64Power10[i]);
+        }
+        return rcps;
+}();
+
+// Division of a single 64-bit integer by an invariant divisor d with one multiplication and a few
+// shifts, which is much cheaper than even div_2by1_preinv() as there is no remainder to fix up.
+// See Granlund & Montgomery, "Division by invariant integers using multiplication", 1994,
+// Figure 4.1, which works for every dividend.
+struct Magic64 {
+        // floor(2^64 * (2^l - d) / d) + 1, where l = ceil(log2(d))
+        uint64_t m = 0;
+        int32_t shift1 = 0;
+        int32_t shift2 = 0;
+};
+
+constexpr inline Magic64 make_magic64(uint64_t d) {
+        __BIGNUM_ASSERT(d != 0, "Division by zero");
+        const int32_t l = d == 1 ? 0 : 64 - __builtin_clzll(d - 1);
+        const __uint128_t num = ((static_cast<__uint128_t>(1) << l) - d) << 64;
+        Magic64 magic;
+        magic.m = static_cast<uint64_t>(num / d) + 1;
+        magic.shift1 = l > 0 ? 1 : 0;
+        magic.shift2 = l > 0 ? l - 1 : 0;
+        return magic;
+}
+
+// floor(n / d) for the divisor d of the magic.
+constexpr inline uint64_t div_magic64(uint64_t n, const Magic64 &magic) {
+        const uint64_t t = static_cast<uint64_t>((static_cast<__uint128_t>(magic.m) * n) >> 64);
+        return (t + ((n - t) >> magic.shift1)) >> magic.shift2;
+}
+
+// Magics of 10^0 .. 10^19.
+inline constexpr std::array<Magic64, kMaxUint64Power10 + 1> kPower10Magics = [] {
+        std::array<Magic64, kMaxUint64Power10 + 1> magics;
+        for (int32_t i = 0; i <= kMaxUint64Power10; ++i) {
+                magics[i] = make_magic64(kUint64Power10[i]);
+        }
+        return magics;
+}();
+
+// Multiplicative inverses of 5^i modulo 2^64, for exact division by 10^i: if u is a multiple of
+// 10^i, then u / 10^i == (u >> i) * kPower5Inverses[i] (mod 2^64), without any division.
+inline constexpr std::array<uint64_t, kMaxUint64Power10 + 1> kPower5Inverses = [] {
+        std::array<uint64_t, kMaxUint64Power10 + 1> invs;
+        uint64_t pow5 = 1;
+        for (int32_t i = 0; i <= kMaxUint64Power10; ++i) {
+                // Newton's iteration, each step doubles the number of correct low bits (3 for
+                // the initial value as a * a == 1 mod 8 for an odd a).
+                uint64_t x = pow5;
+                for (int32_t k = 0; k < 5; ++k) {
+                        x *= 2 - pow5 * x;
+                }
+                invs[i] = x;
+                pow5 *= 5;
+        }
+        return invs;
+}();
+
+// Number of limbs without the most significant zero limbs.
+constexpr inline int32_t normalized_limbs_size(const uint64_t *u, int32_t n) {
+        while (n > 0 && u[n - 1] == 0) {
+                n--;
+        }
+        return n;
+}
+
+// Compare two normalized limb arrays.
+constexpr inline int cmp_limbs(const uint64_t *a, int32_t an, const uint64_t *b, int32_t bn) {
+        if (an != bn) {
+                return an < bn ? -1 : 1;
+        }
+        for (int32_t i = an - 1; i >= 0; --i) {
+                if (a[i] != b[i]) {
+                        return a[i] < b[i] ? -1 : 1;
+                }
+        }
+        return 0;
+}
+
+// Whether a magnitude exceeds the maximum value of precision kDecimalMaxPrecision.
+constexpr inline bool limbs_out_of_range(const uint64_t *u, int32_t n) {
+        return cmp_limbs(u, n, kMax96DigitsGmpValue.limbs, kMax96DigitsGmpValue.mpz._mp_size) > 0;
+}
+
+// Call f(std::integral_constant<RoundingMode, mode>()), so that a rounding mode given at runtime
+// is resolved once into a template argument rather than in every rounding.
+template <typename F>
+constexpr inline auto dispatch_rounding(RoundingMode mode, F &&f) {
+        switch (mode) {
+                case RoundingMode::kHalfEven:
+                        return f(std::integral_constant<RoundingMode, RoundingMode::kHalfEven>());
+                case RoundingMode::kHalfDown:
+                        return f(std::integral_constant<RoundingMode, RoundingMode::kHalfDown>());
+                case RoundingMode::kDown:
+                        return f(std::integral_constant<RoundingMode, RoundingMode::kDown>());
+                case RoundingMode::kUp:
+                        return f(std::integral_constant<RoundingMode, RoundingMode::kUp>());
+                case RoundingMode::kFloor:
+                        return f(std::integral_constant<RoundingMode, RoundingMode::kFloor>());
+                case RoundingMode::kCeiling:
+                        return f(std::integral_constant<RoundingMode, RoundingMode::kCeiling>());
+                default:
+                        return f(std::integral_constant<RoundingMode, RoundingMode::kHalfUp>());
+        }
+}
+
+// Whether a truncated quotient is to be rounded away from zero, given the remainder r of the last
+// division (by 10^e, where half is 5 * 10^(e-1)), whether any digit below it is nonzero (sticky),
+// and whether the quotient is odd.
+//
+// Bitwise rather than logical operators, as r is close to random, and a mispredicted branch
+// costs more than the division.
+template <RoundingMode kMode>
+constexpr inline bool round_away(bool negative, uint64_t r, uint64_t half, bool sticky, bool odd) {
+        const bool inexact = (r != 0) | sticky;
+        if constexpr (kMode == RoundingMode::kHalfUp) {
+                return r >= half;
+        } else if constexpr (kMode == RoundingMode::kHalfEven) {
+                return (r > half) | ((r == half) & (sticky | odd));
+        } else if constexpr (kMode == RoundingMode::kHalfDown) {
+                return (r > half) | ((r == half) & sticky);
+        } else if constexpr (kMode == RoundingMode::kDown) {
+                return false;
+        } else if constexpr (kMode == RoundingMode::kUp) {
+                return inexact;
+        } else if constexpr (kMode == RoundingMode::kFloor) {
+                return inexact & negative;
+        } else {
+                static_assert(kMode == RoundingMode::kCeiling);
+                return inexact & !negative;
+        }
+}
+
+// Scale down the magnitude u[0, n) of a value with the given sign by 10^exp, rounding with kMode,
+// e.g., for round half up:
+//    u = u / 10^exp + ((u % 10^exp) >= 5 * 10^(exp - 1) ? 1 : 0)
+// `sticky` tells whether u itself was truncated, i.e., the exact value is slightly larger than u.
+// Return the new number of limbs.
+//
+// This replaces the "divide by 10^(exp-1), take the last digit, divide by 10 again" sequence
+// with one pass of multiplications by precomputed reciprocals (one pass per 10^19 chunk). Only the
+// remainder of the last chunk is compared with the half-way point: the digits below it could never
+// carry the total remainder over it, and only tell ties (and exact values) apart. Caller
+// guarantees one extra limb for the carry.
+template <RoundingMode kMode>
+constexpr inline int32_t scale_down_limbs(uint64_t *u, int32_t n, int32_t exp, bool negative,
+                                          bool sticky = false) {
+        __BIGNUM_ASSERT(exp >= 0);
+        uint64_t r = 0;
+        int32_t e = 0;
+        while (exp > 0 && n > 0) {
+                sticky |= r != 0;
+                e = exp > kMaxUint64Power10 ? kMaxUint64Power10 : exp;
+                r = divrem_limbs_preinv(u, u, n, kPower10Reciprocals[e]);
+                n = normalized_limbs_size(u, n);
+                exp -= e;
+        }
+        if (exp > 0) {
+                // The quotient became zero before all digits were dropped, so the remainder is
+                // below the half-way point (of 10^exp more).
+                sticky |= r != 0;
+                r = 0;
+        }
+        // If nothing was divided (e == 0), only a sticky u rounds, and never to the nearest.
+        const uint64_t half = e == 0 ? 1 : kUint64HalfPower10[e];
+        if (round_away<kMode>(negative, r, half, sticky, n > 0 && (u[0] & 1))) {
+                u[n] = add_limbs_1(u, n, 1);
+                n = normalized_limbs_size(u, n + 1);
+        }
+        return n;
+}
+
+// Integral version of scale_down_limbs(), where the result never overflows as long as exp > 0.
+template <RoundingMode kMode, IntegralType T>
+constexpr inline T scale_down_round(T value, int32_t exp) {
+        static_assert(sizeof(T) == 8 || sizeof(T) == 16);
+        using U = std::conditional_t<sizeof(T) == 8, uint64_t, __uint128_t>;
+        if (exp <= 0) {
+                return value;
+        }
+
+        const bool negative = value < 0;
+        U mag = negative ? ~static_cast<U>(value) + 1 : static_cast<U>(value);
+        uint64_t limbs[3] = {static_cast<uint64_t>(mag), 0, 0};
+        int32_t n = 1;
+        if constexpr (sizeof(T) == 16) {
+                limbs[1] = static_cast<uint64_t>(mag >> 64);
+                n = 2;
+        }
+        n = scale_down_limbs<kMode>(limbs, normalized_limbs_size(limbs, n), exp, negative);
+        __BIGNUM_ASSERT(n <= static_cast<int32_t>(sizeof(T) / 8));
+
+        if constexpr (sizeof(T) == 8) {
+                mag = limbs[0];
+        } else {
+                mag = (static_cast<__uint128_t>(limbs[1]) << 64) | limbs[0];
+        }
+        return static_cast<T>(negative ? ~mag + 1 : mag);
+}
+
+// Int256 version of scale_down_round().
+template <RoundingMode kMode>
+constexpr inline Int256 scale_down_round(const Int256 &value, int32_t exp) {
+        if (exp <= 0) {
+                return value;
+        }
+        uint64_t limbs[Int256::kNumLimbs + 1] = {0};
+        int32_t n = value.get_magnitude(limbs);
+        n = scale_down_limbs<kMode>(limbs, n, exp, value.is_negative());
+        return Int256::from_magnitude(limbs, n, value.is_negative());
+}
+
+// u[0, n) /= 10^exp, truncated. Return the new number of limbs.
+constexpr inline int32_t div_limbs_power10(uint64_t *u, int32_t n, int32_t exp) {
+        while (exp > 0 && n > 0) {
+                int32_t e = exp > kMaxUint64Power10 ? kMaxUint64Power10 : exp;
+                (void)divrem_limbs_preinv(u, u, n, kPower10Reciprocals[e]);
+                n = normalized_limbs_size(u, n);
+                exp -= e;
+        }
+        return n;
+}
+
+// value / 10^exp, truncated towards zero.
+constexpr inline Int256 div_power10(const Int256 &value, int32_t exp) {
+        uint64_t limbs[Int256::kNumLimbs] = {0};
+        int32_t n = value.get_magnitude(limbs);
+        n = div_limbs_power10(limbs, n, exp);
+        return Int256::from_magnitude(limbs, n, value.is_negative());
+}
+
+// u[0, n) *= 10^exp, return the new number of limbs.
+// Caller guarantees that there is enough room for the result.
+constexpr inline int32_t mul_limbs_power10(uint64_t *u, int32_t n, int32_t exp) {
+        while (exp > 0 && n > 0) {
+                int32_t e = exp > kMaxUint64Power10 ? kMaxUint64Power10 : exp;
+                uint64_t carry = mul_limbs_1(u, n, kUint64Power10[e]);
+                if (carry) {
+                        u[n++] = carry;
+                }
+                exp -= e;
+        }
+        return n;
+}
+
+// Number of decimal digits of a normalized magnitude u[0, n), which must not exceed the maximum
+// value of precision kDecimalMaxPrecision. Zero has 1 digit.
+constexpr inline int32_t count_digits_limbs(const uint64_t *u, int32_t n) {
+        if (n == 0) {
+                return 1;
+        }
+        // With b bits, the value has either floor(b * log10(2)) or one more digits.
+        // 1233 / 4096 is a close enough approximation of log10(2) for b <= 320.
+        const int32_t bits = n * 64 - __builtin_clzll(u[n - 1]);
+        const int32_t t = (bits * 1233) >> 12;
+        if (n == 1) {
+                return t + (u[0] >= kUint64Power10[t]);
+        }
+        const Gmp320 &p = kGmp320Power10[t];
+        return t + (cmp_limbs(u, n, p.limbs, p.mpz._mp_size) >= 0);
+}
+
+// Number of trailing decimal zeros of a normalized magnitude u[0, n). Zero has none.
+constexpr inline int32_t count_trailing_zeros_limbs(const uint64_t *u, int32_t n) {
+        int32_t zeros = 0;
+        if (n == 1) {
+                for (uint64_t v = u[0]; v % 10 == 0; v /= 10) {
+                        zeros++;
+                }
+                return zeros;
+        }
+
+        uint64_t q[Gmp320::kNumLimbs] = {0};
+        while (n > 0) {
+                if (divrem_limbs_preinv(q, u, n, kPower10Reciprocals[1]) != 0) {
+                        break;
+                }
+                n = normalized_limbs_size(q, n);
+                u = q;
+                zeros++;
+        }
+        return zeros;
+}
+
+// Finalizer of splitmix64: a bijection in which every input bit affects every output bit.
+constexpr inline uint64_t hash_mix64(uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebull;
+        x ^= x >> 31;
+        return x;
+}
+
+// Hash of a normalized magnitude u[0, n) without trailing zeros, its sign and scale.
+constexpr inline uint64_t hash_limbs(const uint64_t *u, int32_t n, bool negative, int32_t scale) {
+        uint64_t h = (static_cast<uint64_t>(static_cast<uint32_t>(scale)) << 1 | negative) *
+                     0x9e3779b97f4a7c15ull;
+        for (int32_t i = 0; i < n; ++i) {
+                h = hash_mix64(h ^ u[i]);
+        }
+        return h;
+}
+
 template <IntegralType T>
 constexpr int cmp_integral(T a, T b) {
         if (a < b) {
@@ -445,6 +792,16 @@ constexpr inline ErrCode safe_add(T &res, T lhs, T rhs) noexcept {
         return kSuccess;
 }
 
+template <IntegralType T>
+constexpr inline ErrCode safe_sub(T &res, T lhs, T rhs) noexcept {
+        T v = 0;
+        if (__builtin_sub_overflow(lhs, rhs, &v)) {
+                return kError;
+        }
+        res = v;
+        return kSuccess;
+}
+
 template <IntegralType T>
 constexpr inline ErrCode safe_mul(T &res, T lhs, T rhs) noexcept {
         // Overflow detection for * operation. Mul overflow detection could be very easily done by
@@ -488,7 +845,8 @@ constexpr inline ErrCode safe_mul(T &res, T lhs, T rhs) noexcept {
         return kSuccess;
 }
 
-template <IntegralType T>
+// lhs + rhs, or lhs - rhs if kSub
+template <bool kSub, IntegralType T>
 constexpr inline ErrCode decimal_add_integral(T &res, int32_t &res_scale, T lhs, int32_t lscale,
                                               T rhs, int32_t rscale) noexcept {
         if (lscale > rscale) {
@@ -499,9 +857,6 @@ constexpr inline ErrCode decimal_add_integral(T &res, int32_t &res_scale, T lhs,
                 if (safe_mul(rhs, rhs, p10)) {
                         return kDecimalAddSubOverflow;
                 }
-                if (safe_add(res, lhs, rhs)) {
-                        return kDecimalAddSubOverflow;
-                }
                 res_scale = lscale;
         } else {
                 T p10 = get_integral_power10<T>(rscale - lscale);
@@ -511,17 +866,17 @@ constexpr inline ErrCode decimal_add_integral(T &res, int32_t &res_scale, T lhs,
                 if (safe_mul(lhs, lhs, p10)) {
                         return kDecimalAddSubOverflow;
                 }
-                if (safe_add(res, lhs, rhs)) {
-                        return kDecimalAddSubOverflow;
-                }
                 res_scale = rscale;
         }
+        if (kSub ? safe_sub(res, lhs, rhs) : safe_add(res, lhs, rhs)) {
+                return kDecimalAddSubOverflow;
+        }
         return kSuccess;
 }
 
-template <IntegralType T>
+template <RoundingMode kMode, IntegralType T>
 constexpr inline ErrCode decimal_mul_integral(T &res, int32_t &res_scale, T lhs, int32_t lscale,
-                                              T rhs, int32_t rscale) noexcept {
+                                              T rhs, int32_t rscale, int32_t max_scale) noexcept {
         ErrCode err = safe_mul(res, lhs, rhs);
         // For int128 or int256 onwards, if overflow, try to trim trailing zeros and multiply again,
         // e.g., 1.000 * 1.000 = 1.000000  =>  1 * 1 = 1
@@ -558,31 +913,59 @@ constexpr inline ErrCode decimal_mul_integral(T &res, int32_t &res_scale, T lhs,
                 return kDecimalMulOverflow;
         }
 
-        if (lscale + rscale <= kDecimalMaxScale) {
+        if (lscale + rscale <= max_scale) {
                 res_scale = lscale + rscale;
                 return kSuccess;
         }
 
-        int32_t delta_scale = lscale + rscale - kDecimalMaxScale;
+        int32_t delta_scale = lscale + rscale - max_scale;
         assert(delta_scale > 0);
 
-        if (delta_scale - 1 > 0) {
-                T div_first_part = detail::get_integral_power10<T>(delta_scale - 1);
-                res /= div_first_part;
-        }
+        res = scale_down_round<kMode>(res, delta_scale);
+        res_scale = max_scale;
+        return kSuccess;
+}
 
-        T mod_result = detail::constexpr_abs(res) % 10;
-        res /= 10;
+// 10^scale for the scale alignment of Int256 values, scale <= kMaxInt128Power10.
+constexpr inline Int256 get_int256_power10(int32_t scale) {
+        __BIGNUM_ASSERT(scale >= 0 && scale <= kMaxInt128Power10);
+        return Int256(kInt128Power10[scale]);
+}
 
-        // round-half-up: round away from zero
-        if (mod_result >= 5) {
-                if (res > 0) {
-                        res += 1;
-                } else {
-                        res -= 1;
+template <bool kSub>
+constexpr inline ErrCode decimal_add_int256(Int256 &res, int32_t &res_scale, Int256 lhs,
+                                            int32_t lscale, Int256 rhs, int32_t rscale) noexcept {
+        if (lscale > rscale) {
+                if (safe_mul(rhs, rhs, get_int256_power10(lscale - rscale))) {
+                        return kDecimalAddSubOverflow;
+                }
+        } else if (lscale < rscale) {
+                if (safe_mul(lhs, lhs, get_int256_power10(rscale - lscale))) {
+                        return kDecimalAddSubOverflow;
                 }
         }
-        res_scale = kDecimalMaxScale;
+        if (kSub ? safe_sub(res, lhs, rhs) : safe_add(res, lhs, rhs)) {
+                return kDecimalAddSubOverflow;
+        }
+        res_scale = constexpr_max(lscale, rscale);
+        return kSuccess;
+}
+
+template <RoundingMode kMode>
+constexpr inline ErrCode decimal_mul_int256(Int256 &res, int32_t &res_scale, const Int256 &lhs,
+                                            int32_t lscale, const Int256 &rhs, int32_t rscale,
+                                            int32_t max_scale) noexcept {
+        if (safe_mul(res, lhs, rhs)) {
+                return kDecimalMulOverflow;
+        }
+
+        if (lscale + rscale <= max_scale) {
+                res_scale = lscale + rscale;
+                return kSuccess;
+        }
+
+        res = scale_down_round<kMode>(res, lscale + rscale - max_scale);
+        res_scale = max_scale;
         return kSuccess;
 }
 
@@ -633,8 +1016,12 @@ constexpr inline ErrCode convert_str_to_int128(__int128_t &res, const char *ptr,
 // overflow, and might trigger exception or assertion. The same for __int128_t.
 template <IntegralType T>
 auto get_decimal_integral(T val, int32_t scale) -> T {
+        __BIGNUM_ASSERT(scale >= 0 && scale <= kDecimalMaxScale, "Invalid scale");
         T p10 = get_integral_power10<T>(scale);
-        __BIGNUM_ASSERT(p10 > 0, "Invalid scale");
+        if (p10 < 0) {
+                // 10^scale does not fit into T, so |val| < 10^scale, e.g., int64_t with scale 19.
+                return 0;
+        }
         return val / p10;
 }
 
@@ -754,6 +1141,7 @@ ErrCode get_integral_from_decimal_gmp(T &result, const Gmp320 &gmp, int32_t scal
 
 std::string decimal_64_to_string(int64_t v, int32_t scale);
 std::string decimal_128_to_string(__int128_t v, int32_t scale);
+std::string decimal_256_to_string(const Int256 &v, int32_t scale);
 std::string my_mpz_to_string(const __mpz_struct *mpz, int32_t scale);
 std::string decimal_gmp_to_string(const Gmp320 &v, int32_t scale);
 std::string decimal_gmp_to_string(const Gmp640 &v, int32_t scale);
@@ -813,8 +1201,22 @@ std::string decimal_gmp_to_string(const Gmp640 &v, int32_t scale);
 //    and others for error. If user cares about specified error code, the `ErrCode` type
 //    could be used directly.
 //=-----------------------------------------------------------------------------
+class DecimalDivisor;
+class AtomicDecimal;
+namespace detail {
+struct DecimalMath;
+}  // namespace detail
+
 template <typename T = void>
 class DecimalImpl final {
+        friend class DecimalDivisor;
+        friend class AtomicDecimal;
+        friend struct detail::DecimalMath;
+        template <typename V>
+        friend class DecimalFlatMap;
+        template <typename U>
+        friend class DecimalColumnImpl;
+
        public:
         constexpr static int32_t kMaxScale = detail::kDecimalMaxScale;
         constexpr static int32_t kMaxPrecision = detail::kDecimalMaxPrecision;
@@ -828,7 +1230,13 @@ class DecimalImpl final {
         constexpr static int32_t kDivIncreaseScale = detail::kDecimalDivIncrScale;
 
        public:
-        constexpr DecimalImpl() : m_i64(0), m_padding0{0}, m_dtype(DType::kInt64), m_scale(0) {}
+        constexpr DecimalImpl()
+                : m_i64(0),
+                  m_padding0{0},
+                  m_dtype(DType::kInt64),
+                  m_precision(1),
+                  m_trailing_zeros(0),
+                  m_scale(0) {}
 
         // Construction using integral value, without scale (scale=0).
         //
@@ -837,7 +1245,13 @@ class DecimalImpl final {
         // which has a fixed scale data type; instead, it is similar with that of a runtime decimal
         // type in database, where the scale of this class is dynamic and stored within each object.
         template <SmallIntegralType U>
-        constexpr DecimalImpl(U i) : m_i64(i), m_padding0{0}, m_dtype(DType::kInt64), m_scale(0) {
+        constexpr DecimalImpl(U i)
+                : m_i64(i),
+                  m_padding0{0},
+                  m_dtype(DType::kInt64),
+                  m_precision(kMetaUnknown),
+                  m_trailing_zeros(kMetaUnknown),
+                  m_scale(0) {
 #ifdef BIGNUM_DEV_USE_GMP_ONLY
                 convert_internal_representation_to_gmp();
 #endif
@@ -847,13 +1261,13 @@ class DecimalImpl final {
         constexpr DecimalImpl(U i) : m_padding0{0}, m_scale(0) {
                 if constexpr (sizeof(U) < sizeof(int64_t)) {
                         m_i64 = i;
-                        m_dtype = DType::kInt64;
+                        set_dtype(DType::kInt64);
                 } else if (i <= static_cast<uint64_t>(INT64_MAX)) {
                         m_i64 = i;
-                        m_dtype = DType::kInt64;
+                        set_dtype(DType::kInt64);
                 } else {
                         m_i128 = i;
-                        m_dtype = DType::kInt128;
+                        set_dtype(DType::kInt128);
                 }
 
 #ifdef BIGNUM_DEV_USE_GMP_ONLY
@@ -862,7 +1276,13 @@ class DecimalImpl final {
         }
 
         template <LargeIntegralType U>
-        constexpr DecimalImpl(U i) : m_i128(i), m_padding0{0}, m_dtype(DType::kInt128), m_scale(0) {
+        constexpr DecimalImpl(U i)
+                : m_i128(i),
+                  m_padding0{0},
+                  m_dtype(DType::kInt128),
+                  m_precision(kMetaUnknown),
+                  m_trailing_zeros(kMetaUnknown),
+                  m_scale(0) {
 #ifdef BIGNUM_DEV_USE_GMP_ONLY
                 convert_internal_representation_to_gmp();
 #endif
@@ -872,10 +1292,10 @@ class DecimalImpl final {
         constexpr DecimalImpl(U i) : m_padding0{0}, m_scale(0) {
                 if (i <= static_cast<__uint128_t>(detail::kInt128Max)) {
                         m_i128 = i;
-                        m_dtype = DType::kInt128;
+                        set_dtype(DType::kInt128);
                 } else {
-                        detail::Gmp320 nv = detail::conv_uint128_to_gmp320(i);
-                        store_gmp_value(nv);
+                        m_i256 = detail::Int256(0, i);
+                        set_dtype(DType::kInt256);
                 }
 #ifdef BIGNUM_DEV_USE_GMP_ONLY
                 convert_internal_representation_to_gmp();
@@ -1021,12 +1441,59 @@ class DecimalImpl final {
                 return i;
         }
 
+        // The value multiplied by 10^scale, i.e., the internal integer at the given scale, e.g.,
+        // 1500 for "1.5" at scale 3. If the scale is less than get_scale(), only trailing zeros
+        // could be dropped (kDecimalScaleOverflow otherwise) so that no digit is lost.
+        // kDecimalValueOutOfRange if the result does not fit into int128.
+        constexpr ErrCode to_scaled_int128(int32_t scale, __int128_t &i) const noexcept;
+
+        // Reduce the scale to `scale` by dropping trailing zeros of the internal integer, e.g.,
+        // the product of "0.75" and "2" (150 with scale 2) to 15 with scale 1, which does not
+        // change the value. kDecimalScaleOverflow (and *this is untouched) if a nonzero digit
+        // would be dropped. Nothing happens if the scale is already `scale` or less.
+        constexpr ErrCode trim_scale(int32_t scale) noexcept;
+
+        // Change the scale to `scale` in [0, kMaxScale], rounding with `mode` if fractional
+        // digits are dropped, e.g., "2.345" to 2.35 (kHalfUp) or 2.34 (kHalfEven, kDown) at
+        // scale 2, and "2.5" to 2.500 at scale 3. kInvalidArgument for an invalid scale, and
+        // kDecimalValueOutOfRange if the result would exceed kMaxPrecision digits, in which
+        // cases *this is untouched. Never calls into gmp unless the value is already a gmp one.
+        //
+        // SQL `CAST(x AS DECIMAL(p, s))` is rescale(s) followed by checking precision() <= p.
+        //
+        // rescale<kMode>(scale) takes the mode as a template argument, and rescale(scale, mode)
+        // picks the instance of it for a mode known only at runtime.
+        template <RoundingMode kMode = RoundingMode::kHalfUp>
+        constexpr ErrCode rescale(int32_t scale) noexcept;
+        constexpr ErrCode rescale(int32_t scale, RoundingMode mode) noexcept {
+                return detail::dispatch_rounding(mode, [&](auto m) {
+                        return rescale<decltype(m)::value>(scale);
+                });
+        }
+
         //=----------------------------------------------------------
         // getters && setters
         //=----------------------------------------------------------
         constexpr int32_t get_scale() const { return m_scale; }
         constexpr bool is_negative() const;
 
+        // Number of digits of the internal integer, i.e., without the decimal point, e.g., 5 for
+        // "123.45" and 1 for "0". Trailing zeros of the fractional part are not counted as they
+        // are removed on construction, see get_scale().
+        constexpr int32_t precision() const;
+
+        // Number of trailing zeros of the internal integer, e.g., 2 for "12300", 1 for the
+        // product of "1.5" and "2" (which is 30 with scale 1 internally) and 0 for "0".
+        //
+        // Both are calculated on first use and then cached in the decimal itself until it is
+        // changed, so calling them repeatedly is cheap.
+        constexpr int32_t trailing_zeros() const;
+
+        // Hash of the value regardless of its scale and internal representation, e.g., "1.5" and
+        // the product of "0.75" and "2" (150 with scale 2 internally) have the same hash as they
+        // compare equal. Also see std::hash<Decimal> and the batch version hash() below.
+        constexpr uint64_t hash() const noexcept;
+
         //=--------------------------------------------------------
         // Arithmetic operators.
         // Throw exception or trigger assertion on overflow or error.
@@ -1114,8 +1581,25 @@ class DecimalImpl final {
         // assertion. However, decimal multiplication overflowing least significant
         // digits would not throw or assert. Instead, the result would be rounded to
         // the maximum scale (using round-half-up rule) if necessary.
+        //
+        // mul<kMode>() rounds with kMode instead, e.g., mul<RoundingMode::kHalfEven>(rhs). The mode
+        // is a template argument, so that no rounding mode is checked at runtime: mul() is exactly
+        // the half-up multiplication.
         //=----------------------------------------------------------
-        constexpr ErrCode mul(const DecimalImpl &rhs) noexcept;
+        //
+        // The max scale is that of the DecimalContext of the calling thread (30 by default), or
+        // that of `context`, which is kInvalidArgument if it is invalid.
+        template <RoundingMode kMode = RoundingMode::kHalfUp>
+        constexpr ErrCode mul(const DecimalImpl &rhs) noexcept {
+                return mul_impl<kMode>(rhs, detail::current_decimal_context().max_scale);
+        }
+        template <RoundingMode kMode = RoundingMode::kHalfUp>
+        constexpr ErrCode mul(const DecimalImpl &rhs, const DecimalContext &context) noexcept {
+                if (!context.is_valid()) {
+                        return kInvalidArgument;
+                }
+                return mul_impl<kMode>(rhs, context.max_scale);
+        }
 
         constexpr DecimalImpl &operator*=(const DecimalImpl &rhs) {
                 ErrCode err = mul(rhs);
@@ -1157,8 +1641,25 @@ class DecimalImpl final {
         // Intermediate result might be increased to scale kDecimalMaxScale+4+1=35 before rounding,
         // where intermediate result would be calculated using 35 least significant digits.
         // After the division, it is rounded back to maximum scale 30.
+        //
+        // div<kMode>() rounds the quotient with kMode instead, like mul<kMode>(), e.g.,
+        // 1.00 div<RoundingMode::kDown> 3 = 0.333333 and 2.00 div<RoundingMode::kCeiling> 3 =
+        // 0.666667.
         //=----------------------------------------------------------
-        constexpr ErrCode div(const DecimalImpl &rhs) noexcept;
+        //
+        // The max scale and the increase of scale (4 and 30 above) are those of the
+        // DecimalContext of the calling thread, or of `context`, like mul().
+        template <RoundingMode kMode = RoundingMode::kHalfUp>
+        constexpr ErrCode div(const DecimalImpl &rhs) noexcept {
+                return div_impl<kMode>(rhs, detail::current_decimal_context());
+        }
+        template <RoundingMode kMode = RoundingMode::kHalfUp>
+        constexpr ErrCode div(const DecimalImpl &rhs, const DecimalContext &context) noexcept {
+                if (!context.is_valid()) {
+                        return kInvalidArgument;
+                }
+                return div_impl<kMode>(rhs, context);
+        }
 
         constexpr DecimalImpl &operator/=(const DecimalImpl &rhs) {
                 ErrCode err = div(rhs);
@@ -1203,6 +1704,25 @@ class DecimalImpl final {
                 return *this;
         }
 
+        //=----------------------------------------------------------
+        // Integer division.
+        //
+        // divmod() computes both the quotient and the remainder of *this / rhs with a single
+        // division, e.g., to split an amount into whole lots and a residual. The quotient is
+        // the integer trunc(*this / rhs), with scale 0, and the remainder is *this % rhs, so
+        // that *this == quotient * rhs + remainder. quotient and remainder might be *this or
+        // rhs, but must not be the same decimal.
+        //
+        // div_floor() replaces *this by the integer floor(*this / rhs), with scale 0.
+        //
+        // Both return kDivByZero if rhs is zero and kDecimalDivOverflow if the quotient exceeds
+        // the max precision, leaving the results untouched, or the error of a poisoned operand,
+        // which poisons the results.
+        //=----------------------------------------------------------
+        constexpr ErrCode divmod(const DecimalImpl &rhs, DecimalImpl &quotient,
+                                 DecimalImpl &remainder) const noexcept;
+        constexpr ErrCode div_floor(const DecimalImpl &rhs) noexcept;
+
         //=-=--------------------------------------------------------
         // operator %
         //=-=--------------------------------------------------------
@@ -1223,8 +1743,8 @@ class DecimalImpl final {
         constexpr bool operator<(const DecimalImpl &rhs) const;
         constexpr bool operator<=(const DecimalImpl &rhs) const;
         constexpr bool operator!=(const DecimalImpl &rhs) const { return !(*this == rhs); }
-        constexpr bool operator>(const DecimalImpl &rhs) const { return !(*this <= rhs); }
-        constexpr bool operator>=(const DecimalImpl &rhs) const { return !(*this < rhs); }
+        constexpr bool operator>(const DecimalImpl &rhs) const { return rhs < *this; }
+        constexpr bool operator>=(const DecimalImpl &rhs) const { return rhs <= *this; }
 
         constexpr bool operator==(double f) const {
                 double d = static_cast<double>(f);
@@ -1239,8 +1759,131 @@ class DecimalImpl final {
                 return *this <= DecimalImpl{d};
         }
         constexpr bool operator!=(double f) const { return !(*this == f); }
-        constexpr bool operator>(double f) const { return !(*this <= f); }
-        constexpr bool operator>=(double f) const { return !(*this < f); }
+        constexpr bool operator>(double f) const { return DecimalImpl{f} < *this; }
+        constexpr bool operator>=(double f) const { return DecimalImpl{f} <= *this; }
+
+        //=--------------------------------------------------------
+        // Sticky errors.
+        //
+        // A poisoned decimal holds an error instead of a value, like a NaN. It is the result of
+        // add(), sub(), mul(), div() and mod() whenever either operand is poisoned, and those
+        // return its error, so that the first error of a chain of operations sticks. Every
+        // comparison with a poisoned decimal is false, except for `!=`.
+        //
+        // The *_sticky() operations poison *this on error instead of leaving the error to the
+        // caller, so batch code could run straight-line and check once per row (or column):
+        //
+        //   Decimal v = price;
+        //   v.mul_sticky(quantity).sub_sticky(discount).div_sticky(rate);
+        //   if (v.is_poisoned()) { ... v.get_error() ... }
+        //
+        // Decimals are never poisoned otherwise. Operators (e.g., `+=`) throw or assert on a
+        // poisoned operand as on any other error. Apart from copying, comparison, negation,
+        // to_string() ("NaN"), rescale() and the above, a poisoned decimal must not be used.
+        //=--------------------------------------------------------
+        constexpr bool is_poisoned() const noexcept { return m_dtype == DType::kPoisoned; }
+        // The error of a poisoned decimal, or kSuccess.
+        constexpr ErrCode get_error() const noexcept {
+                if (!is_poisoned()) {
+                        return kSuccess;
+                }
+                return static_cast<ErrCodeValue>(m_i64);
+        }
+        // Poison *this with `err`, which must be an error.
+        constexpr void poison(ErrCode err) noexcept {
+                __BIGNUM_ASSERT(err);
+                set_dtype(DType::kPoisoned);
+                m_i64 = static_cast<int>(err);
+                m_scale = 0;
+        }
+
+        constexpr DecimalImpl &add_sticky(const DecimalImpl &rhs) noexcept {
+                return poison_on_error(add(rhs));
+        }
+        constexpr DecimalImpl &sub_sticky(const DecimalImpl &rhs) noexcept {
+                return poison_on_error(sub(rhs));
+        }
+        template <RoundingMode kMode = RoundingMode::kHalfUp>
+        constexpr DecimalImpl &mul_sticky(const DecimalImpl &rhs) noexcept {
+                return poison_on_error(mul<kMode>(rhs));
+        }
+        template <RoundingMode kMode = RoundingMode::kHalfUp>
+        constexpr DecimalImpl &div_sticky(const DecimalImpl &rhs) noexcept {
+                return poison_on_error(div<kMode>(rhs));
+        }
+        constexpr DecimalImpl &mod_sticky(const DecimalImpl &rhs) noexcept {
+                return poison_on_error(mod(rhs));
+        }
+
+        //=--------------------------------------------------------
+        // Unchecked arithmetic.
+        //
+        // add(), sub() and mul() for hot loops over values whose range is known, e.g., prices
+        // below 10^9 with scale 4 times quantities below 10^6. If both operands are int64, the
+        // result is a plain int64 operation, with neither an overflow check nor a fallback to a
+        // wider representation. Otherwise, they are the checked operations.
+        //
+        // The caller guarantees, as asserted in debug builds only, that:
+        //   - the checked operation would succeed, e.g., no operand is poisoned,
+        //   - the integer of the result (at scale max(lscale, rscale) for addition and subtraction,
+        //     or lscale + rscale for multiplication) fits into int64,
+        //   - for multiplication, lscale + rscale is within the max scale of the DecimalContext,
+        //     so that the product is exact.
+        // Otherwise, the result is undefined.
+        //=--------------------------------------------------------
+        constexpr DecimalImpl &add_unchecked(const DecimalImpl &rhs) noexcept {
+                return add_unchecked_impl<false>(rhs);
+        }
+        constexpr DecimalImpl &sub_unchecked(const DecimalImpl &rhs) noexcept {
+                return add_unchecked_impl<true>(rhs);
+        }
+        constexpr DecimalImpl &mul_unchecked(const DecimalImpl &rhs) noexcept;
+
+        //=--------------------------------------------------------
+        // Saturating arithmetic.
+        //
+        // add(), sub() and mul() that clamp a result of more than kMaxPrecision digits to
+        // max_value() or min_value() at the scale of the result, instead of failing, e.g., for
+        // smoothing where a clamped value is better than none:
+        //
+        //   ema.mul_saturating(alpha).add_saturating(price);
+        //
+        // Only the overflow path differs from the checked operation, so a result that fits
+        // costs the same. A poisoned operand still poisons the result.
+        //=--------------------------------------------------------
+        constexpr DecimalImpl &add_saturating(const DecimalImpl &rhs) noexcept {
+                return add_saturating_impl<false>(rhs);
+        }
+        constexpr DecimalImpl &sub_saturating(const DecimalImpl &rhs) noexcept {
+                return add_saturating_impl<true>(rhs);
+        }
+        template <RoundingMode kMode = RoundingMode::kHalfUp>
+        constexpr DecimalImpl &mul_saturating(const DecimalImpl &rhs) noexcept {
+                const ErrCode err = mul<kMode>(rhs);
+                if (err == ErrCode(kDecimalMulOverflow) && !is_poisoned()) [[unlikely]] {
+                        // Both are non-zero, and *this is untouched
+                        saturate(is_negative() != rhs.is_negative(),
+                                 std::min(m_scale + rhs.m_scale,
+                                          detail::current_decimal_context().max_scale));
+                }
+                return *this;
+        }
+
+        // The largest value of kMaxPrecision digits with the given scale, i.e., 10^96 - 1 at scale
+        // 0, or 999...9.9999 with 4 of the 96 digits after the decimal point at scale 4.
+        constexpr static DecimalImpl max_value(int32_t scale = 0) {
+                __BIGNUM_ASSERT(scale >= 0 && scale <= kMaxScale);
+                DecimalImpl d;
+                d.saturate(false, scale);
+                return d;
+        }
+        // -max_value(scale)
+        constexpr static DecimalImpl min_value(int32_t scale = 0) {
+                __BIGNUM_ASSERT(scale >= 0 && scale <= kMaxScale);
+                DecimalImpl d;
+                d.saturate(true, scale);
+                return d;
+        }
 
         constexpr void sanity_check() const;
 
@@ -1249,19 +1892,135 @@ class DecimalImpl final {
         constexpr void store_gmp_value(const U &gv) {
                 init_internal_gmp();
                 detail::copy_gmp_to_gmp(m_gmp, gv);
-                m_dtype = DType::kGmp;
+                set_dtype(DType::kGmp);
         }
 
-        constexpr void copy(const DecimalImpl &rhs) {
-                m_dtype = rhs.m_dtype;
-                m_scale = rhs.m_scale;
+        // Store an integer result into the smallest internal representation that fits, so that
+        // subsequent operations on it take the fastest path.
+        constexpr void store_int128(__int128_t v) {
+                if (v >= INT64_MIN && v <= INT64_MAX) {
+                        set_dtype(DType::kInt64);
+                        m_i64 = static_cast<int64_t>(v);
+                } else {
+                        set_dtype(DType::kInt128);
+                        m_i128 = v;
+                }
+        }
+
+        constexpr void store_int256(const detail::Int256 &v) {
+                if (v.fits_int128()) {
+                        store_int128(static_cast<__int128_t>(v.lo));
+                } else {
+                        set_dtype(DType::kInt256);
+                        m_i256 = v;
+                }
+        }
+
+        // Same as above for a gmp result, which must not exceed the maximum value of precision
+        // kMaxPrecision. Checking the number of limbs is enough to skip the narrowing of large
+        // values. In gmp only mode, the result is kept in gmp.
+        template <typename U>
+        constexpr void store_gmp_result(const U &gv) {
+#ifdef BIGNUM_DEV_USE_GMP_ONLY
+                store_gmp_value(gv);
+#else
+                const int32_t n = detail::constexpr_abs(gv.mpz._mp_size);
+                if (n > detail::Int256::kNumLimbs) {
+                        store_gmp_value(gv);
+                } else {
+                        store_magnitude(gv.limbs, n, gv.mpz._mp_size < 0);
+                }
+#endif
+        }
+
+        // The internal representation an operation between *this and rhs is dispatched on.
+        constexpr int32_t dispatch_tier(const DecimalImpl &rhs) const {
+                return static_cast<int32_t>(m_dtype > rhs.m_dtype ? m_dtype : rhs.m_dtype);
+        }
+
+        // Store an unsigned magnitude (least significant limb first) together with its sign into
+        // the smallest internal representation that fits. The magnitude must not exceed the
+        // maximum value of precision kMaxPrecision. Scale is left untouched.
+        constexpr void store_magnitude(const uint64_t *limbs, int32_t n, bool negative) {
+                n = detail::normalized_limbs_size(limbs, n);
+                __BIGNUM_ASSERT(n <= static_cast<int32_t>(detail::Gmp320::kNumLimbs));
+                if (n == 0) {
+                        set_dtype(DType::kInt64);
+                        m_i64 = 0;
+                } else if (n == 1 && limbs[0] <= static_cast<uint64_t>(INT64_MAX) + negative) {
+                        set_dtype(DType::kInt64);
+                        m_i64 = static_cast<int64_t>(negative ? (~limbs[0] + 1) : limbs[0]);
+                } else if (n == 1 || (n == 2 && (limbs[1] <= static_cast<uint64_t>(INT64_MAX) ||
+                                                 (negative && limbs[1] == 1ull << 63 &&
+                                                  limbs[0] == 0)))) {
+                        uint64_t hi = (n == 2) ? limbs[1] : 0;
+                        __uint128_t u128 = (static_cast<__uint128_t>(hi) << 64) | limbs[0];
+                        set_dtype(DType::kInt128);
+                        m_i128 = static_cast<__int128_t>(negative ? (~u128 + 1) : u128);
+                } else if (detail::Int256::magnitude_fits(limbs, n, negative)) {
+                        set_dtype(DType::kInt256);
+                        m_i256 = detail::Int256::from_magnitude(limbs, n, negative);
+                } else {
+                        init_internal_gmp();
+                        for (int32_t i = 0; i < n; ++i) {
+                                m_gmp.limbs[i] = limbs[i];
+                        }
+                        m_gmp.mpz._mp_size = negative ? -n : n;
+                        set_dtype(DType::kGmp);
+                }
+        }
+
+        // Copy the magnitude of the internal integer into `limbs` (which must be able to hold
+        // Gmp320::kNumLimbs limbs), least significant limb first. Return the number of limbs.
+        constexpr int32_t get_magnitude(uint64_t *limbs) const {
                 if (m_dtype == DType::kInt64) {
-                        m_i64 = rhs.m_i64;
+                        limbs[0] = m_i64 < 0 ? ~static_cast<uint64_t>(m_i64) + 1
+                                             : static_cast<uint64_t>(m_i64);
+                        return limbs[0] ? 1 : 0;
                 } else if (m_dtype == DType::kInt128) {
-                        m_i128 = rhs.m_i128;
+                        __uint128_t u128 = m_i128 < 0 ? ~static_cast<__uint128_t>(m_i128) + 1
+                                                      : static_cast<__uint128_t>(m_i128);
+                        limbs[0] = static_cast<uint64_t>(u128);
+                        limbs[1] = static_cast<uint64_t>(u128 >> 64);
+                        return limbs[1] ? 2 : (limbs[0] ? 1 : 0);
+                } else if (m_dtype == DType::kInt256) {
+                        return m_i256.get_magnitude(limbs);
                 } else {
                         assert(m_dtype == DType::kGmp);
+                        int32_t n = detail::constexpr_abs(m_gmp.mpz._mp_size);
+                        for (int32_t i = 0; i < n; ++i) {
+                                limbs[i] = m_gmp.limbs[i];
+                        }
+                        return n;
+                }
+        }
+
+        constexpr void copy(const DecimalImpl &rhs) {
+                // Branch on a local copy of the representation: the atomic loads of the cache
+                // below would otherwise make the compiler reload it, and then see a path that
+                // copies a gmp value that was never written.
+                const DType dtype = rhs.m_dtype;
+                m_dtype = dtype;
+                m_scale = rhs.m_scale;
+                if (dtype == DType::kInt64) {
+                        m_i64 = rhs.m_i64;
+                } else if (dtype == DType::kInt128) {
+                        m_i128 = rhs.m_i128;
+                } else if (dtype == DType::kInt256) {
+                        m_i256 = rhs.m_i256;
+                } else if (dtype == DType::kGmp) {
                         store_gmp_value(rhs.m_gmp);
+                } else {
+                        assert(dtype == DType::kPoisoned);
+                        m_i64 = rhs.m_i64;
+                }
+                if (std::is_constant_evaluated()) {
+                        // The cache of a constexpr object is not readable at compile time
+                        m_precision = kMetaUnknown;
+                        m_trailing_zeros = kMetaUnknown;
+                } else {
+                        m_precision = load_meta(rhs.m_precision);
+                        m_trailing_zeros = load_meta(rhs.m_trailing_zeros);
                 }
         }
 
@@ -1274,25 +2033,47 @@ class DecimalImpl final {
         constexpr void init_internal_gmp();
         constexpr void negate();
 
+        // lhs + rhs, or lhs - rhs if kSub
+        template <bool kSub>
         constexpr ErrCode add_i64_i64(int64_t l64, int32_t lscale, int64_t r64,
                                       int32_t rscale) noexcept;
+        template <bool kSub>
         constexpr ErrCode add_i128_i128(__int128_t l128, int32_t lscale, __int128_t r128,
                                         int32_t rscale) noexcept;
+        template <bool kSub>
+        constexpr ErrCode add_i256_i256(const detail::Int256 &l256, int32_t lscale,
+                                        const detail::Int256 &r256, int32_t rscale) noexcept;
+        template <bool kSub>
         constexpr ErrCode add_gmp_gmp(const detail::Gmp320 &l, int32_t lscale,
                                       const detail::Gmp320 &r, int32_t rscale) noexcept;
 
-        constexpr ErrCode mul_i64_i64(int64_t l64, int32_t lscale, int64_t r64,
-                                      int32_t rscale) noexcept;
+        template <RoundingMode kMode>
+        constexpr ErrCode mul_i64_i64(int64_t l64, int32_t lscale, int64_t r64, int32_t rscale,
+                                      int32_t max_scale) noexcept;
+        template <RoundingMode kMode>
         constexpr ErrCode mul_i128_i128(__int128_t l128, int32_t lscale, __int128_t r128,
-                                        int32_t rscale) noexcept;
+                                        int32_t rscale, int32_t max_scale) noexcept;
+        template <RoundingMode kMode>
+        constexpr ErrCode mul_i256_i256(const detail::Int256 &l256, int32_t lscale,
+                                        const detail::Int256 &r256, int32_t rscale,
+                                        int32_t max_scale) noexcept;
 
+        template <RoundingMode kMode>
         constexpr ErrCode mul_gmp_gmp(const detail::Gmp320 &l, int32_t lscale,
-                                      const detail::Gmp320 &r, int32_t rscale) noexcept;
+                                      const detail::Gmp320 &r, int32_t rscale,
+                                      int32_t max_scale) noexcept;
 
-        constexpr ErrCode div_i64_i64(int64_t l64, int32_t lscale, int64_t r64,
-                                      int32_t rscale) noexcept;
-        constexpr ErrCode div_i128_i128(__int128_t l128, int32_t lscale, __int128_t r128,
-                                        int32_t rscale) noexcept;
+        template <RoundingMode kMode>
+        constexpr ErrCode mul_impl(const DecimalImpl &rhs, int32_t max_scale) noexcept;
+        template <RoundingMode kMode>
+        constexpr ErrCode div_impl(const DecimalImpl &rhs, const DecimalContext &context) noexcept;
+
+        // Quotient of int128 (or int64) values, where the quotient with one more digit for
+        // rounding is |l128| * 10^exp / |r128| (or |l128| / (|r128| * 10^-exp)). kError if that
+        // does not fit into int128, in which case the division is to be done in gmp.
+        template <RoundingMode kMode>
+        constexpr ErrCode div_i128_i128(__int128_t l128, __int128_t r128, int32_t exp,
+                                        int32_t res_scale) noexcept;
 
         constexpr ErrCode mod_i64_i64(int64_t l64, int32_t lscale, int64_t r64,
                                       int32_t rscale) noexcept;
@@ -1303,9 +2084,14 @@ class DecimalImpl final {
         constexpr int cmp_i64_i64(int64_t l64, int32_t lscale, int64_t r64, int32_t rscale) const;
         constexpr int cmp_i128_i128(__int128_t l128, int32_t lscale, __int128_t r128,
                                     int32_t rscale) const;
+        constexpr int cmp_i256_i256(const detail::Int256 &l256, int32_t lscale,
+                                    const detail::Int256 &r256, int32_t rscale) const;
         constexpr int cmp_gmp_gmp(const detail::Gmp320 &l320, int32_t lscale,
                                   const detail::Gmp320 &r320, int32_t rscale) const;
 
+        // Widen the internal integer.
+        constexpr detail::Gmp320 get_gmp320() const;
+
         // For dev purpose only.
         constexpr void convert_internal_representation_to_gmp() noexcept;
 
@@ -1313,25 +2099,323 @@ class DecimalImpl final {
         enum class DType : uint8_t {
                 kInt64 = 0,
                 kInt128 = 1,
-                kGmp = 2,
+                kInt256 = 2,
+                kGmp = 3,
+                // Not a value but an error in m_i64, see is_poisoned().
+                kPoisoned = 4,
         };
+        static_assert(static_cast<int32_t>(DType::kGmp) == DecimalStats::kGmp);
+
+        // Whether *this or rhs is poisoned, with a single test on both dtypes.
+        constexpr bool any_poisoned(const DecimalImpl &rhs) const {
+                static_assert(static_cast<uint8_t>(DType::kGmp) <
+                              static_cast<uint8_t>(DType::kPoisoned));
+                return ((static_cast<uint8_t>(m_dtype) | static_cast<uint8_t>(rhs.m_dtype)) &
+                        static_cast<uint8_t>(DType::kPoisoned)) != 0;
+        }
+        // Poison *this with the error of *this, or else of rhs, and return it.
+        constexpr ErrCode propagate_poison(const DecimalImpl &rhs) {
+                const ErrCode err = is_poisoned() ? get_error() : rhs.get_error();
+                poison(err);
+                return err;
+        }
+        constexpr DecimalImpl &poison_on_error(ErrCode err) {
+                if (err) {
+                        poison(err);
+                }
+                return *this;
+        }
 
-        // If a decimal is small enough, we would try to store it in int64_t so that
-        // we can use int64_t arithmetic to speed up the calculation. The same for
-        // int128_t.
+        template <bool kSub>
+        constexpr DecimalImpl &add_unchecked_impl(const DecimalImpl &rhs) noexcept;
+
+        // The integer quotient of *this / rhs, truncated or floored (kFloor), and the remainder
+        // with the sign of *this or rhs respectively, into quotient and remainder if not null.
+        template <bool kFloor>
+        constexpr ErrCode divmod_impl(const DecimalImpl &rhs, DecimalImpl *quotient,
+                                      DecimalImpl *remainder) const noexcept;
+
+        template <bool kSub>
+        constexpr DecimalImpl &add_saturating_impl(const DecimalImpl &rhs) noexcept {
+                const ErrCode err = kSub ? sub(rhs) : add(rhs);
+                if (err == ErrCode(kDecimalAddSubOverflow) && !is_poisoned()) [[unlikely]] {
+                        // *this is untouched, and the exact result is negative iff *this is below
+                        // -rhs (or rhs for subtraction).
+                        const bool negative = kSub ? *this < rhs : *this < -rhs;
+                        saturate(negative, std::max(m_scale, rhs.m_scale));
+                }
+                return *this;
+        }
+        // Store max_value(scale), or min_value(scale) if negative.
+        constexpr void saturate(bool negative, int32_t scale) {
+                store_gmp_result(negative ? detail::kMin96DigitsGmpValue
+                                          : detail::kMax96DigitsGmpValue);
+                m_scale = scale;
+        }
+
+        // Value of m_precision and m_trailing_zeros if not calculated yet.
+        constexpr static uint8_t kMetaUnknown = 0xff;
+
+        // precision() and trailing_zeros() fill in the cache of a const decimal, which other
+        // threads might be reading as well. So the cache of a decimal that is not being modified
+        // is only accessed with relaxed atomics, and never at compile time.
+        static uint8_t load_meta(uint8_t &meta) {
+                return std::atomic_ref<uint8_t>(meta).load(std::memory_order_relaxed);
+        }
+        static void store_meta(uint8_t &meta, uint8_t value) {
+                std::atomic_ref<uint8_t>(meta).store(value, std::memory_order_relaxed);
+        }
+
+        constexpr int32_t calc_precision() const;
+        constexpr int32_t calc_trailing_zeros() const;
+
+        // Magnitude of the internal integer with its trailing zeros removed, and the scale reduced
+        // by as many (so it might be negative), which are the same for all values that compare
+        // equal. Return the number of limbs, or 0 (with scale 0) for zero.
+        constexpr int32_t get_normalized_magnitude(uint64_t *limbs, int32_t &scale) const;
+
+        // Every change of the internal integer goes through here, which drops the cached digit
+        // count and trailing zeros.
+        constexpr void set_dtype(DType dtype) {
+                m_dtype = dtype;
+                m_precision = kMetaUnknown;
+                m_trailing_zeros = kMetaUnknown;
+        }
+
+        // Whether both the digit count and trailing zeros are cached. Never at compile time.
+        constexpr bool has_cached_meta() const {
+                return !std::is_constant_evaluated() && load_meta(m_precision) != kMetaUnknown &&
+                       load_meta(m_trailing_zeros) != kMetaUnknown;
+        }
+
+        // Cached number of digits of *this and rhs aligned to the same scale (for addition),
+        // or of their product (at least), or 0 if either digit count is not cached yet.
+        constexpr int32_t cached_aligned_precision(const DecimalImpl &rhs) const {
+                if (std::is_constant_evaluated()) {
+                        return 0;
+                }
+                const uint8_t precision = load_meta(m_precision);
+                const uint8_t rhs_precision = load_meta(rhs.m_precision);
+                if (precision == kMetaUnknown || rhs_precision == kMetaUnknown) {
+                        return 0;
+                }
+                const int32_t scale = detail::constexpr_max(m_scale, rhs.m_scale);
+                return detail::constexpr_max(precision + scale - m_scale,
+                                             rhs_precision + scale - rhs.m_scale);
+        }
+
+        constexpr int32_t cached_product_precision(const DecimalImpl &rhs) const {
+                if (std::is_constant_evaluated()) {
+                        return 0;
+                }
+                const uint8_t precision = load_meta(m_precision);
+                const uint8_t rhs_precision = load_meta(rhs.m_precision);
+                if (precision == kMetaUnknown || rhs_precision == kMetaUnknown) {
+                        return 0;
+                }
+                return precision + rhs_precision - 1;
+        }
+
+        // Integers of this many digits (at least 10^(digits - 1)) never fit into the given
+        // representation, so that the attempt on it can be skipped.
+        constexpr static int32_t overflow_digits(DType d) {
+                return d == DType::kInt64 ? 20 : (d == DType::kInt128 ? 40 : 78);
+        }
+
+        template <DType D>
+        using DTypeTag = std::integral_constant<DType, D>;
+
+        constexpr static DType wider_dtype(DType a, DType b) { return a > b ? a : b; }
+        constexpr static DType next_dtype(DType d) {
+                return static_cast<DType>(static_cast<uint8_t>(d) + 1);
+        }
+
+        // Call f(DTypeTag<L>{}, DTypeTag<R>{}), where L and R are the internal representations
+        // of *this and rhs, so that f can select a kernel specialized for that pair. Both switches
+        // are compiled into jump tables. They are not merged into a single one on a key of both
+        // representations: the compiler could not tell which cases of such a key are impossible
+        // when only one operand is known (e.g., a temporary), and would warn about payloads that
+        // are never read at runtime (GCC's -Wmaybe-uninitialized at -O2).
+        template <typename F>
+        constexpr decltype(auto) dispatch(const DecimalImpl &rhs, F &&f) const {
+                switch (m_dtype) {
+                        case DType::kInt64:
+                                return dispatch_rhs<DType::kInt64>(rhs, f);
+                        case DType::kInt128:
+                                return dispatch_rhs<DType::kInt128>(rhs, f);
+                        case DType::kInt256:
+                                return dispatch_rhs<DType::kInt256>(rhs, f);
+                        default:
+                                __BIGNUM_ASSERT(m_dtype == DType::kGmp);
+                                return dispatch_rhs<DType::kGmp>(rhs, f);
+                }
+        }
+
+        template <DType L, typename F>
+        constexpr decltype(auto) dispatch_rhs(const DecimalImpl &rhs, F &f) const {
+                switch (rhs.m_dtype) {
+                        case DType::kInt64:
+                                return f(DTypeTag<L>{}, DTypeTag<DType::kInt64>{});
+                        case DType::kInt128:
+                                return f(DTypeTag<L>{}, DTypeTag<DType::kInt128>{});
+                        case DType::kInt256:
+                                return f(DTypeTag<L>{}, DTypeTag<DType::kInt256>{});
+                        default:
+                                __BIGNUM_ASSERT(rhs.m_dtype == DType::kGmp);
+                                return f(DTypeTag<L>{}, DTypeTag<DType::kGmp>{});
+                }
+        }
+
+        // The internal integer, whose representation is known to be D, widened to the given type.
+        template <DType D>
+        constexpr __int128_t as_int128() const {
+                static_assert(D == DType::kInt64 || D == DType::kInt128);
+                if constexpr (D == DType::kInt64) {
+                        return m_i64;
+                } else {
+                        return m_i128;
+                }
+        }
+
+        template <DType D>
+        constexpr detail::Int256 as_int256() const {
+                static_assert(D != DType::kGmp);
+                if constexpr (D == DType::kInt256) {
+                        return m_i256;
+                } else {
+                        return detail::Int256(as_int128<D>());
+                }
+        }
+
+        // A reference to m_gmp for kGmp, otherwise a converted copy.
+        template <DType D>
+        constexpr decltype(auto) as_gmp320() const {
+                if constexpr (D == DType::kInt64) {
+                        return detail::conv_64_to_gmp320(m_i64);
+                } else if constexpr (D == DType::kInt128) {
+                        return detail::conv_128_to_gmp320(m_i128);
+                } else if constexpr (D == DType::kInt256) {
+                        return detail::conv_256_to_gmp320(m_i256);
+                } else {
+                        return (m_gmp);
+                }
+        }
+
+        // Kernels for a pair of internal representations (L, R) of *this and rhs. Arithmetic is
+        // calculated in the wider of L and R first, and then in the next representation each time
+        // it overflows. If gmp overflows the pre-defined maximum, we return overflow error.
+        //
+        // Representations wider than int64 (where a failed attempt is more than one overflow
+        // flag check) are skipped if the cached digit counts of the operands rule them out. Not
+        // for multiplication in int128, where trimming trailing zeros might avoid the overflow.
+        template <bool kSub, DType L, DType R, DType Tier = wider_dtype(L, R)>
+        constexpr ErrCode add_kernel(const DecimalImpl &rhs) noexcept {
+                if constexpr (Tier == DType::kGmp) {
+                        return add_gmp_gmp<kSub>(as_gmp320<L>(), m_scale, rhs.as_gmp320<R>(),
+                                                 rhs.m_scale);
+                } else if (Tier != DType::kInt64 &&
+                           cached_aligned_precision(rhs) >= overflow_digits(Tier)) {
+                        return add_kernel<kSub, L, R, next_dtype(Tier)>(rhs);
+                } else {
+                        ErrCode err = kError;
+                        if constexpr (Tier == DType::kInt64) {
+                                err = add_i64_i64<kSub>(m_i64, m_scale, rhs.m_i64, rhs.m_scale);
+                        } else if constexpr (Tier == DType::kInt128) {
+                                err = add_i128_i128<kSub>(as_int128<L>(), m_scale,
+                                                          rhs.as_int128<R>(), rhs.m_scale);
+                        } else {
+                                err = add_i256_i256<kSub>(as_int256<L>(), m_scale,
+                                                          rhs.as_int256<R>(), rhs.m_scale);
+                        }
+                        if (!err) {
+                                return kSuccess;
+                        }
+                        return add_kernel<kSub, L, R, next_dtype(Tier)>(rhs);
+                }
+        }
+
+        template <RoundingMode kMode, DType L, DType R, DType Tier = wider_dtype(L, R)>
+        constexpr ErrCode mul_kernel(const DecimalImpl &rhs, int32_t max_scale) noexcept {
+                if constexpr (Tier == DType::kGmp) {
+                        return mul_gmp_gmp<kMode>(as_gmp320<L>(), m_scale, rhs.as_gmp320<R>(),
+                                                  rhs.m_scale, max_scale);
+                } else if (Tier == DType::kInt256 &&
+                           cached_product_precision(rhs) >= overflow_digits(Tier)) {
+                        return mul_kernel<kMode, L, R, next_dtype(Tier)>(rhs, max_scale);
+                } else {
+                        ErrCode err = kError;
+                        if constexpr (Tier == DType::kInt64) {
+                                err = mul_i64_i64<kMode>(m_i64, m_scale, rhs.m_i64, rhs.m_scale,
+                                                         max_scale);
+                        } else if constexpr (Tier == DType::kInt128) {
+                                err = mul_i128_i128<kMode>(as_int128<L>(), m_scale,
+                                                           rhs.as_int128<R>(), rhs.m_scale,
+                                                           max_scale);
+                        } else {
+                                err = mul_i256_i256<kMode>(as_int256<L>(), m_scale,
+                                                           rhs.as_int256<R>(), rhs.m_scale,
+                                                           max_scale);
+                        }
+                        if (!err) {
+                                return kSuccess;
+                        }
+                        return mul_kernel<kMode, L, R, next_dtype(Tier)>(rhs, max_scale);
+                }
+        }
+
+        // Comparison never overflows: it is always done in the wider of L and R.
         //
-        // However, it is not gauranteed that the decimal would be stored in its
-        // smallest type, meaning that, a decimal that is able to fit in int64_t
-        // might be stored in int128_t or gmp struct. We try best to store the decimal in its
-        // smallest type, but it is not gauranteed all the time.
+        // Caller guarantees that *this and rhs have the same sign. With different scales, values
+        // wider than int64 are first compared by the number of integral digits, which saves
+        // scaling either of them most of the time.
+        template <DType L, DType R>
+        constexpr int cmp_kernel(const DecimalImpl &rhs) const {
+                constexpr DType kTier = wider_dtype(L, R);
+                if constexpr (kTier != DType::kInt64) {
+                        if (m_scale != rhs.m_scale) {
+                                const int32_t lint = precision() - m_scale;
+                                const int32_t rint = rhs.precision() - rhs.m_scale;
+                                if (lint != rint && to_bool() && rhs.to_bool()) {
+                                        return (lint > rint) != is_negative() ? 1 : -1;
+                                }
+                        }
+                }
+                if constexpr (kTier == DType::kInt64) {
+                        return cmp_i64_i64(m_i64, m_scale, rhs.m_i64, rhs.m_scale);
+                } else if constexpr (kTier == DType::kInt128) {
+                        return cmp_i128_i128(as_int128<L>(), m_scale, rhs.as_int128<R>(),
+                                             rhs.m_scale);
+                } else if constexpr (kTier == DType::kInt256) {
+                        return cmp_i256_i256(as_int256<L>(), m_scale, rhs.as_int256<R>(),
+                                             rhs.m_scale);
+                } else {
+                        return cmp_gmp_gmp(as_gmp320<L>(), m_scale, rhs.as_gmp320<R>(),
+                                           rhs.m_scale);
+                }
+        }
+
+        // If a decimal is small enough, we would try to store it in int64_t so that
+        // we can use int64_t arithmetic to speed up the calculation. The same for
+        // int128_t and Int256 (up to 76 digits), before falling back to gmp.
+        //
+        // Results of arithmetic operations are always stored in their smallest type, e.g., the
+        // quotient of a division, which is calculated with gmp, is narrowed down to int64_t if
+        // it fits. Values constructed otherwise (e.g., from a __int128_t) might still be stored in
+        // a wider type than needed.
         union {
                 struct {
                         union {
                                 int64_t m_i64;
                                 __int128_t m_i128;
+                                detail::Int256 m_i256;
                         };
-                        char m_padding0[40];
+                        char m_padding0[24];
                         DType m_dtype;
+                        // Lazily calculated by precision() and trailing_zeros(), see
+                        // kMetaUnknown. They take otherwise unused bytes, so that the size of
+                        // a decimal does not change.
+                        mutable uint8_t m_precision;
+                        mutable uint8_t m_trailing_zeros;
                         int32_t m_scale;
                 };
 
@@ -1348,23 +2432,44 @@ constexpr void DecimalImpl<T>::init_internal_gmp() {
 
 template <typename T>
 constexpr void DecimalImpl<T>::negate() {
+        if (is_poisoned()) {
+                return;
+        }
+        // Negation changes neither the number of digits nor the trailing zeros. The cache is not
+        // used at compile time.
+        const bool keep_meta = !std::is_constant_evaluated();
+        const uint8_t precision = keep_meta ? m_precision : kMetaUnknown;
+        const uint8_t trailing_zeros = keep_meta ? m_trailing_zeros : kMetaUnknown;
+
         if (m_dtype == DType::kInt64) {
                 if (m_i64 == INT64_MIN) {
-                        m_dtype = DType::kInt128;
+                        set_dtype(DType::kInt128);
                         m_i128 = -static_cast<__int128_t>(m_i64);
                 } else {
                         m_i64 = -m_i64;
                 }
         } else if (m_dtype == DType::kInt128) {
                 if (m_i128 == detail::kInt128Min) {
-                        store_gmp_value(detail::conv_128_to_gmp320(m_i128));
+                        set_dtype(DType::kInt256);
+                        m_i256 = detail::Int256(m_i128).twos_complement();
                 } else {
-                        m_i128 = -m_i128;
+                        store_int128(-m_i128);
+                }
+        } else if (m_dtype == DType::kInt256) {
+                detail::Int256 v;
+                if (detail::safe_negate(v, m_i256)) {
+                        store_gmp_value(detail::conv_256_to_gmp320(m_i256));
+                        m_gmp.negate();
+                } else {
+                        store_int256(v);
                 }
         } else {
                 assert(m_dtype == DType::kGmp);
                 m_gmp.negate();
         }
+
+        m_precision = precision;
+        m_trailing_zeros = trailing_zeros;
 }
 
 template <typename T>
@@ -1372,10 +2477,10 @@ template <IntegralType U>
 constexpr inline ErrCode DecimalImpl<T>::assign(U i) noexcept {
         m_scale = 0;
         if (sizeof(U) <= 8) {
-                m_dtype = DType::kInt64;
+                set_dtype(DType::kInt64);
                 m_i64 = i;
         } else {
-                m_dtype = DType::kInt128;
+                set_dtype(DType::kInt128);
                 m_i128 = i;
         }
 
@@ -1393,22 +2498,22 @@ constexpr inline ErrCode DecimalImpl<T>::assign(U i) noexcept {
 
         if constexpr (sizeof(U) < 8) {
                 m_i64 = i;
-                m_dtype = DType::kInt64;
+                set_dtype(DType::kInt64);
         } else if constexpr (sizeof(U) == 8) {
                 if (i <= static_cast<uint64_t>(INT64_MAX)) {
                         m_i64 = i;
-                        m_dtype = DType::kInt64;
+                        set_dtype(DType::kInt64);
                 } else {
                         m_i128 = i;
-                        m_dtype = DType::kInt128;
+                        set_dtype(DType::kInt128);
                 }
         } else if constexpr (std::is_same_v<U, __uint128_t>) {
                 if (i <= static_cast<__uint128_t>(detail::kInt128Max)) {
                         m_i128 = i;
-                        m_dtype = DType::kInt128;
+                        set_dtype(DType::kInt128);
                 } else {
-                        detail::Gmp320 nv = detail::conv_uint128_to_gmp320(i);
-                        store_gmp_value(nv);
+                        m_i256 = detail::Int256(0, i);
+                        set_dtype(DType::kInt256);
                 }
         } else {
                 static_assert(std::is_same_v<U, void>, "Invalid type");
@@ -1573,10 +2678,10 @@ constexpr inline ErrCode DecimalImpl<T>::assign_str_128(const char *start,
 
         __int128_t res128 = (is_negative ? -significant_v128 : significant_v128);
         if (res128 <= INT64_MAX && res128 >= INT64_MIN) {
-                m_dtype = DType::kInt64;
+                set_dtype(DType::kInt64);
                 m_i64 = static_cast<int64_t>(res128);
         } else {
-                m_dtype = DType::kInt128;
+                set_dtype(DType::kInt128);
                 m_i128 = res128;
         }
         return kSuccess;
@@ -1667,17 +2772,32 @@ constexpr inline ErrCode DecimalImpl<T>::assign_str_gmp(const char *start,
         int64_t xsize = mpn_set_str(m_gmp.mpz._mp_d, (unsigned char *)buf, num_digits, /*base*/ 10);
         m_gmp.mpz._mp_size = (is_negative ? -xsize : xsize);
 
-        m_dtype = DType::kGmp;
+        set_dtype(DType::kGmp);
         m_scale = scale;
+
+        // Keep values of up to 76 digits out of gmp, so that subsequent arithmetic on them
+        // does not have to call into gmp.
+        if (xsize <= detail::Int256::kNumLimbs) {
+                uint64_t limbs[detail::Int256::kNumLimbs] = {0};
+                for (int64_t i = 0; i < xsize; ++i) {
+                        limbs[i] = m_gmp.limbs[i];
+                }
+                store_magnitude(limbs, static_cast<int32_t>(xsize), is_negative);
+        }
         return kSuccess;
 }
 
 template <typename T>
 inline std::string DecimalImpl<T>::to_string() const noexcept {
+        if (is_poisoned()) {
+                return "NaN";
+        }
         if (m_dtype == DType::kInt64) {
                 return detail::decimal_64_to_string(m_i64, m_scale);
         } else if (m_dtype == DType::kInt128) {
                 return detail::decimal_128_to_string(m_i128, m_scale);
+        } else if (m_dtype == DType::kInt256) {
+                return detail::decimal_256_to_string(m_i256, m_scale);
         } else {
                 assert(m_dtype == DType::kGmp);
                 return detail::decimal_gmp_to_string(m_gmp, m_scale);
@@ -1693,8 +2813,8 @@ constexpr inline double DecimalImpl<T>::to_double() const noexcept {
         } else if (m_dtype == DType::kInt128) {
                 return static_cast<double>(m_i128) / detail::get_int128_power10(scale);
         } else {
-                assert(m_dtype == DType::kGmp);
-                double res = mpz_get_d(&m_gmp.mpz);
+                const detail::Gmp320 gmp = get_gmp320();
+                double res = mpz_get_d(&gmp.mpz);
                 while (scale > 0) {
                         int s = detail::constexpr_min(scale, 18);
                         int64_t scale_div = detail::get_int64_power10(s);
@@ -1711,10 +2831,15 @@ constexpr inline bool DecimalImpl<T>::to_bool() const noexcept {
                 return (m_i64 != 0);
         } else if (m_dtype == DType::kInt128) {
                 return (m_i128 != 0);
-        } else {
-                assert(m_dtype == DType::kGmp);
+        } else if (m_dtype == DType::kInt256) {
+                return !m_i256.is_zero();
+        } else if (m_dtype == DType::kGmp) {
                 bool is_zero = (m_gmp.mpz._mp_size == 0);
                 return !is_zero;
+        } else {
+                // Like a NaN
+                assert(m_dtype == DType::kPoisoned);
+                return true;
         }
 }
 
@@ -1727,6 +2852,8 @@ constexpr inline ErrCode DecimalImpl<T>::to_int64(int64_t &i) const noexcept {
         } else if (m_dtype == DType::kInt128) {
                 err = detail::get_integral_from_decimal_integral<int64_t, __int128_t>(i, m_i128,
                                                                                       m_scale);
+        } else if (m_dtype == DType::kInt256) {
+                err = detail::get_integral_from_decimal_gmp<int64_t>(i, get_gmp320(), m_scale);
         } else {
                 err = detail::get_integral_from_decimal_gmp<int64_t>(i, m_gmp, m_scale);
         }
@@ -1742,6 +2869,8 @@ constexpr inline ErrCode DecimalImpl<T>::to_int128(__int128_t &i) const noexcept
         } else if (m_dtype == DType::kInt128) {
                 err = detail::get_integral_from_decimal_integral<__int128_t, __int128_t>(i, m_i128,
                                                                                          m_scale);
+        } else if (m_dtype == DType::kInt256) {
+                err = detail::get_integral_from_decimal_gmp<__int128_t>(i, get_gmp320(), m_scale);
         } else {
                 err = detail::get_integral_from_decimal_gmp<__int128_t>(i, m_gmp, m_scale);
         }
@@ -1757,6 +2886,8 @@ constexpr inline ErrCode DecimalImpl<T>::to_uint64(uint64_t &i) const noexcept {
         } else if (m_dtype == DType::kInt128) {
                 err = detail::get_integral_from_decimal_integral<uint64_t, __int128_t>(i, m_i128,
                                                                                        m_scale);
+        } else if (m_dtype == DType::kInt256) {
+                err = detail::get_integral_from_decimal_gmp<uint64_t>(i, get_gmp320(), m_scale);
         } else {
                 err = detail::get_integral_from_decimal_gmp<uint64_t>(i, m_gmp, m_scale);
         }
@@ -1772,72 +2903,263 @@ constexpr inline ErrCode DecimalImpl<T>::to_uint128(__uint128_t &i) const noexce
         } else if (m_dtype == DType::kInt128) {
                 err = detail::get_integral_from_decimal_integral<__uint128_t, __int128_t>(i, m_i128,
                                                                                           m_scale);
+        } else if (m_dtype == DType::kInt256) {
+                err = detail::get_integral_from_decimal_gmp<__uint128_t>(i, get_gmp320(), m_scale);
         } else {
                 err = detail::get_integral_from_decimal_gmp<__uint128_t>(i, m_gmp, m_scale);
         }
         return err;
 }
 
+template <typename T>
+constexpr inline ErrCode DecimalImpl<T>::to_scaled_int128(int32_t scale,
+                                                          __int128_t &i) const noexcept {
+        const int32_t exp = scale - m_scale;
+        if (exp < 0 && trailing_zeros() < -exp) {
+                return kDecimalScaleOverflow;
+        }
+        if (m_dtype == DType::kInt64 && exp >= 0 && exp <= detail::kMaxUint64Power10) {
+                // Could not overflow
+                i = static_cast<__int128_t>(m_i64) * detail::kUint64Power10[exp];
+                return kSuccess;
+        }
+
+        // Only zeros are removed if exp is negative, and wider representations fit into int128
+        // after that or in the gmp-only mode.
+        uint64_t limbs[detail::Gmp320::kNumLimbs] = {0};
+        int32_t n = get_magnitude(limbs);
+        if (exp < 0) {
+                n = detail::div_limbs_power10(limbs, n, -exp);
+        }
+        const bool negative = is_negative();
+        const __uint128_t u = (static_cast<__uint128_t>(n > 1 ? limbs[1] : 0) << 64) | limbs[0];
+        if (n > 2 || u > static_cast<__uint128_t>(detail::kInt128Max) + negative) {
+                return kDecimalValueOutOfRange;
+        }
+        __int128_t v = static_cast<__int128_t>(negative ? ~u + 1 : u);
+        if (exp > 0 && v != 0 &&
+            (exp > detail::kMaxInt128Power10 ||
+             __builtin_mul_overflow(v, detail::kInt128Power10[exp], &v))) {
+                return kDecimalValueOutOfRange;
+        }
+        i = v;
+        return kSuccess;
+}
+
+template <typename T>
+constexpr inline ErrCode DecimalImpl<T>::trim_scale(int32_t scale) noexcept {
+        __BIGNUM_ASSERT(scale >= 0);
+        const int32_t exp = m_scale - scale;
+        if (exp <= 0) {
+                return kSuccess;
+        }
+        detail::Gmp320 gv;
+        int32_t n = get_magnitude(gv.limbs);
+        if (n != 0) {
+                if (trailing_zeros() < exp) {
+                        return kDecimalScaleOverflow;
+                }
+                n = detail::div_limbs_power10(gv.limbs, n, exp);
+                gv.mpz._mp_size = is_negative() ? -n : n;
+                store_gmp_result(gv);
+        }
+        m_scale = scale;
+        return kSuccess;
+}
+
+template <typename T>
+template <RoundingMode kMode>
+constexpr inline ErrCode DecimalImpl<T>::rescale(int32_t scale) noexcept {
+        if (is_poisoned()) {
+                return get_error();
+        }
+        if (scale < 0 || scale > kMaxScale) {
+                return kInvalidArgument;
+        }
+        if (scale == m_scale) {
+                return kSuccess;
+        }
+        if (scale > m_scale && precision() + scale - m_scale > kMaxPrecision) {
+                return kDecimalValueOutOfRange;
+        }
+
+        // Room for the carry of rounding as well
+        detail::Gmp640 gv;
+        int32_t n = get_magnitude(gv.limbs);
+        const bool negative = is_negative();
+        if (scale > m_scale) {
+                n = detail::mul_limbs_power10(gv.limbs, n, scale - m_scale);
+        } else {
+                n = detail::scale_down_limbs<kMode>(gv.limbs, n, m_scale - scale, negative);
+        }
+        gv.mpz._mp_size = negative ? -n : n;
+        store_gmp_result(gv);
+        m_scale = scale;
+        return kSuccess;
+}
+
 template <typename T>
 constexpr inline bool DecimalImpl<T>::is_negative() const {
         if (m_dtype == DType::kInt64) {
                 return m_i64 < 0;
         } else if (m_dtype == DType::kInt128) {
                 return m_i128 < 0;
-        } else {
-                assert(m_dtype == DType::kGmp);
+        } else if (m_dtype == DType::kInt256) {
+                return m_i256.is_negative();
+        } else if (m_dtype == DType::kGmp) {
                 return m_gmp.is_negative();
+        } else {
+                assert(m_dtype == DType::kPoisoned);
+                return false;
         }
 }
 
 template <typename T>
+constexpr inline int32_t DecimalImpl<T>::precision() const {
+        // The cache of a constexpr object is not readable (nor writable) at compile time
+        if (std::is_constant_evaluated()) {
+                return calc_precision();
+        }
+        uint8_t precision = load_meta(m_precision);
+        if (precision == kMetaUnknown) {
+                precision = static_cast<uint8_t>(calc_precision());
+                store_meta(m_precision, precision);
+        }
+        return precision;
+}
+
+template <typename T>
+constexpr inline int32_t DecimalImpl<T>::trailing_zeros() const {
+        if (std::is_constant_evaluated()) {
+                return calc_trailing_zeros();
+        }
+        uint8_t trailing_zeros = load_meta(m_trailing_zeros);
+        if (trailing_zeros == kMetaUnknown) {
+                trailing_zeros = static_cast<uint8_t>(calc_trailing_zeros());
+                store_meta(m_trailing_zeros, trailing_zeros);
+        }
+        return trailing_zeros;
+}
+
+template <typename T>
+constexpr inline int32_t DecimalImpl<T>::get_normalized_magnitude(uint64_t *limbs,
+                                                                  int32_t &scale) const {
+        const int32_t zeros = trailing_zeros();
+        int32_t n = 0;
+        if (m_dtype == DType::kInt64) {
+                uint64_t u = m_i64 < 0 ? ~static_cast<uint64_t>(m_i64) + 1
+                                       : static_cast<uint64_t>(m_i64);
+                limbs[0] = (u >> zeros) * detail::kPower5Inverses[zeros];
+                n = limbs[0] ? 1 : 0;
+        } else {
+                n = get_magnitude(limbs);
+                n = detail::div_limbs_power10(limbs, n, zeros);
+        }
+        scale = n ? m_scale - zeros : 0;
+        return n;
+}
+
+template <typename T>
+constexpr inline uint64_t DecimalImpl<T>::hash() const noexcept {
+        uint64_t limbs[detail::Gmp320::kNumLimbs] = {0};
+        int32_t scale = 0;
+        const int32_t n = get_normalized_magnitude(limbs, scale);
+        return detail::hash_limbs(limbs, n, n && is_negative(), scale);
+}
+
+template <typename T>
+constexpr int32_t DecimalImpl<T>::calc_precision() const {
+        uint64_t limbs[detail::Gmp320::kNumLimbs] = {0};
+        const int32_t n = get_magnitude(limbs);
+        return detail::count_digits_limbs(limbs, n);
+}
+
+template <typename T>
+constexpr int32_t DecimalImpl<T>::calc_trailing_zeros() const {
+        uint64_t limbs[detail::Gmp320::kNumLimbs] = {0};
+        const int32_t n = get_magnitude(limbs);
+        return detail::count_trailing_zeros_limbs(limbs, n);
+}
+
+template <typename T>
+template <bool kSub>
 constexpr inline ErrCode DecimalImpl<T>::add_i64_i64(int64_t l64, int32_t lscale, int64_t r64,
                                                      int32_t rscale) noexcept {
         int64_t res64 = 0;
         int32_t res_scale = 0;
-        ErrCode err = detail::decimal_add_integral(res64, res_scale, l64, lscale, r64, rscale);
+        ErrCode err = detail::decimal_add_integral<kSub>(res64, res_scale, l64, lscale,
+                                                         r64, rscale);
         if (err) {
                 return err;
         }
-        m_dtype = DType::kInt64;
+        set_dtype(DType::kInt64);
         m_i64 = res64;
         m_scale = res_scale;
         return kSuccess;
 }
 
 template <typename T>
+template <bool kSub>
 constexpr inline ErrCode DecimalImpl<T>::add_i128_i128(__int128_t l128, int32_t lscale,
                                                        __int128_t r128, int32_t rscale) noexcept {
         __int128_t res128 = 0;
         int32_t res_scale = 0;
-        ErrCode err = detail::decimal_add_integral(res128, res_scale, l128, lscale, r128, rscale);
+        ErrCode err = detail::decimal_add_integral<kSub>(res128, res_scale, l128, lscale,
+                                                         r128, rscale);
         if (err) {
                 return err;
         }
-        m_dtype = DType::kInt128;
-        m_i128 = res128;
+        store_int128(res128);
         m_scale = res_scale;
         return kSuccess;
 }
 
 template <typename T>
+template <bool kSub>
+constexpr inline ErrCode DecimalImpl<T>::add_i256_i256(const detail::Int256 &l256, int32_t lscale,
+                                                       const detail::Int256 &r256,
+                                                       int32_t rscale) noexcept {
+        detail::Int256 res256;
+        int32_t res_scale = 0;
+        ErrCode err = detail::decimal_add_int256<kSub>(res256, res_scale, l256, lscale,
+                                                       r256, rscale);
+        if (err) {
+                return err;
+        }
+        store_int256(res256);
+        m_scale = res_scale;
+        return kSuccess;
+}
+
+template <typename T>
+template <bool kSub>
 constexpr inline ErrCode DecimalImpl<T>::add_gmp_gmp(const detail::Gmp320 &l, int32_t lscale,
                                                      const detail::Gmp320 &r,
                                                      int32_t rscale) noexcept {
         detail::Gmp640 res640;
         if (lscale > rscale) {
-                const detail::Gmp320 pow = detail::get_gmp320_power10(lscale - rscale);
+                const detail::Gmp320 &pow = detail::get_gmp320_power10(lscale - rscale);
 
                 detail::Gmp640 intermediate;
                 mpz_mul(&intermediate.mpz, &r.mpz, &pow.mpz);
-                mpz_add(&res640.mpz, &intermediate.mpz, &l.mpz);
+                if constexpr (kSub) {
+                        mpz_sub(&res640.mpz, &l.mpz, &intermediate.mpz);
+                } else {
+                        mpz_add(&res640.mpz, &intermediate.mpz, &l.mpz);
+                }
 
         } else if (lscale < rscale) {
-                const detail::Gmp320 pow = detail::get_gmp320_power10(rscale - lscale);
+                const detail::Gmp320 &pow = detail::get_gmp320_power10(rscale - lscale);
 
                 detail::Gmp640 intermediate;
                 mpz_mul(&intermediate.mpz, &l.mpz, &pow.mpz);
-                mpz_add(&res640.mpz, &intermediate.mpz, &r.mpz);
+                if constexpr (kSub) {
+                        mpz_sub(&res640.mpz, &intermediate.mpz, &r.mpz);
+                } else {
+                        mpz_add(&res640.mpz, &intermediate.mpz, &r.mpz);
+                }
+        } else if constexpr (kSub) {
+                mpz_sub(&res640.mpz, &l.mpz, &r.mpz);
         } else {
                 mpz_add(&res640.mpz, &l.mpz, &r.mpz);
         }
@@ -1848,149 +3170,161 @@ constexpr inline ErrCode DecimalImpl<T>::add_gmp_gmp(const detail::Gmp320 &l, in
                 return kDecimalAddSubOverflow;
         }
 
-        store_gmp_value(res640);
+        store_gmp_result(res640);
         m_scale = detail::constexpr_max(lscale, rscale);
         return kSuccess;
 }
 
 template <typename T>
 constexpr inline ErrCode DecimalImpl<T>::add(const DecimalImpl<T> &rhs) noexcept {
+        if (any_poisoned(rhs)) {
+                return propagate_poison(rhs);
+        }
         sanity_check();
         rhs.sanity_check();
+        detail::count_decimal_op(DecimalStats::kAdd, dispatch_tier(rhs));
 
-        // Calculating in int64 mode is the fastest, but it can overflow, in which
-        // case we need to switch to int128 mode. If int128 mode also overflows, we
-        // need to switch to gmp mode. If gmp mode overflows the pre-defined maximum,
-        // we return overflow error.
-        ErrCode err = kError;
-        if (m_dtype == DType::kInt64) {
-                if (rhs.m_dtype == DType::kInt64) {
-                        err = add_i64_i64(m_i64, m_scale, rhs.m_i64, rhs.m_scale);
-                        if (!err) {
-                                return kSuccess;
-                        }
-
-                        err = add_i128_i128(static_cast<__int128_t>(m_i64), m_scale,
-                                            static_cast<__int128_t>(rhs.m_i64), rhs.m_scale);
-                        __BIGNUM_ASSERT(err == kSuccess);
-                        return kSuccess;
-
-                } else if (rhs.m_dtype == DType::kInt128) {
-                        err = add_i128_i128(static_cast<__int128_t>(m_i64), m_scale, rhs.m_i128,
-                                            rhs.m_scale);
-                        if (!err) {
-                                return kSuccess;
-                        }
-
-                        err = add_gmp_gmp(detail::conv_64_to_gmp320(m_i64), m_scale,
-                                          detail::conv_128_to_gmp320(rhs.m_i128), rhs.m_scale);
-                        __BIGNUM_ASSERT(!err);
-                        return kSuccess;
-
-                } else if (rhs.m_dtype == DType::kGmp) {
-                        return add_gmp_gmp(detail::conv_64_to_gmp320(m_i64), m_scale, rhs.m_gmp,
-                                           rhs.m_scale);
-
-                } else {
-                        __BIGNUM_ASSERT(false);
-                        return kError;
-                }
-        } else if (m_dtype == DType::kInt128) {
-                if (rhs.m_dtype == DType::kInt64) {
-                        err = add_i128_i128(m_i128, m_scale, static_cast<__int128_t>(rhs.m_i64),
-                                            rhs.m_scale);
-                        if (!err) {
-                                return kSuccess;
-                        }
-
-                        err = add_gmp_gmp(detail::conv_128_to_gmp320(m_i128), m_scale,
-                                          detail::conv_64_to_gmp320(rhs.m_i64), rhs.m_scale);
-                        __BIGNUM_ASSERT(!err);
-                        return kSuccess;
-
-                } else if (rhs.m_dtype == DType::kInt128) {
-                        err = add_i128_i128(m_i128, m_scale, rhs.m_i128, rhs.m_scale);
-                        if (!err) {
-                                return kSuccess;
-                        }
-
-                        err = add_gmp_gmp(detail::conv_128_to_gmp320(m_i128), m_scale,
-                                          detail::conv_128_to_gmp320(rhs.m_i128), rhs.m_scale);
-                        __BIGNUM_ASSERT(!err);
-                        return kSuccess;
-
-                } else if (rhs.m_dtype == DType::kGmp) {
-                        return add_gmp_gmp(detail::conv_128_to_gmp320(m_i128), m_scale, rhs.m_gmp,
-                                           rhs.m_scale);
-
-                } else {
-                        __BIGNUM_ASSERT(false);
-                        return kError;
-                }
-        } else if (m_dtype == DType::kGmp) {
-                if (rhs.m_dtype == DType::kInt64) {
-                        return add_gmp_gmp(m_gmp, m_scale, detail::conv_64_to_gmp320(rhs.m_i64),
-                                           rhs.m_scale);
-
-                } else if (rhs.m_dtype == DType::kInt128) {
-                        return add_gmp_gmp(m_gmp, m_scale, detail::conv_128_to_gmp320(rhs.m_i128),
-                                           rhs.m_scale);
+        // Most operands are small: check for them before dispatching on both representations.
+        if (m_dtype == DType::kInt64 && rhs.m_dtype == DType::kInt64) {
+                return add_kernel</*kSub*/ false, DType::kInt64, DType::kInt64>(rhs);
+        }
+        return dispatch(rhs, [&](auto l, auto r) {
+                return add_kernel</*kSub*/ false, decltype(l)::value, decltype(r)::value>(rhs);
+        });
+}
 
-                } else if (rhs.m_dtype == DType::kGmp) {
-                        return add_gmp_gmp(m_gmp, m_scale, rhs.m_gmp, rhs.m_scale);
+template <typename T>
+template <bool kSub>
+constexpr inline DecimalImpl<T> &DecimalImpl<T>::add_unchecked_impl(
+        const DecimalImpl<T> &rhs) noexcept {
+        if (m_dtype != DType::kInt64 || rhs.m_dtype != DType::kInt64) {
+                [[maybe_unused]] ErrCode err = kSub ? sub(rhs) : add(rhs);
+#ifndef NDEBUG
+                __BIGNUM_ASSERT(!err, "Unchecked decimal addition failed");
+#endif
+                return *this;
+        }
+        detail::count_decimal_op(kSub ? DecimalStats::kSub : DecimalStats::kAdd,
+                                 DecimalStats::kInt64);
+#ifndef NDEBUG
+        DecimalImpl checked = *this;
+        __BIGNUM_ASSERT(!(kSub ? checked.sub(rhs) : checked.add(rhs)) &&
+                                checked.m_dtype == DType::kInt64,
+                        "Unchecked decimal addition overflow");
+#endif
+        // Both sides are scaled up, one of them by 10^0, rather than branching on which one. A
+        // side scaled up by more than 10^18 must be zero.
+        const int32_t res_scale = std::max(m_scale, rhs.m_scale);
+        const int64_t l64 = m_i64 * detail::get_int64_power10(std::min(res_scale - m_scale, 18));
+        const int64_t r64 =
+                rhs.m_i64 * detail::get_int64_power10(std::min(res_scale - rhs.m_scale, 18));
+        set_dtype(DType::kInt64);
+        m_i64 = kSub ? l64 - r64 : l64 + r64;
+        m_scale = res_scale;
+#ifndef NDEBUG
+        __BIGNUM_ASSERT(m_i64 == checked.m_i64 && m_scale == checked.m_scale);
+#endif
+        return *this;
+}
 
-                } else {
-                        __BIGNUM_ASSERT(false);
-                        return kError;
-                }
-        } else {
-                __BIGNUM_ASSERT(false);
-                return kError;
+template <typename T>
+constexpr inline DecimalImpl<T> &DecimalImpl<T>::mul_unchecked(const DecimalImpl<T> &rhs) noexcept {
+        if (m_dtype != DType::kInt64 || rhs.m_dtype != DType::kInt64) {
+                [[maybe_unused]] ErrCode err = mul(rhs);
+#ifndef NDEBUG
+                __BIGNUM_ASSERT(!err, "Unchecked decimal multiplication failed");
+#endif
+                return *this;
         }
-        return kError;
+        detail::count_decimal_op(DecimalStats::kMul, DecimalStats::kInt64);
+#ifndef NDEBUG
+        DecimalImpl checked = *this;
+        __BIGNUM_ASSERT(!checked.mul(rhs) && checked.m_dtype == DType::kInt64 &&
+                                checked.m_scale == m_scale + rhs.m_scale,
+                        "Unchecked decimal multiplication overflow");
+#endif
+        set_dtype(DType::kInt64);
+        m_i64 *= rhs.m_i64;
+        m_scale += rhs.m_scale;
+#ifndef NDEBUG
+        __BIGNUM_ASSERT(m_i64 == checked.m_i64);
+#endif
+        return *this;
 }
 
 template <typename T>
 constexpr inline ErrCode DecimalImpl<T>::sub(const DecimalImpl<T> &rhs) noexcept {
-        auto v = rhs;
-        v.negate();
-        return add(v);
+        if (any_poisoned(rhs)) {
+                return propagate_poison(rhs);
+        }
+        sanity_check();
+        rhs.sanity_check();
+        detail::count_decimal_op(DecimalStats::kSub, dispatch_tier(rhs));
+
+        if (m_dtype == DType::kInt64 && rhs.m_dtype == DType::kInt64) {
+                return add_kernel</*kSub*/ true, DType::kInt64, DType::kInt64>(rhs);
+        }
+        return dispatch(rhs, [&](auto l, auto r) {
+                return add_kernel</*kSub*/ true, decltype(l)::value, decltype(r)::value>(rhs);
+        });
 }
 
 template <typename T>
+template <RoundingMode kMode>
 constexpr inline ErrCode DecimalImpl<T>::mul_i64_i64(int64_t l64, int32_t lscale, int64_t r64,
-                                                     int32_t rscale) noexcept {
+                                                     int32_t rscale, int32_t max_scale) noexcept {
         int64_t res64 = 0;
         int32_t res_scale = 0;
-        ErrCode err = detail::decimal_mul_integral(res64, res_scale, l64, lscale, r64, rscale);
+        ErrCode err = detail::decimal_mul_integral<kMode>(res64, res_scale, l64, lscale, r64,
+                                                          rscale, max_scale);
         if (err) {
                 return err;
         }
-        m_dtype = DType::kInt64;
+        set_dtype(DType::kInt64);
         m_i64 = res64;
         m_scale = res_scale;
         return kSuccess;
 }
 
 template <typename T>
+template <RoundingMode kMode>
 constexpr inline ErrCode DecimalImpl<T>::mul_i128_i128(__int128_t l128, int32_t lscale,
-                                                       __int128_t r128, int32_t rscale) noexcept {
+                                                       __int128_t r128, int32_t rscale,
+                                                       int32_t max_scale) noexcept {
         __int128_t res128 = 0;
         int32_t res_scale = 0;
-        ErrCode err = detail::decimal_mul_integral(res128, res_scale, l128, lscale, r128, rscale);
+        ErrCode err = detail::decimal_mul_integral<kMode>(res128, res_scale, l128, lscale, r128,
+                                                          rscale, max_scale);
         if (err) {
                 return err;
         }
-        m_dtype = DType::kInt128;
-        m_i128 = res128;
+        store_int128(res128);
         m_scale = res_scale;
         return kSuccess;
 }
 
 template <typename T>
+template <RoundingMode kMode>
+constexpr inline ErrCode DecimalImpl<T>::mul_i256_i256(const detail::Int256 &l256, int32_t lscale,
+                                                       const detail::Int256 &r256, int32_t rscale,
+                                                       int32_t max_scale) noexcept {
+        detail::Int256 res256;
+        int32_t res_scale = 0;
+        ErrCode err = detail::decimal_mul_int256<kMode>(res256, res_scale, l256, lscale, r256,
+                                                        rscale, max_scale);
+        if (err) {
+                return err;
+        }
+        store_int256(res256);
+        m_scale = res_scale;
+        return kSuccess;
+}
+
+template <typename T>
+template <RoundingMode kMode>
 constexpr inline ErrCode DecimalImpl<T>::mul_gmp_gmp(const detail::Gmp320 &l, int32_t lscale,
-                                                     const detail::Gmp320 &r,
-                                                     int32_t rscale) noexcept {
+                                                     const detail::Gmp320 &r, int32_t rscale,
+                                                     int32_t max_scale) noexcept {
         __BIGNUM_ASSERT(lscale >= 0 && lscale <= detail::kDecimalMaxScale);
         __BIGNUM_ASSERT(rscale >= 0 && rscale <= detail::kDecimalMaxScale);
 
@@ -1999,43 +3333,19 @@ constexpr inline ErrCode DecimalImpl<T>::mul_gmp_gmp(const detail::Gmp320 &l, in
         detail::Gmp640 res640;
         mpz_mul(&res640.mpz, &l.mpz, &r.mpz);
 
-        if (lscale + rscale > detail::kDecimalMaxScale) {
+        if (lscale + rscale > max_scale) {
                 bool is_negative = res640.mpz._mp_size < 0;
                 res640.mpz._mp_size = detail::constexpr_abs(res640.mpz._mp_size);
 
-                int32_t delta_scale = lscale + rscale - detail::kDecimalMaxScale;
-                // Need to do the rounding, so first div by (10 ^ (delta_scale - 1))
-                // As both lscale and rscale is <=kDecimalMaxScale, delta_scale is
-                // <=kDecimalMaxScale. So, the result of the division is <=10 ^ 30, which can be
-                // stored in an int128_t.
-
-                if (delta_scale - 1 > 0) {
-                        __int128_t div_first_part = detail::get_int128_power10(delta_scale - 1);
-                        detail::Gmp320 divisor = detail::conv_128_to_gmp320(div_first_part);
-                        // => res640 /= divisor
-                        detail::Gmp640 tmp640;
-                        mpz_tdiv_q(&tmp640.mpz, &res640.mpz, &divisor.mpz);
-                        res640 = tmp640;
-                }
-
-                detail::Gmp640 remainder;
-                mpz_tdiv_r_ui(&remainder.mpz, &res640.mpz, 10);
+                // Scale down by 10^delta_scale and round in a single pass. The product takes at
+                // most 10 limbs, leaving Gmp640's last limb for the rounding carry.
+                int32_t delta_scale = lscale + rscale - max_scale;
+                res640.mpz._mp_size = detail::scale_down_limbs<kMode>(
+                        res640.limbs, res640.mpz._mp_size, delta_scale, is_negative);
 
-                detail::Gmp640 tmp640;
-                mpz_tdiv_q_ui(&tmp640.mpz, &res640.mpz, 10);
-                res640 = tmp640;
-
-                int cmp5 = mpz_cmp_ui(&remainder.mpz, 5);
-                if (cmp5 >= 0) {
-                        mpz_add_ui(&res640.mpz, &res640.mpz, 1);
-                }
                 if (is_negative) {
                         res640.negate();
                 }
-
-                m_scale = detail::kDecimalMaxScale;
-        } else {
-                m_scale = lscale + rscale;
         }
 
         if (detail::check_gmp_out_of_range(res640, detail::kMin96DigitsGmpValue,
@@ -2043,119 +3353,125 @@ constexpr inline ErrCode DecimalImpl<T>::mul_gmp_gmp(const detail::Gmp320 &l, in
                 return kDecimalMulOverflow;
         }
 
-        store_gmp_value(res640);
+        store_gmp_result(res640);
+        m_scale = std::min(lscale + rscale, max_scale);
         return kSuccess;
 }
 
 template <typename T>
-constexpr inline ErrCode DecimalImpl<T>::mul(const DecimalImpl<T> &rhs) noexcept {
+template <RoundingMode kMode>
+constexpr inline ErrCode DecimalImpl<T>::mul_impl(const DecimalImpl<T> &rhs,
+                                                  int32_t max_scale) noexcept {
+        if (any_poisoned(rhs)) {
+                return propagate_poison(rhs);
+        }
         sanity_check();
         rhs.sanity_check();
+        detail::count_decimal_op(DecimalStats::kMul, dispatch_tier(rhs));
 
-        ErrCode err = kError;
-        if (m_dtype == DType::kInt64) {
-                if (rhs.m_dtype == DType::kInt64) {
-                        err = mul_i64_i64(m_i64, m_scale, rhs.m_i64, rhs.m_scale);
-                        if (!err) {
-                                return kSuccess;
-                        }
-
-                        err = mul_i128_i128(static_cast<__int128_t>(m_i64), m_scale,
-                                            static_cast<__int128_t>(rhs.m_i64), rhs.m_scale);
-                        __BIGNUM_ASSERT(err == kSuccess);
-                        return kSuccess;
-
-                } else if (rhs.m_dtype == DType::kInt128) {
-                        err = mul_i128_i128(static_cast<__int128_t>(m_i64), m_scale, rhs.m_i128,
-                                            rhs.m_scale);
-                        if (!err) {
-                                return kSuccess;
-                        }
-
-                        err = mul_gmp_gmp(detail::conv_64_to_gmp320(m_i64), m_scale,
-                                          detail::conv_128_to_gmp320(rhs.m_i128), rhs.m_scale);
-                        __BIGNUM_ASSERT(!err);
-                        return kSuccess;
-
-                } else if (rhs.m_dtype == DType::kGmp) {
-                        return mul_gmp_gmp(detail::conv_64_to_gmp320(m_i64), m_scale, rhs.m_gmp,
-                                           rhs.m_scale);
-
-                } else {
-                        __BIGNUM_ASSERT(false);
-                        return kError;
-                }
-        } else if (m_dtype == DType::kInt128) {
-                if (rhs.m_dtype == DType::kInt64) {
-                        err = mul_i128_i128(m_i128, m_scale, static_cast<__int128_t>(rhs.m_i64),
-                                            rhs.m_scale);
-                        if (!err) {
-                                return kSuccess;
-                        }
-
-                        err = mul_gmp_gmp(detail::conv_128_to_gmp320(m_i128), m_scale,
-                                          detail::conv_64_to_gmp320(rhs.m_i64), rhs.m_scale);
-                        __BIGNUM_ASSERT(!err);
-                        return kSuccess;
-
-                } else if (rhs.m_dtype == DType::kInt128) {
-                        err = mul_i128_i128(m_i128, m_scale, rhs.m_i128, rhs.m_scale);
-                        if (!err) {
-                                return kSuccess;
-                        }
-
-                        err = mul_gmp_gmp(detail::conv_128_to_gmp320(m_i128), m_scale,
-                                          detail::conv_128_to_gmp320(rhs.m_i128), rhs.m_scale);
-                        __BIGNUM_ASSERT(!err);
-                        return err;
-
-                } else if (rhs.m_dtype == DType::kGmp) {
-                        return mul_gmp_gmp(detail::conv_128_to_gmp320(m_i128), m_scale, rhs.m_gmp,
-                                           rhs.m_scale);
+        if (m_dtype == DType::kInt64 && rhs.m_dtype == DType::kInt64) {
+                return mul_kernel<kMode, DType::kInt64, DType::kInt64>(rhs, max_scale);
+        }
+        return dispatch(rhs, [&](auto l, auto r) {
+                return mul_kernel<kMode, decltype(l)::value, decltype(r)::value>(rhs, max_scale);
+        });
+}
 
-                } else {
-                        __BIGNUM_ASSERT(false);
+template <typename T>
+template <RoundingMode kMode>
+constexpr inline ErrCode DecimalImpl<T>::div_i128_i128(__int128_t l128, __int128_t r128,
+                                                       int32_t exp, int32_t res_scale) noexcept {
+        if (exp < -detail::kMaxInt128Power10 || exp > detail::kMaxInt128Power10) {
+                return kError;
+        }
+        const bool negative = (l128 < 0) != (r128 < 0);
+        __uint128_t n = l128 < 0 ? ~static_cast<__uint128_t>(l128) + 1 : l128;
+        __uint128_t d = r128 < 0 ? ~static_cast<__uint128_t>(r128) + 1 : r128;
+        if (exp >= 0) {
+                if (__builtin_mul_overflow(n, static_cast<__uint128_t>(detail::kInt128Power10[exp]),
+                                           &n)) {
                         return kError;
                 }
-        } else if (m_dtype == DType::kGmp) {
-                if (rhs.m_dtype == DType::kInt64) {
-                        return mul_gmp_gmp(m_gmp, m_scale, detail::conv_64_to_gmp320(rhs.m_i64),
-                                           rhs.m_scale);
-
-                } else if (rhs.m_dtype == DType::kInt128) {
-                        return mul_gmp_gmp(m_gmp, m_scale, detail::conv_128_to_gmp320(rhs.m_i128),
-                                           rhs.m_scale);
-
-                } else if (rhs.m_dtype == DType::kGmp) {
-                        return mul_gmp_gmp(m_gmp, m_scale, rhs.m_gmp, rhs.m_scale);
+        } else if (__builtin_mul_overflow(
+                           d, static_cast<__uint128_t>(detail::kInt128Power10[-exp]), &d)) {
+                return kError;
+        }
 
-                } else {
-                        __BIGNUM_ASSERT(false);
-                        return kError;
-                }
+        __uint128_t q = 0;
+        bool inexact = false;
+        if ((n >> 64) == 0) {
+                // Most quotients of int64 values with a small scale, where a 64-bit division is
+                // several times faster than a 128-bit one.
+                const uint64_t n64 = static_cast<uint64_t>(n);
+                const uint64_t d64 = static_cast<uint64_t>(d);
+                q = d > n ? 0 : n64 / d64;
+                inexact = d > n ? n64 != 0 : n64 % d64 != 0;
         } else {
-                __BIGNUM_ASSERT(false);
-                return kError;
+                q = n / d;
+                inexact = n % d != 0;
         }
-        return kError;
+
+        // Drop the extra digit, which is < 10 and thus the remainder to round on.
+        const uint64_t digit = static_cast<uint64_t>(q % 10);
+        q /= 10;
+        q += detail::round_away<kMode>(negative, digit, 5, inexact, q & 1);
+
+        // |q| < 2^128 / 10, so negating never overflows.
+        store_int128(negative ? -static_cast<__int128_t>(q) : static_cast<__int128_t>(q));
+        m_scale = res_scale;
+        return kSuccess;
 }
 
 template <typename T>
-constexpr inline ErrCode DecimalImpl<T>::div(const DecimalImpl<T> &rhs) noexcept {
+template <RoundingMode kMode>
+constexpr inline ErrCode DecimalImpl<T>::div_impl(const DecimalImpl<T> &rhs,
+                                                  const DecimalContext &context) noexcept {
+        if (any_poisoned(rhs)) {
+                return propagate_poison(rhs);
+        }
         sanity_check();
         rhs.sanity_check();
+        detail::count_decimal_op(DecimalStats::kDiv, dispatch_tier(rhs));
 
-        // Division only have 1 case of result in our implementation: div by zero.
-        // However, the intermediate calculation might overflow.
+        // calculation algorithm:
+        //    res_scale = min(max_scale, lscale + div_increase_scale)
+        //    res = |l| * 10 ^ (rscale + res_scale - lscale + 1) // |r|
+        //    res = round(res / 10)
+        // where the extra digit (and whether the division is exact) decides the rounding. The
+        // exponent is only negative if lscale > max_scale, in which case |r| is scaled up instead.
         //
-        // Since div is slow enough even using primitive type, we could just use GMP
-        // for all cases and shrink the result after calculation.
+        // Only the digits of the result scale are computed, so that with a small max scale,
+        // most quotients of int64 and int128 values are computed in int128, without gmp.
+        const int32_t lscale = m_scale;
+        const int32_t rscale = rhs.m_scale;
+        const int32_t res_scale =
+                detail::constexpr_min(context.max_scale, lscale + context.div_increase_scale);
+        const int32_t exp = rscale + res_scale - lscale + 1;
+
+        if (m_dtype <= DType::kInt128 && rhs.m_dtype <= DType::kInt128) {
+                const __int128_t l128 = m_dtype == DType::kInt64 ? m_i64 : m_i128;
+                const __int128_t r128 = rhs.m_dtype == DType::kInt64 ? rhs.m_i64 : rhs.m_i128;
+                if (r128 == 0) {
+                        return kDivByZero;
+                } else if (l128 == 0) {
+                        m_scale = 0;
+                        set_dtype(DType::kInt64);
+                        m_i64 = 0;
+                        return kSuccess;
+                }
+                if (!div_i128_i128<kMode>(l128, r128, exp, res_scale)) {
+                        return kSuccess;
+                }
+        }
+
+        // Division is slow enough even using primitive types, so the rest are done in gmp.
         detail::Gmp320 l320;
-        int32_t lscale = m_scale;
         if (m_dtype == DType::kInt64) {
                 l320 = detail::conv_64_to_gmp320(m_i64);
         } else if (m_dtype == DType::kInt128) {
                 l320 = detail::conv_128_to_gmp320(m_i128);
+        } else if (m_dtype == DType::kInt256) {
+                l320 = detail::conv_256_to_gmp320(m_i256);
         } else if (m_dtype == DType::kGmp) {
                 l320 = m_gmp;
         } else {
@@ -2164,11 +3480,12 @@ constexpr inline ErrCode DecimalImpl<T>::div(const DecimalImpl<T> &rhs) noexcept
         }
 
         detail::Gmp320 r320;
-        int32_t rscale = rhs.m_scale;
         if (rhs.m_dtype == DType::kInt64) {
                 r320 = detail::conv_64_to_gmp320(rhs.m_i64);
         } else if (rhs.m_dtype == DType::kInt128) {
                 r320 = detail::conv_128_to_gmp320(rhs.m_i128);
+        } else if (rhs.m_dtype == DType::kInt256) {
+                r320 = detail::conv_256_to_gmp320(rhs.m_i256);
         } else if (rhs.m_dtype == DType::kGmp) {
                 r320 = rhs.m_gmp;
         } else {
@@ -2180,7 +3497,7 @@ constexpr inline ErrCode DecimalImpl<T>::div(const DecimalImpl<T> &rhs) noexcept
                 return kDivByZero;
         } else if (l320.is_zero()) {
                 m_scale = 0;
-                m_dtype = DType::kInt64;
+                set_dtype(DType::kInt64);
                 m_i64 = 0;
                 return kSuccess;
         }
@@ -2193,45 +3510,32 @@ constexpr inline ErrCode DecimalImpl<T>::div(const DecimalImpl<T> &rhs) noexcept
 
         bool result_negative = (l_negative != r_negative);
 
-        // calculation algorithm:
-        //    newl = (l320 * 10 ^ (rscale + kDecimalDivIncrScale + 1))
-        //    res640 = newl // rhs
-        //    remainder = res640 % 10
-        //    res640 /= 10
-        //    if (remainder >= 5) {
-        //      if (res640 < 0) {
-        //         res640 -= 1
-        //      } else {
-        //         res640 += 1
-        //      }
-        //    }
-        //    res_scale = lscale + kDecimalDivIncrScale
-        const detail::Gmp320 mul_rhs =
-                detail::get_gmp320_power10(rscale + detail::kDecimalDivIncrScale + 1);
-        detail::Gmp640 newl;
-        mpz_mul(&newl.mpz, &l320.mpz, &mul_rhs.mpz);
+        // At most 96 + 61 digits, or 96 + 29 digits for the divisor
+        detail::Gmp640 scaled;
+        mpz_srcptr num = &l320.mpz;
+        mpz_srcptr den = &r320.mpz;
+        if (exp >= 0) {
+                mpz_mul(&scaled.mpz, &l320.mpz, &detail::get_gmp320_power10(exp).mpz);
+                num = &scaled.mpz;
+        } else {
+                mpz_mul(&scaled.mpz, &r320.mpz, &detail::get_gmp320_power10(-exp).mpz);
+                den = &scaled.mpz;
+        }
 
         detail::Gmp640 res640;
-        mpz_tdiv_q(&res640.mpz, &newl.mpz, &r320.mpz);
-
-        if (lscale + detail::kDecimalDivIncrScale > detail::kDecimalMaxScale) {
-                int trim_scale = lscale + detail::kDecimalDivIncrScale - detail::kDecimalMaxScale;
-                detail::Gmp640 tmp;
-                detail::Gmp320 trim_scale_pow320 = detail::get_gmp320_power10(trim_scale);
-                mpz_tdiv_q(&tmp.mpz, &res640.mpz, &trim_scale_pow320.mpz);
-                res640 = tmp;
+        // Half up only looks at the extra digit. The other modes also need to know whether the
+        // quotient is exact, e.g., to round 0.3333...3 up with kCeiling.
+        bool inexact = false;
+        if constexpr (kMode == RoundingMode::kHalfUp) {
+                mpz_tdiv_q(&res640.mpz, num, den);
+        } else {
+                detail::Gmp640 rem640;
+                mpz_tdiv_qr(&res640.mpz, &rem640.mpz, num, den);
+                inexact = !rem640.is_zero();
         }
 
-        detail::Gmp320 remainder;
-        mpz_tdiv_r_ui(&remainder.mpz, &res640.mpz, 10);
-
-        detail::Gmp640 tmp;
-        mpz_tdiv_q_ui(&tmp.mpz, &res640.mpz, 10);
-        res640 = tmp;
-
-        if (mpz_cmp_ui(&remainder.mpz, 5) >= 0) {
-                mpz_add_ui(&res640.mpz, &res640.mpz, 1);
-        }
+        res640.mpz._mp_size = detail::scale_down_limbs<kMode>(
+                res640.limbs, res640.mpz._mp_size, 1, result_negative, inexact);
 
         if (result_negative) {
                 res640.negate();
@@ -2242,9 +3546,8 @@ constexpr inline ErrCode DecimalImpl<T>::div(const DecimalImpl<T> &rhs) noexcept
                 return kDecimalMulOverflow;
         }
 
-        store_gmp_value(res640);
-        m_scale = detail::constexpr_min(detail::kDecimalMaxScale,
-                                        lscale + detail::kDecimalDivIncrScale);
+        store_gmp_result(res640);
+        m_scale = res_scale;
         sanity_check();
         return kSuccess;
 }
@@ -2253,16 +3556,62 @@ constexpr inline ErrCode DecimalImpl<T>::div(const DecimalImpl<T> &rhs) noexcept
 //   Suppose M is negative number, N is positive or negative, then we have:
 //       M % N = M % abs(N) = - (-M % abs(N))
 template <typename T>
-constexpr inline ErrCode DecimalImpl<T>::mod(const DecimalImpl<T> &rhs) noexcept {
+template <bool kFloor>
+constexpr inline ErrCode DecimalImpl<T>::divmod_impl(const DecimalImpl<T> &rhs,
+                                                     DecimalImpl<T> *quotient,
+                                                     DecimalImpl<T> *remainder) const noexcept {
         sanity_check();
         rhs.sanity_check();
+        // Both sides are aligned to the larger scale, so that the quotient is an integer and the
+        // remainder has that scale.
+        const int32_t scale = std::max(m_scale, rhs.m_scale);
+
+        if (m_dtype <= DType::kInt128 && rhs.m_dtype <= DType::kInt128) {
+                __int128_t l = m_dtype == DType::kInt64 ? m_i64 : m_i128;
+                __int128_t r = rhs.m_dtype == DType::kInt64 ? rhs.m_i64 : rhs.m_i128;
+                if (r == 0) {
+                        return kDivByZero;
+                }
+                if (!__builtin_mul_overflow(l, detail::kInt128Power10[scale - m_scale], &l) &&
+                    !__builtin_mul_overflow(r, detail::kInt128Power10[scale - rhs.m_scale], &r) &&
+                    (l != detail::kInt128Min || r != -1)) {
+                        __int128_t q = 0;
+                        __int128_t rem = 0;
+                        // A 64 bits division is several times faster than a 128 bits one.
+                        if (l > INT64_MIN && l <= INT64_MAX && r >= INT64_MIN && r <= INT64_MAX) {
+                                const int64_t l64 = static_cast<int64_t>(l);
+                                const int64_t r64 = static_cast<int64_t>(r);
+                                q = l64 / r64;
+                                rem = l64 % r64;
+                        } else {
+                                q = l / r;
+                                rem = l % r;
+                        }
+                        if (kFloor && rem != 0 && (rem < 0) != (r < 0)) {
+                                --q;
+                                rem += r;
+                        }
+                        // All reads are done, quotient and remainder might be *this or rhs.
+                        const int32_t rem_scale = l == 0 ? 0 : scale;
+                        if (quotient != nullptr) {
+                                quotient->store_int128(q);
+                                quotient->m_scale = 0;
+                        }
+                        if (remainder != nullptr) {
+                                remainder->store_int128(rem);
+                                remainder->m_scale = rem_scale;
+                        }
+                        return kSuccess;
+                }
+        }
 
         detail::Gmp640 l640;
-        int32_t lscale = m_scale;
         if (m_dtype == DType::kInt64) {
                 l640 = detail::conv_64_to_gmp640(m_i64);
         } else if (m_dtype == DType::kInt128) {
                 l640 = detail::conv_128_to_gmp640(m_i128);
+        } else if (m_dtype == DType::kInt256) {
+                l640 = detail::conv_256_to_gmp640(m_i256);
         } else if (m_dtype == DType::kGmp) {
                 detail::copy_gmp_to_gmp(l640, m_gmp);
         } else {
@@ -2271,11 +3620,12 @@ constexpr inline ErrCode DecimalImpl<T>::mod(const DecimalImpl<T> &rhs) noexcept
         }
 
         detail::Gmp640 r640;
-        int32_t rscale = rhs.m_scale;
         if (rhs.m_dtype == DType::kInt64) {
                 r640 = detail::conv_64_to_gmp640(rhs.m_i64);
         } else if (rhs.m_dtype == DType::kInt128) {
                 r640 = detail::conv_128_to_gmp640(rhs.m_i128);
+        } else if (rhs.m_dtype == DType::kInt256) {
+                r640 = detail::conv_256_to_gmp640(rhs.m_i256);
         } else if (rhs.m_dtype == DType::kGmp) {
                 detail::copy_gmp_to_gmp(r640, rhs.m_gmp);
         } else {
@@ -2285,57 +3635,87 @@ constexpr inline ErrCode DecimalImpl<T>::mod(const DecimalImpl<T> &rhs) noexcept
 
         if (r640.is_zero()) {
                 return kDivByZero;
-        } else if (l640.is_zero()) {
-                m_scale = 0;
-                m_dtype = DType::kInt64;
-                m_i64 = 0;
-                return kSuccess;
         }
-
-        bool l_negative = l640.is_negative();
-        l640.mpz._mp_size = detail::constexpr_abs(l640.mpz._mp_size);
-
-        // Always mod by posititve number, i.e.,
-        // If rhs is negative, we need to calculate -l640 % abs(r640)
-        r640.mpz._mp_size = detail::constexpr_abs(r640.mpz._mp_size);
+        const bool l_zero = l640.is_zero();
 
         // First align the scale of two numbers
-        if (lscale < rscale) {
-                const detail::Gmp320 mul_lhs = detail::get_gmp320_power10(rscale - lscale);
+        if (m_scale < scale) {
+                const detail::Gmp320 &mul_lhs = detail::get_gmp320_power10(scale - m_scale);
                 mpz_mul(&l640.mpz, &l640.mpz, &mul_lhs.mpz);
-                lscale = rscale;
-        } else if (lscale > rscale) {
-                const detail::Gmp320 mul_rhs = detail::get_gmp320_power10(lscale - rscale);
+        } else if (rhs.m_scale < scale) {
+                const detail::Gmp320 &mul_rhs = detail::get_gmp320_power10(scale - rhs.m_scale);
                 mpz_mul(&r640.mpz, &r640.mpz, &mul_rhs.mpz);
-                rscale = lscale;
         }
 
-        // Get the exact divide result (no fractional part)
-        detail::Gmp640 quotient;
-        mpz_tdiv_q(&quotient.mpz, &l640.mpz, &r640.mpz);
-
-        // remainder is l640 - quotient * r640
-        detail::Gmp640 qr;
-        mpz_mul(&qr.mpz, &quotient.mpz, &r640.mpz);
-
-        detail::Gmp640 remainder;
-        mpz_sub(&remainder.mpz, &l640.mpz, &qr.mpz);
-
-        if (l_negative) {
-                remainder.negate();
+        // A single division for both, the quotient is truncated and the remainder has the sign
+        // of the dividend.
+        detail::Gmp640 q640;
+        detail::Gmp640 rem640;
+        mpz_tdiv_qr(&q640.mpz, &rem640.mpz, &l640.mpz, &r640.mpz);
+        if (kFloor && !rem640.is_zero() && rem640.is_negative() != r640.is_negative()) {
+                mpz_sub_ui(&q640.mpz, &q640.mpz, 1);
+                // The floored remainder might not fit into 96 digits when the divisor was scaled
+                // up, e.g., for 0.001 div_floor -10^94, so it is only calculated if asked for.
+                if (remainder != nullptr) {
+                        mpz_add(&rem640.mpz, &rem640.mpz, &r640.mpz);
+                }
         }
 
-        store_gmp_value(remainder);
-        m_scale = lscale;
-
 #ifndef NDEBUG
-        __BIGNUM_ASSERT(!detail::check_gmp_out_of_range(remainder, detail::kMin96DigitsGmpValue,
+        __BIGNUM_ASSERT(remainder == nullptr ||
+                        !detail::check_gmp_out_of_range(rem640, detail::kMin96DigitsGmpValue,
                                                         detail::kMax96DigitsGmpValue));
 #endif
+        if (quotient != nullptr &&
+            detail::check_gmp_out_of_range(q640, detail::kMin96DigitsGmpValue,
+                                           detail::kMax96DigitsGmpValue)) {
+                return kDecimalDivOverflow;
+        }
 
+        if (quotient != nullptr) {
+                quotient->store_gmp_result(q640);
+                quotient->m_scale = 0;
+        }
+        if (remainder != nullptr) {
+                remainder->store_gmp_result(rem640);
+                remainder->m_scale = l_zero ? 0 : scale;
+        }
         return kSuccess;
 }
 
+template <typename T>
+constexpr inline ErrCode DecimalImpl<T>::mod(const DecimalImpl<T> &rhs) noexcept {
+        if (any_poisoned(rhs)) {
+                return propagate_poison(rhs);
+        }
+        detail::count_decimal_op(DecimalStats::kMod, dispatch_tier(rhs));
+        return divmod_impl<false>(rhs, nullptr, this);
+}
+
+template <typename T>
+constexpr inline ErrCode DecimalImpl<T>::divmod(const DecimalImpl<T> &rhs,
+                                                DecimalImpl<T> &quotient,
+                                                DecimalImpl<T> &remainder) const noexcept {
+        __BIGNUM_ASSERT(&quotient != &remainder);
+        if (any_poisoned(rhs)) {
+                const ErrCode err = is_poisoned() ? get_error() : rhs.get_error();
+                quotient.poison(err);
+                remainder.poison(err);
+                return err;
+        }
+        detail::count_decimal_op(DecimalStats::kMod, dispatch_tier(rhs));
+        return divmod_impl<false>(rhs, &quotient, &remainder);
+}
+
+template <typename T>
+constexpr inline ErrCode DecimalImpl<T>::div_floor(const DecimalImpl<T> &rhs) noexcept {
+        if (any_poisoned(rhs)) {
+                return propagate_poison(rhs);
+        }
+        detail::count_decimal_op(DecimalStats::kDiv, dispatch_tier(rhs));
+        return divmod_impl<true>(rhs, this, nullptr);
+}
+
 template <typename T>
 constexpr inline int DecimalImpl<T>::cmp_i64_i64(int64_t l64, int32_t lscale, int64_t r64,
                                                  int32_t rscale) const {
@@ -2350,7 +3730,8 @@ constexpr inline int DecimalImpl<T>::cmp_i64_i64(int64_t l64, int32_t lscale, in
         } else if (rscale > lscale) {
                 int32_t scale_diff = rscale - lscale;
                 int64_t newl = 0;
-                if (!detail::safe_mul(newl, l64, detail::get_int64_power10(scale_diff))) {
+                if (scale_diff < detail::kMaxUint64Power10 &&
+                    !detail::safe_mul(newl, l64, detail::get_int64_power10(scale_diff))) {
                         return detail::cmp_integral(newl, r64);
                 }
 
@@ -2362,13 +3743,17 @@ constexpr inline int DecimalImpl<T>::cmp_i64_i64(int64_t l64, int32_t lscale, in
                 }
 
                 // otherwise, simply divide the one with larger scale by 10^diff, and compare again.
-                int64_t newr = r64 / detail::get_int64_power10(scale_diff);
+                // 10^19 and above do not fit into int64, but are larger than any int64 anyway.
+                int64_t newr = scale_diff < detail::kMaxUint64Power10
+                                       ? r64 / detail::get_int64_power10(scale_diff)
+                                       : 0;
                 return detail::cmp_integral_with_delta(l64, newr, /*lr_delta*/ 1);
         } else {
                 assert(rscale < lscale);
                 int32_t scale_diff = lscale - rscale;
                 int64_t newr = 0;
-                if (!detail::safe_mul(newr, r64, detail::get_int64_power10(scale_diff))) {
+                if (scale_diff < detail::kMaxUint64Power10 &&
+                    !detail::safe_mul(newr, r64, detail::get_int64_power10(scale_diff))) {
                         return detail::cmp_integral(l64, newr);
                 }
 
@@ -2380,7 +3765,9 @@ constexpr inline int DecimalImpl<T>::cmp_i64_i64(int64_t l64, int32_t lscale, in
                 }
 
                 // otherwise, simply divide the one with larger scale by 10^diff, and compare again.
-                int64_t newl = l64 / detail::get_int64_power10(scale_diff);
+                int64_t newl = scale_diff < detail::kMaxUint64Power10
+                                       ? l64 / detail::get_int64_power10(scale_diff)
+                                       : 0;
                 return detail::cmp_integral_with_delta(newl, r64, /*lr_delta*/ 0);
         }
 
@@ -2421,6 +3808,49 @@ constexpr inline int DecimalImpl<T>::cmp_i128_i128(__int128_t l128, int32_t lsca
         }
 }
 
+template <typename T>
+constexpr inline int DecimalImpl<T>::cmp_i256_i256(const detail::Int256 &l256, int32_t lscale,
+                                                   const detail::Int256 &r256,
+                                                   int32_t rscale) const {
+        if (l256.is_negative() && !r256.is_negative()) {
+                return -1;
+        } else if (!l256.is_negative() && r256.is_negative()) {
+                return 1;
+        }
+
+        if (lscale == rscale) {
+                return detail::cmp_int256(l256, r256);
+        } else if (rscale > lscale) {
+                // Same as cmp_i128_i128(): scale up l256, or scale down r256 on overflow.
+                detail::Int256 newl;
+                if (!detail::safe_mul(newl, l256, detail::get_int256_power10(rscale - lscale))) {
+                        return detail::cmp_int256(newl, r256);
+                }
+
+                detail::Int256 newr = detail::div_power10(r256, rscale - lscale);
+                int res = detail::cmp_int256(l256, newr);
+                if (res == 0) {
+                        // r256 has delta value
+                        return l256.is_negative() ? 1 : -1;
+                }
+                return res;
+        } else {
+                assert(rscale < lscale);
+                detail::Int256 newr;
+                if (!detail::safe_mul(newr, r256, detail::get_int256_power10(lscale - rscale))) {
+                        return detail::cmp_int256(l256, newr);
+                }
+
+                detail::Int256 newl = detail::div_power10(l256, lscale - rscale);
+                int res = detail::cmp_int256(newl, r256);
+                if (res == 0) {
+                        // l256 has delta value
+                        return l256.is_negative() ? -1 : 1;
+                }
+                return res;
+        }
+}
+
 template <typename T>
 constexpr inline int DecimalImpl<T>::cmp_gmp_gmp(const detail::Gmp320 &l320, int32_t lscale,
                                                  const detail::Gmp320 &r320, int32_t rscale) const {
@@ -2434,14 +3864,16 @@ constexpr inline int DecimalImpl<T>::cmp_gmp_gmp(const detail::Gmp320 &l320, int
                 return detail::cmp_gmp(l320, r320);
         } else if (rscale > lscale) {
                 detail::Gmp640 newl;
-                detail::Gmp320 delta_scale_pow320 = detail::get_gmp320_power10(rscale - lscale);
+                const detail::Gmp320 &delta_scale_pow320 =
+                        detail::get_gmp320_power10(rscale - lscale);
                 mpz_mul(&newl.mpz, &l320.mpz, &(delta_scale_pow320.mpz));
 
                 return detail::cmp_gmp(newl, r320);
         } else {
                 assert(rscale < lscale);
                 detail::Gmp640 newr;
-                detail::Gmp320 delta_scale_pow320 = detail::get_gmp320_power10(lscale - rscale);
+                const detail::Gmp320 &delta_scale_pow320 =
+                        detail::get_gmp320_power10(lscale - rscale);
                 mpz_mul(&newr.mpz, &r320.mpz, &(delta_scale_pow320.mpz));
 
                 return detail::cmp_gmp(l320, newr);
@@ -2459,47 +3891,9 @@ constexpr inline int DecimalImpl<T>::cmp(const DecimalImpl &rhs) const {
                 return 1;
         }
 
-        int res = 0;
-        if (m_dtype == DType::kInt64) {
-                if (rhs.m_dtype == DType::kInt64) {
-                        res = cmp_i64_i64(m_i64, m_scale, rhs.m_i64, rhs.m_scale);
-                } else if (rhs.m_dtype == DType::kInt128) {
-                        res = cmp_i128_i128(static_cast<__int128_t>(m_i64), m_scale, rhs.m_i128,
-                                            rhs.m_scale);
-                } else if (rhs.m_dtype == DType::kGmp) {
-                        res = cmp_gmp_gmp(detail::conv_64_to_gmp320(m_i64), m_scale, rhs.m_gmp,
-                                          rhs.m_scale);
-                } else {
-                        __BIGNUM_ASSERT(false);
-                }
-        } else if (m_dtype == DType::kInt128) {
-                if (rhs.m_dtype == DType::kInt64) {
-                        res = cmp_i128_i128(m_i128, m_scale, static_cast<__int128_t>(rhs.m_i64),
-                                            rhs.m_scale);
-                } else if (rhs.m_dtype == DType::kInt128) {
-                        res = cmp_i128_i128(m_i128, m_scale, rhs.m_i128, rhs.m_scale);
-                } else if (rhs.m_dtype == DType::kGmp) {
-                        res = cmp_gmp_gmp(detail::conv_128_to_gmp320(m_i128), m_scale, rhs.m_gmp,
-                                          rhs.m_scale);
-                } else {
-                        __BIGNUM_ASSERT(false);
-                }
-        } else if (m_dtype == DType::kGmp) {
-                if (rhs.m_dtype == DType::kInt64) {
-                        res = cmp_gmp_gmp(m_gmp, m_scale, detail::conv_64_to_gmp320(rhs.m_i64),
-                                          rhs.m_scale);
-                } else if (rhs.m_dtype == DType::kInt128) {
-                        res = cmp_gmp_gmp(m_gmp, m_scale, detail::conv_128_to_gmp320(rhs.m_i128),
-                                          rhs.m_scale);
-                } else if (rhs.m_dtype == DType::kGmp) {
-                        res = cmp_gmp_gmp(m_gmp, m_scale, rhs.m_gmp, rhs.m_scale);
-                } else {
-                        __BIGNUM_ASSERT(false);
-                }
-        } else {
-                __BIGNUM_ASSERT(false);
-        }
-        return res;
+        return dispatch(rhs, [&](auto l, auto r) {
+                return cmp_kernel<decltype(l)::value, decltype(r)::value>(rhs);
+        });
 }
 
 template <typename T>
@@ -2508,23 +3902,59 @@ constexpr inline void DecimalImpl<T>::convert_internal_representation_to_gmp() n
                 store_gmp_value(detail::conv_64_to_gmp320(m_i64));
         } else if (m_dtype == DType::kInt128) {
                 store_gmp_value(detail::conv_128_to_gmp320(m_i128));
+        } else if (m_dtype == DType::kInt256) {
+                store_gmp_value(detail::conv_256_to_gmp320(m_i256));
+        }
+}
+
+template <typename T>
+constexpr inline detail::Gmp320 DecimalImpl<T>::get_gmp320() const {
+        if (m_dtype == DType::kInt64) {
+                return detail::conv_64_to_gmp320(m_i64);
+        } else if (m_dtype == DType::kInt128) {
+                return detail::conv_128_to_gmp320(m_i128);
+        } else if (m_dtype == DType::kInt256) {
+                return detail::conv_256_to_gmp320(m_i256);
+        } else {
+                assert(m_dtype == DType::kGmp);
+                return m_gmp;
         }
 }
 
 template <typename T>
 constexpr inline bool DecimalImpl<T>::operator==(const DecimalImpl<T> &rhs) const {
+        if (any_poisoned(rhs)) {
+                return false;
+        }
+        // Equal values have the same digits once trailing zeros are removed. The cached metadata
+        // tells whether they do without scaling either side. Zero has no such digits.
+        if (m_scale != rhs.m_scale && has_cached_meta() && rhs.has_cached_meta() && to_bool()) {
+                const int32_t zeros = load_meta(m_trailing_zeros);
+                const int32_t rhs_zeros = load_meta(rhs.m_trailing_zeros);
+                if (load_meta(m_precision) - zeros != load_meta(rhs.m_precision) - rhs_zeros ||
+                    m_scale - zeros != rhs.m_scale - rhs_zeros) {
+                        return false;
+                }
+        }
+
         int res = cmp(rhs);
         return res == 0;
 }
 
 template <typename T>
 constexpr inline bool DecimalImpl<T>::operator<(const DecimalImpl<T> &rhs) const {
+        if (any_poisoned(rhs)) {
+                return false;
+        }
         int res = cmp(rhs);
         return res < 0;
 }
 
 template <typename T>
 constexpr inline bool DecimalImpl<T>::operator<=(const DecimalImpl<T> &rhs) const {
+        if (any_poisoned(rhs)) {
+                return false;
+        }
         int res = cmp(rhs);
         return res <= 0;
 }
@@ -2534,8 +3964,19 @@ constexpr inline void DecimalImpl<T>::sanity_check() const {
 #ifndef NDEBUG
         __BIGNUM_ASSERT(m_scale >= 0 && m_scale <= detail::kDecimalMaxScale);
         __BIGNUM_ASSERT(m_dtype != DType::kGmp || m_gmp.ptr_check());
+        __BIGNUM_ASSERT(m_dtype != DType::kPoisoned, "Poisoned decimal");
 #endif
 }
+
+// Hash values[i] into hashes[i], e.g., to build the hash table of a hash join or GROUP BY on
+// decimal keys. `hashes` must be at least as large as `values`.
+inline void hash(std::span<const Decimal> values, std::span<uint64_t> hashes) noexcept {
+        __BIGNUM_ASSERT(hashes.size() >= values.size());
+        const size_t n = values.size();
+        for (size_t i = 0; i < n; ++i) {
+                hashes[i] = values[i].hash();
+        }
+}
 }  // namespace bignum
 
 namespace std {
@@ -2543,4 +3984,9 @@ inline ostream &operator<<(ostream &oss, bignum::Decimal const &d) {
         oss << static_cast<string>(d);
         return oss;
 }
+
+template <>
+struct hash<bignum::Decimal> {
+        size_t operator()(const bignum::Decimal &d) const noexcept { return d.hash(); }
+};
 }  // namespace std
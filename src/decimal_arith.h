@@ -0,0 +1,224 @@
+/*
+ * This file is part of bignum.
+ *
+ * bignum is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * bignum is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bignum.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2024-present  bignum developers
+ */
+#pragma once
+
+#include "decimal.h"
+#include "decimal_column.h"
+
+#include <algorithm>
+#include <span>
+#include <utility>
+
+namespace bignum {
+namespace detail {
+enum class ColumnOp : int32_t { kAdd = 0, kSub, kMul };
+
+// Scale of l op r, where a product is rounded to the max scale of the context.
+inline int32_t column_op_scale(ColumnOp op, int32_t lscale, int32_t rscale) {
+        if (op == ColumnOp::kMul) {
+                return std::min(lscale + rscale, current_decimal_context().max_scale);
+        }
+        return std::max(lscale, rscale);
+}
+
+// Bound of the payloads of l op r at the given scale, or -1 if either column has no bound or the
+// bound does not fit T.
+template <ColumnOp kOp, typename T>
+inline __int128_t column_op_bound(const DecimalColumnImpl<T> &l, const DecimalColumnImpl<T> &r,
+                                  int32_t scale) {
+        if (!l.has_bound() || !r.has_bound()) {
+                return -1;
+        }
+        const __int128_t lb = l.bound_scaled();
+        const __int128_t rb = r.bound_scaled();
+        __int128_t bound = 0;
+        if constexpr (kOp == ColumnOp::kMul) {
+                if (scale != l.get_scale() + r.get_scale() ||
+                    __builtin_mul_overflow(lb, rb, &bound)) {
+                        return -1;
+                }
+        } else {
+                __int128_t ls = 0;
+                __int128_t rs = 0;
+                if (__builtin_mul_overflow(lb, kInt128Power10[scale - l.get_scale()], &ls) ||
+                    __builtin_mul_overflow(rb, kInt128Power10[scale - r.get_scale()], &rs) ||
+                    __builtin_add_overflow(ls, rs, &bound)) {
+                        return -1;
+                }
+        }
+        return bound < DecimalColumnImpl<T>::kNoBound ? bound : -1;
+}
+
+// l op r of payloads without any overflow check, where lmul and rmul scale l and r up to the
+// scale of the result for addition and subtraction. Equal scales skip the multiplications, so
+// that the loop is plain SIMD additions.
+template <ColumnOp kOp, bool kScaled, typename T>
+inline void column_op_unchecked(const T *l, T lmul, const T *r, T rmul, std::span<T> out) {
+        for (size_t i = 0; i < out.size(); ++i) {
+                if constexpr (kOp == ColumnOp::kMul) {
+                        out[i] = l[i] * r[i];
+                } else if constexpr (kScaled) {
+                        out[i] = kOp == ColumnOp::kSub ? l[i] * lmul - r[i] * rmul
+                                                       : l[i] * lmul + r[i] * rmul;
+                } else {
+                        out[i] = kOp == ColumnOp::kSub ? l[i] - r[i] : l[i] + r[i];
+                }
+        }
+}
+
+// l op r of payloads as int128, scaling l and r up by 10^lexp and 10^rexp first for addition and
+// subtraction. Return false if it overflows.
+template <ColumnOp kOp, typename T>
+inline bool column_op_payload(T l, int32_t lexp, T r, int32_t rexp, __int128_t &x) {
+        __int128_t l128 = l;
+        __int128_t r128 = r;
+        if constexpr (kOp == ColumnOp::kMul) {
+                return !__builtin_mul_overflow(l128, r128, &x);
+        } else {
+                if (__builtin_mul_overflow(l128, kInt128Power10[lexp], &l128) ||
+                    __builtin_mul_overflow(r128, kInt128Power10[rexp], &r128)) {
+                        return false;
+                }
+                return kOp == ColumnOp::kSub ? !__builtin_sub_overflow(l128, r128, &x)
+                                             : !__builtin_add_overflow(l128, r128, &x);
+        }
+}
+
+// l op r of decimals, clamped to the min or max value if kSaturate.
+template <ColumnOp kOp, bool kSaturate>
+inline Decimal decimal_op(const Decimal &l, const Decimal &r) {
+        if constexpr (kSaturate) {
+                Decimal d = l;
+                if constexpr (kOp == ColumnOp::kAdd) {
+                        return d.add_saturating(r);
+                } else if constexpr (kOp == ColumnOp::kSub) {
+                        return d.sub_saturating(r);
+                } else {
+                        return d.mul_saturating(r);
+                }
+        } else if constexpr (kOp == ColumnOp::kAdd) {
+                return l + r;
+        } else if constexpr (kOp == ColumnOp::kSub) {
+                return l - r;
+        } else {
+                return l * r;
+        }
+}
+
+template <ColumnOp kOp, bool kSaturate, typename T>
+inline void column_op(const DecimalColumnImpl<T> &l, const DecimalColumnImpl<T> &r,
+                      DecimalColumnImpl<T> &result) {
+        __BIGNUM_CHECK_ERROR(l.size() == r.size(), "Decimal columns of different sizes");
+        const size_t n = l.size();
+        const int32_t scale = column_op_scale(kOp, l.get_scale(), r.get_scale());
+        const int32_t lexp = scale - l.get_scale();
+        const int32_t rexp = scale - r.get_scale();
+        const std::span<const T> lp = l.payload();
+        const std::span<const T> rp = r.payload();
+        // The result might be l or r.
+        DecimalColumnImpl<T> res(scale);
+
+        const __int128_t bound = column_op_bound<kOp>(l, r, scale);
+        if (bound >= 0) {
+                // Every value is in the payloads, and no result exceeds the bound.
+                res.set_bound_scaled(static_cast<T>(bound));
+                const std::span<T> out = res.append_payload(n);
+                if (kOp == ColumnOp::kMul || (lexp == 0 && rexp == 0)) {
+                        column_op_unchecked<kOp, false>(lp.data(), T{1}, rp.data(), T{1}, out);
+                } else {
+                        const T lmul = static_cast<T>(kInt128Power10[lexp]);
+                        const T rmul = static_cast<T>(kInt128Power10[rexp]);
+                        column_op_unchecked<kOp, true>(lp.data(), lmul, rp.data(), rmul, out);
+                }
+                res.check_payload();
+        } else {
+                res.reserve(n);
+                // Products beyond the max scale are rounded, which only Decimal does.
+                const bool exact = kOp != ColumnOp::kMul || scale == l.get_scale() + r.get_scale();
+                for (size_t i = 0; i < n; ++i) {
+                        __int128_t x = 0;
+                        if (exact && !l.is_wide(i) && !r.is_wide(i) &&
+                            column_op_payload<kOp>(lp[i], lexp, rp[i], rexp, x)) {
+                                res.push_back_scaled(x);
+                        } else {
+                                res.push_back(decimal_op<kOp, kSaturate>(l[i], r[i]));
+                        }
+                }
+        }
+        result = std::move(res);
+}
+}  // namespace detail
+
+//=-----------------------------------------------------------------------------
+// Element-wise arithmetic of two decimal columns of the same size, e.g., the amounts of orders
+// from the columns of prices and quantities. The result is replaced by a column of the scale of
+// the results, that is, the larger scale of l and r for add() and sub(), and the sum of both
+// (up to the max scale of the DecimalContext) for mul(). Overflows throw or assert, as with the
+// operators of Decimal, except for add_saturating(), sub_saturating() and mul_saturating(), which
+// clamp the results that overflow like Decimal::add_saturating() and so on.
+//
+// Payloads are computed in int128 with overflow checks, and only values in the side tables, or
+// results that overflow int128, go through Decimal. If both columns have a bound (see
+// DecimalColumnImpl::set_bound()), and the bound of the results fits into the payload, the
+// results could never overflow, so they are computed as plain integer operations on the payloads
+// without any check or branch, and the result column gets that bound:
+//
+//   DecimalColumn prices(4), quantities(0), amounts;
+//   prices.set_bound(Decimal(1000000));    // payloads up to 10^10
+//   quantities.set_bound(Decimal(100000));
+//   ...
+//   mul(prices, quantities, amounts);      // payloads up to 10^15, which fit into int64
+//=-----------------------------------------------------------------------------
+
+template <typename T>
+inline void add(const DecimalColumnImpl<T> &l, const DecimalColumnImpl<T> &r,
+                DecimalColumnImpl<T> &result) {
+        detail::column_op<detail::ColumnOp::kAdd, false>(l, r, result);
+}
+
+template <typename T>
+inline void sub(const DecimalColumnImpl<T> &l, const DecimalColumnImpl<T> &r,
+                DecimalColumnImpl<T> &result) {
+        detail::column_op<detail::ColumnOp::kSub, false>(l, r, result);
+}
+
+template <typename T>
+inline void mul(const DecimalColumnImpl<T> &l, const DecimalColumnImpl<T> &r,
+                DecimalColumnImpl<T> &result) {
+        detail::column_op<detail::ColumnOp::kMul, false>(l, r, result);
+}
+
+template <typename T>
+inline void add_saturating(const DecimalColumnImpl<T> &l, const DecimalColumnImpl<T> &r,
+                           DecimalColumnImpl<T> &result) {
+        detail::column_op<detail::ColumnOp::kAdd, true>(l, r, result);
+}
+
+template <typename T>
+inline void sub_saturating(const DecimalColumnImpl<T> &l, const DecimalColumnImpl<T> &r,
+                           DecimalColumnImpl<T> &result) {
+        detail::column_op<detail::ColumnOp::kSub, true>(l, r, result);
+}
+
+template <typename T>
+inline void mul_saturating(const DecimalColumnImpl<T> &l, const DecimalColumnImpl<T> &r,
+                           DecimalColumnImpl<T> &result) {
+        detail::column_op<detail::ColumnOp::kMul, true>(l, r, result);
+}
+}  // namespace bignum
@@ -0,0 +1,381 @@
+/*
+ * This file is part of bignum.
+ *
+ * bignum is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * bignum is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bignum.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2024-present  bignum developers
+ */
+#pragma once
+
+#include "decimal.h"
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
+namespace bignum {
+namespace detail {
+// A decimal in a single 16-byte word: a 122-bit signed payload in the lowest bits, the scale in
+// the next 5 bits, and the highest bit set if the value is in the wide tier instead.
+using AtomicWord = unsigned __int128;
+constexpr int32_t kAtomicPayloadBits = 122;
+constexpr int32_t kAtomicScaleBits = 5;
+constexpr AtomicWord kAtomicWideWord = static_cast<AtomicWord>(1) << 127;
+static_assert(kDecimalMaxScale < (1 << kAtomicScaleBits));
+
+// The word in memory, as two 8-byte halves so that either of them could be loaded on its own.
+struct alignas(16) AtomicWordStorage {
+        uint64_t halves[2] = {0, 0};
+};
+static_assert(sizeof(AtomicWordStorage) == sizeof(AtomicWord));
+
+constexpr inline bool atomic_payload_fits(__int128_t p) {
+        constexpr int32_t kShift = 128 - kAtomicPayloadBits;
+        return static_cast<__int128_t>(static_cast<AtomicWord>(p) << kShift) >> kShift == p;
+}
+
+constexpr inline AtomicWord pack_atomic_word(__int128_t p, int32_t scale) {
+        constexpr AtomicWord kPayloadMask = (static_cast<AtomicWord>(1) << kAtomicPayloadBits) - 1;
+        return (static_cast<AtomicWord>(p) & kPayloadMask) |
+               (static_cast<AtomicWord>(scale) << kAtomicPayloadBits);
+}
+
+constexpr inline __int128_t atomic_word_payload(AtomicWord w) {
+        constexpr int32_t kShift = 128 - kAtomicPayloadBits;
+        return static_cast<__int128_t>(w << kShift) >> kShift;
+}
+
+constexpr inline int32_t atomic_word_scale(AtomicWord w) {
+        return static_cast<int32_t>(w >> kAtomicPayloadBits) & ((1 << kAtomicScaleBits) - 1);
+}
+
+// Compare *word with expected and replace it with desired if they are equal, otherwise load it
+// into expected. A full barrier either way. This is cmpxchg16b on x86-64 without the need of
+// -mcx16 (with which GCC still calls libatomic for 16-byte atomics), and libatomic elsewhere.
+inline bool cas_atomic_word(AtomicWordStorage *word, AtomicWord &expected, AtomicWord desired) {
+#if defined(__x86_64__)
+        uint64_t lo = static_cast<uint64_t>(expected);
+        uint64_t hi = static_cast<uint64_t>(expected >> 64);
+        bool ok = false;
+        __asm__ __volatile__("lock cmpxchg16b %1"
+                             : "=@ccz"(ok), "+m"(*word), "+a"(lo), "+d"(hi)
+                             : "b"(static_cast<uint64_t>(desired)),
+                               "c"(static_cast<uint64_t>(desired >> 64))
+                             : "memory");
+        expected = (static_cast<AtomicWord>(hi) << 64) | lo;
+        return ok;
+#else
+        AtomicWordStorage e = std::bit_cast<AtomicWordStorage>(expected);
+        AtomicWordStorage d = std::bit_cast<AtomicWordStorage>(desired);
+        const bool ok = __atomic_compare_exchange(word, &e, &d, false, __ATOMIC_SEQ_CST,
+                                                  __ATOMIC_SEQ_CST);
+        expected = std::bit_cast<AtomicWord>(e);
+        return ok;
+#endif
+}
+
+// Spin-wait hint while the seqlock is taken.
+inline void cpu_relax() {
+#if defined(__x86_64__)
+        __builtin_ia32_pause();
+#endif
+}
+
+// An atomic load of the word, as a compare and swap that only ever writes back the same value.
+inline AtomicWord load_atomic_word(AtomicWordStorage *word) {
+        AtomicWord expected = 0;
+        cas_atomic_word(word, expected, 0);
+        return expected;
+}
+
+// The word as two 8-byte loads, which might be torn by a concurrent update. Good enough for the
+// value expected by a compare and swap, which fails and loads the word if it is wrong, and
+// cheaper than load_atomic_word().
+inline AtomicWord peek_atomic_word(const AtomicWordStorage *word) {
+        AtomicWordStorage w;
+        w.halves[0] = __atomic_load_n(&word->halves[0], __ATOMIC_RELAXED);
+        w.halves[1] = __atomic_load_n(&word->halves[1], __ATOMIC_RELAXED);
+        return std::bit_cast<AtomicWord>(w);
+}
+}  // namespace detail
+
+//=-----------------------------------------------------------------------------
+// A decimal that many threads could update concurrently without a mutex, e.g., running totals
+// such as the exposure of an account.
+//
+// Decimal itself could not be updated with a compare and swap, as it takes 64 bytes and points
+// into itself in the wide representation. AtomicDecimal keeps the payload and the scale in a
+// single 16-byte word instead, with a 122-bit payload that covers every int64 payload and int128
+// ones of up to 36 digits, and add(), sub(), fetch_add() and fetch_sub() are a compare and swap
+// loop on that word (cmpxchg16b on x86-64). Only a value beyond the payload moves to the wide
+// tier, which is a copy of its limbs under a seqlock: writers take turns, and readers retry if
+// a writer came in while they read. A value that fits the word again moves back, and the
+// updates are lock-free again.
+//
+// The scale of a result is the larger scale of both operands, as with Decimal::add(). Overflows
+// leave the value unchanged, and return the error or throw (or assert) as operator+= does.
+//
+//   AtomicDecimal exposure;
+//   // On any thread
+//   exposure.add(trade.amount());
+//   Decimal total = exposure.load();
+//=-----------------------------------------------------------------------------
+class AtomicDecimal final {
+       public:
+        AtomicDecimal() = default;
+        explicit AtomicDecimal(const Decimal &d) { store(d); }
+        AtomicDecimal(const AtomicDecimal &) = delete;
+        AtomicDecimal &operator=(const AtomicDecimal &) = delete;
+
+        Decimal load() const;
+        void store(const Decimal &d);
+
+        // Return kSuccess, or the error of an overflow or of a poisoned d, in which case the value
+        // is unchanged.
+        ErrCode add(const Decimal &d) noexcept { return update<false>(d, nullptr); }
+        ErrCode sub(const Decimal &d) noexcept { return update<true>(d, nullptr); }
+
+        // Return the value before the update.
+        Decimal fetch_add(const Decimal &d) {
+                Decimal previous;
+                ErrCode err = update<false>(d, &previous);
+                __BIGNUM_CHECK_ERROR(!err, "AtomicDecimal fetch_add err");
+                return previous;
+        }
+        Decimal fetch_sub(const Decimal &d) {
+                Decimal previous;
+                ErrCode err = update<true>(d, &previous);
+                __BIGNUM_CHECK_ERROR(!err, "AtomicDecimal fetch_sub err");
+                return previous;
+        }
+
+        // Whether the value is in the 16-byte word rather than in the wide tier, i.e., whether
+        // updates of it are lock-free. A snapshot only: a concurrent update might move the value
+        // to the wide tier or back right after. Unlike std::atomic<T>::is_lock_free(), this is
+        // not a property of the type.
+        bool is_narrow() const {
+                return detail::load_atomic_word(&m_word) != detail::kAtomicWideWord;
+        }
+
+       private:
+        constexpr static int32_t kNumLimbs = static_cast<int32_t>(detail::Gmp320::kNumLimbs);
+
+        // The payload of d if it fits into the word.
+        static bool get_payload(const Decimal &d, __int128_t &p);
+        static Decimal decode(detail::AtomicWord w);
+
+        template <bool kSub>
+        ErrCode update(const Decimal &d, Decimal *previous) noexcept;
+        template <bool kSub>
+        ErrCode update_locked(const Decimal &d, Decimal *previous) noexcept;
+
+        // The seqlock of the wide tier, where an odd sequence tells that a writer is in.
+        uint64_t lock() noexcept;
+        void unlock(uint64_t seq) noexcept { m_seq.store(seq + 2, std::memory_order_release); }
+        // The value of the wide tier. Without the lock, it is read again until no writer came in
+        // meanwhile.
+        Decimal read_wide(bool locked) const;
+        void write_wide(const Decimal &d);
+
+        // Mutable for the loads, which are compare and swaps as well.
+        mutable detail::AtomicWordStorage m_word;
+        std::atomic<uint64_t> m_seq = 0;
+        // The wide tier: the magnitude, its number of limbs (negative for a negative value) and
+        // the scale.
+        std::atomic<uint64_t> m_limbs[kNumLimbs] = {};
+        std::atomic<int32_t> m_size = 0;
+        std::atomic<int32_t> m_scale = 0;
+};
+
+inline bool AtomicDecimal::get_payload(const Decimal &d, __int128_t &p) {
+        if (d.m_dtype == Decimal::DType::kInt64) {
+                p = d.m_i64;
+                return true;
+        }
+        if (d.m_dtype == Decimal::DType::kInt128) {
+                p = d.m_i128;
+                return detail::atomic_payload_fits(p);
+        }
+        if (d.is_poisoned()) {
+                return false;
+        }
+        uint64_t limbs[kNumLimbs] = {0};
+        const int32_t n = d.get_magnitude(limbs);
+        if (n > 2) {
+                return false;
+        }
+        p = static_cast<__int128_t>((static_cast<__uint128_t>(limbs[1]) << 64) | limbs[0]);
+        if (p < 0 || !detail::atomic_payload_fits(p)) {
+                return false;
+        }
+        p = d.is_negative() ? -p : p;
+        return true;
+}
+
+inline Decimal AtomicDecimal::decode(detail::AtomicWord w) {
+        const __int128_t p = detail::atomic_word_payload(w);
+        Decimal d = p >= INT64_MIN && p <= INT64_MAX ? Decimal(static_cast<int64_t>(p))
+                                                     : Decimal(p);
+        d.m_scale = detail::atomic_word_scale(w);
+        return d;
+}
+
+inline Decimal AtomicDecimal::read_wide(bool locked) const {
+        uint64_t limbs[kNumLimbs + 1] = {0};
+        int32_t size = 0;
+        int32_t scale = 0;
+        while (true) {
+                const uint64_t seq = locked ? 0 : m_seq.load(std::memory_order_acquire);
+                if (seq & 1) {
+                        detail::cpu_relax();
+                        continue;
+                }
+                for (int32_t i = 0; i < kNumLimbs; ++i) {
+                        limbs[i] = m_limbs[i].load(std::memory_order_relaxed);
+                }
+                size = m_size.load(std::memory_order_relaxed);
+                scale = m_scale.load(std::memory_order_relaxed);
+                if (locked) {
+                        break;
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (m_seq.load(std::memory_order_relaxed) == seq) {
+                        break;
+                }
+        }
+        Decimal d;
+        d.store_magnitude(limbs, size < 0 ? -size : size, size < 0);
+        d.m_scale = scale;
+#ifdef BIGNUM_DEV_USE_GMP_ONLY
+        d.convert_internal_representation_to_gmp();
+#endif
+        return d;
+}
+
+inline void AtomicDecimal::write_wide(const Decimal &d) {
+        uint64_t limbs[kNumLimbs] = {0};
+        const int32_t n = d.get_magnitude(limbs);
+        for (int32_t i = 0; i < kNumLimbs; ++i) {
+                m_limbs[i].store(limbs[i], std::memory_order_relaxed);
+        }
+        m_size.store(d.is_negative() ? -n : n, std::memory_order_relaxed);
+        m_scale.store(d.get_scale(), std::memory_order_relaxed);
+}
+
+inline uint64_t AtomicDecimal::lock() noexcept {
+        uint64_t seq = m_seq.load(std::memory_order_relaxed);
+        while (true) {
+                if (seq & 1) {
+                        detail::cpu_relax();
+                        seq = m_seq.load(std::memory_order_relaxed);
+                } else if (m_seq.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire,
+                                                       std::memory_order_relaxed)) {
+                        // No write to the wide tier is seen before the odd sequence.
+                        std::atomic_thread_fence(std::memory_order_release);
+                        return seq;
+                }
+        }
+}
+
+inline Decimal AtomicDecimal::load() const {
+        const detail::AtomicWord w = detail::load_atomic_word(&m_word);
+        // The value might have left the wide tier since, but what the wide tier keeps was the
+        // value at some point after w was loaded.
+        return w == detail::kAtomicWideWord ? read_wide(false) : decode(w);
+}
+
+inline void AtomicDecimal::store(const Decimal &d) {
+        __BIGNUM_CHECK_ERROR(!d.is_poisoned(), "Storing a poisoned decimal into AtomicDecimal");
+        __int128_t p = 0;
+        const bool fits = get_payload(d, p);
+        const uint64_t seq = lock();
+        detail::AtomicWord w = detail::load_atomic_word(&m_word);
+        const detail::AtomicWord desired =
+                fits ? detail::pack_atomic_word(p, d.get_scale()) : detail::kAtomicWideWord;
+        while (!detail::cas_atomic_word(&m_word, w, desired)) {
+        }
+        // As in update_locked(), the wide tier is written after the word went wide.
+        if (!fits) {
+                write_wide(d);
+        }
+        unlock(seq);
+}
+
+template <bool kSub>
+inline ErrCode AtomicDecimal::update(const Decimal &d, Decimal *previous) noexcept {
+        __int128_t dp = 0;
+        if (!get_payload(d, dp)) {
+                return d.is_poisoned() ? d.get_error() : update_locked<kSub>(d, previous);
+        }
+        const int32_t dscale = d.get_scale();
+        detail::AtomicWord w = detail::peek_atomic_word(&m_word);
+        while (w != detail::kAtomicWideWord) {
+                const __int128_t p = detail::atomic_word_payload(w);
+                const int32_t scale = detail::atomic_word_scale(w);
+                const int32_t rscale = std::max(scale, dscale);
+                __int128_t l = 0;
+                __int128_t r = 0;
+                __int128_t x = 0;
+                if (__builtin_mul_overflow(p, detail::kInt128Power10[rscale - scale], &l) ||
+                    __builtin_mul_overflow(dp, detail::kInt128Power10[rscale - dscale], &r) ||
+                    (kSub ? __builtin_sub_overflow(l, r, &x) : __builtin_add_overflow(l, r, &x)) ||
+                    !detail::atomic_payload_fits(x)) {
+                        // The result goes to the wide tier, or overflows.
+                        return update_locked<kSub>(d, previous);
+                }
+                if (detail::cas_atomic_word(&m_word, w, detail::pack_atomic_word(x, rscale))) {
+                        if (previous != nullptr) {
+                                *previous = decode(w);
+                        }
+                        return kSuccess;
+                }
+        }
+        return update_locked<kSub>(d, previous);
+}
+
+template <bool kSub>
+inline ErrCode AtomicDecimal::update_locked(const Decimal &d, Decimal *previous) noexcept {
+        const uint64_t seq = lock();
+        detail::AtomicWord w = detail::load_atomic_word(&m_word);
+        while (true) {
+                const Decimal current =
+                        w == detail::kAtomicWideWord ? read_wide(true) : decode(w);
+                Decimal next = current;
+                const ErrCode err = kSub ? next.sub(d) : next.add(d);
+                if (err) {
+                        unlock(seq);
+                        return err;
+                }
+                __int128_t p = 0;
+                const bool fits = get_payload(next, p);
+                // Only the writer holding the lock changes a wide word, while a word that is not
+                // wide might still be changed by the compare and swaps of add() and sub(). The
+                // wide tier is written once the word is wide, so that it only ever holds values
+                // published by the word: readers seeing the wide word wait for the lock.
+                const detail::AtomicWord desired =
+                        fits ? detail::pack_atomic_word(p, next.get_scale())
+                             : detail::kAtomicWideWord;
+                if (detail::cas_atomic_word(&m_word, w, desired)) {
+                        if (!fits) {
+                                write_wide(next);
+                        }
+                        if (previous != nullptr) {
+                                *previous = current;
+                        }
+                        unlock(seq);
+                        return kSuccess;
+                }
+        }
+}
+}  // namespace bignum
@@ -0,0 +1,131 @@
+/*
+ * This file is part of bignum.
+ *
+ * bignum is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * bignum is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bignum.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2024-present  bignum developers
+ */
+#pragma once
+
+#include "decimal.h"
+#include "decimal_column.h"
+
+#include <algorithm>
+#include <span>
+
+namespace bignum {
+namespace detail {
+// The payload p at a scale that is exp higher (or -exp lower) as int128, rounded with kMode.
+// Return false if it does not fit.
+template <RoundingMode kMode, typename T>
+inline bool rescale_payload(T p, int32_t exp, __int128_t &x) {
+        if (exp == 0) {
+                x = p;
+                return true;
+        } else if (exp > 0) {
+                return !__builtin_mul_overflow(static_cast<__int128_t>(p), kInt128Power10[exp], &x);
+        }
+
+        // Scaling down could never overflow, and the magnitude of T fits into two limbs plus one
+        // for the carry.
+        const bool negative = p < 0;
+        using UT = UnsignedPayload<T>;
+        const UT mag = negative ? ~static_cast<UT>(p) + 1 : static_cast<UT>(p);
+        if (sizeof(T) == 8 && -exp <= kMaxUint64Power10) {
+                // A single division by a precomputed magic
+                uint64_t q = div_magic64(static_cast<uint64_t>(mag), kPower10Magics[-exp]);
+                const uint64_t r = static_cast<uint64_t>(mag) - q * kUint64Power10[-exp];
+                const uint64_t half = kUint64HalfPower10[-exp];
+                q += (r != 0) & round_away<kMode>(negative, r, half, false, q & 1);
+                x = negative ? -static_cast<__int128_t>(q) : static_cast<__int128_t>(q);
+                return true;
+        }
+        uint64_t limbs[3] = {static_cast<uint64_t>(mag), 0, 0};
+        int32_t n = 1;
+        if constexpr (sizeof(T) == 16) {
+                limbs[1] = static_cast<uint64_t>(mag >> 64);
+                n = 2;
+        }
+        (void)scale_down_limbs<kMode>(limbs, normalized_limbs_size(limbs, n), -exp, negative);
+        const __uint128_t u = (static_cast<__uint128_t>(limbs[1]) << 64) | limbs[0];
+        x = static_cast<__int128_t>(negative ? ~u + 1 : u);
+        return true;
+}
+
+template <RoundingMode kMode, typename T, typename U>
+inline size_t cast(const DecimalColumnImpl<T> &column, int32_t precision,
+                   DecimalColumnImpl<U> &result, std::span<uint64_t> overflow) {
+        const size_t n = column.size();
+        const int32_t scale = result.get_scale();
+        const int32_t exp = scale - column.get_scale();
+        // Every int128 fits if the precision is more than 38 digits
+        const bool unlimited = precision > kMaxInt128Power10;
+        const __int128_t limit = unlimited ? 0 : kInt128Power10[precision];
+        const std::span<const T> payload = column.payload();
+        size_t num_overflows = 0;
+        for (size_t i = 0; i < n; ++i) {
+                __int128_t x = 0;
+                bool fits = false;
+                if (!column.is_wide(i) && rescale_payload<kMode>(payload[i], exp, x)) {
+                        fits = unlimited || (x > -limit && x < limit);
+                        if (fits) {
+                                result.push_back_scaled(x);
+                        }
+                } else {
+                        Decimal d = column[i];
+                        fits = !d.rescale<kMode>(scale) && d.precision() <= precision;
+                        if (fits) {
+                                result.push_back(d);
+                        }
+                }
+                if (!fits) {
+                        result.push_back_scaled(0);
+                        overflow[i / 64] |= uint64_t{1} << (i % 64);
+                        num_overflows++;
+                }
+        }
+        return num_overflows;
+}
+}  // namespace detail
+
+//=-----------------------------------------------------------------------------
+// SQL `CAST(x AS DECIMAL(precision, scale))` of every value of a column, where scale is that of
+// the result column, e.g., from DECIMAL(18, 4) prices to DECIMAL(10, 2).
+//
+// The result is cleared first, and then gets one value per value of the column, rescaled with
+// `mode`. A value with more than `precision` digits after rescaling overflows: it is 0 in the
+// result and bit (i % 64) of overflow[i / 64] is set, for at least (column.size() + 63) / 64
+// words, so that the bitmap could be used as the null bitmap of the result. Return the number of
+// values that overflow.
+//
+// Payloads are rescaled directly as integers with precomputed reciprocals of powers of 10, and
+// only the values in the side table of the column go through Decimal::rescale(), so no value of
+// up to 38 digits calls into gmp. The mode is resolved once for the whole column rather than
+// once per value.
+//=-----------------------------------------------------------------------------
+template <typename T, typename U>
+inline size_t cast(const DecimalColumnImpl<T> &column, int32_t precision, RoundingMode mode,
+                   DecimalColumnImpl<U> &result, std::span<uint64_t> overflow) {
+        __BIGNUM_CHECK_ERROR(precision > 0 && precision <= Decimal::kMaxPrecision,
+                             "Invalid precision of decimal cast");
+        const size_t n = column.size();
+        __BIGNUM_ASSERT(overflow.size() >= (n + 63) / 64);
+        std::fill_n(overflow.begin(), (n + 63) / 64, 0);
+        result.clear();
+        result.reserve(n);
+        return detail::dispatch_rounding(mode, [&](auto m) {
+                return detail::cast<decltype(m)::value>(column, precision, result, overflow);
+        });
+}
+}  // namespace bignum
@@ -0,0 +1,265 @@
+/*
+ * This file is part of bignum.
+ *
+ * bignum is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * bignum is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bignum.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2024-present  bignum developers
+ */
+#pragma once
+
+#include "decimal.h"
+
+#include <algorithm>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace bignum {
+namespace detail {
+// std::make_unsigned does not support __int128_t in strict ISO mode.
+template <typename T>
+using UnsignedPayload = std::conditional_t<std::is_same_v<T, int64_t>, uint64_t, __uint128_t>;
+}  // namespace detail
+
+//=-----------------------------------------------------------------------------
+// A column of decimals with a single declared scale, like the storage decimal type of a database,
+// as opposed to Decimal, which keeps its own scale and representation in 64 bytes.
+//
+// Each value is stored as its internal integer at the scale of the column in a payload array of
+// T (int64_t or __int128_t), i.e., 8 or 16 bytes per value, which batch kernels could process
+// directly. A value that does not fit, because it is too large or has more fractional digits
+// than the column scale, is kept as a Decimal in a sparse side table instead, and its payload is
+// kWideMarker. Reading the column always gives back the exact values that were stored.
+//
+//   DecimalColumn prices(2);
+//   prices.push_back(Decimal("1.5"));     // payload 150
+//   prices.push_back(Decimal("0.125"));   // side table, as it has 3 fractional digits
+//   Decimal d = prices[0];                // 1.50
+//
+// A column could be annotated with a bound of the absolute values it holds, e.g., prices below
+// 10^9, which is checked on every insertion. Every value of a bounded column is in the payload,
+// and batch kernels could tell from the bounds alone that a computation never overflows, and skip
+// the overflow checks altogether (see decimal_arith.h).
+//=-----------------------------------------------------------------------------
+template <typename T>
+class DecimalColumnImpl final {
+        static_assert(std::is_same_v<T, int64_t> || std::is_same_v<T, __int128_t>,
+                      "Payload of a decimal column must be int64_t or __int128_t");
+
+       public:
+        // Payload of values that are in the side table, which is the minimum value of T. The value
+        // that would have this payload goes to the side table as well.
+        constexpr static T kWideMarker =
+                static_cast<T>(static_cast<__uint128_t>(1) << (sizeof(T) * 8 - 1));
+        // Bound of the payloads of a column without a bound, the maximum value of T.
+        constexpr static T kNoBound = ~kWideMarker;
+
+        explicit DecimalColumnImpl(int32_t scale = 0) : m_scale(scale) {
+                __BIGNUM_CHECK_ERROR(scale >= 0 && scale <= Decimal::kMaxScale,
+                                     "Invalid scale of decimal column");
+        }
+
+        int32_t get_scale() const { return m_scale; }
+        size_t size() const { return m_payload.size(); }
+        bool empty() const { return m_payload.empty(); }
+        void reserve(size_t n) { m_payload.reserve(n); }
+        // Keeps the bound.
+        void clear();
+
+        void push_back(const Decimal &value);
+        void set(size_t i, const Decimal &value);
+
+        // Append the value whose integer at the scale of the column is i, e.g., 150 for 1.50 in a
+        // column of scale 2, which saves the conversion of a Decimal.
+        void push_back_scaled(__int128_t i);
+
+        //=--------------------------------------------------------
+        // Bound of the absolute values.
+        //=--------------------------------------------------------
+        // Require every value, current or future, to be at most max_abs in absolute value and to
+        // have at most as many fractional digits as the column, e.g., set_bound(Decimal(1000000))
+        // for a DECIMAL(10, 4). Inserting a value out of the bound is an error.
+        void set_bound(const Decimal &max_abs);
+        // Same with the integer of max_abs at the scale of the column, e.g., 10^10 - 1 for
+        // DECIMAL(10, 4).
+        void set_bound_scaled(T max_abs);
+        bool has_bound() const { return m_bound != kNoBound; }
+        // Bound of the payloads, or kNoBound.
+        T bound_scaled() const { return m_bound; }
+
+        Decimal get(size_t i) const;
+        Decimal operator[](size_t i) const { return get(i); }
+
+        //=--------------------------------------------------------
+        // Raw access for batch kernels.
+        //=--------------------------------------------------------
+        std::span<const T> payload() const { return m_payload; }
+
+        // Whether value i is in the side table rather than the payload.
+        bool is_wide(size_t i) const { return m_payload[i] == kWideMarker; }
+
+        // Indices of the values in the side table in ascending order, and the values.
+        std::span<const size_t> wide_indices() const { return m_wide_indices; }
+        std::span<const Decimal> wide_values() const { return m_wide_values; }
+
+        // Append n values whose payloads the caller writes to the returned span before any other
+        // access to the column. They must not be kWideMarker, and must be within the bound if
+        // the column has one, which check_payload() asserts in debug builds.
+        std::span<T> append_payload(size_t n) {
+                const size_t size = m_payload.size();
+                m_payload.resize(size + n);
+                return std::span<T>(m_payload).subspan(size);
+        }
+        void check_payload() const;
+
+       private:
+        // The payload of value at the scale of the column, or kWideMarker if it does not fit.
+        T to_payload(const Decimal &value) const;
+
+        bool in_bound(__int128_t p) const { return p >= -m_bound && p <= m_bound; }
+        void check_bound(__int128_t p) const {
+                __BIGNUM_CHECK_ERROR(!has_bound() || in_bound(p),
+                                     "Value out of the bound of decimal column");
+        }
+
+        // Position of index i in m_wide_indices, or where it would be inserted.
+        size_t find_wide(size_t i) const {
+                return std::lower_bound(m_wide_indices.begin(), m_wide_indices.end(), i) -
+                       m_wide_indices.begin();
+        }
+
+        int32_t m_scale = 0;
+        T m_bound = kNoBound;
+        std::vector<T> m_payload;
+        std::vector<size_t> m_wide_indices;
+        std::vector<Decimal> m_wide_values;
+};
+
+using DecimalColumn = DecimalColumnImpl<int64_t>;
+using DecimalColumn128 = DecimalColumnImpl<__int128_t>;
+
+template <typename T>
+inline T DecimalColumnImpl<T>::to_payload(const Decimal &value) const {
+        __int128_t i = 0;
+        if (value.to_scaled_int128(m_scale, i)) {
+                return kWideMarker;
+        }
+        if constexpr (std::is_same_v<T, int64_t>) {
+                if (i < INT64_MIN || i > INT64_MAX) {
+                        return kWideMarker;
+                }
+        }
+        return static_cast<T>(i);
+}
+
+template <typename T>
+inline void DecimalColumnImpl<T>::clear() {
+        m_payload.clear();
+        m_wide_indices.clear();
+        m_wide_values.clear();
+}
+
+template <typename T>
+inline void DecimalColumnImpl<T>::set_bound(const Decimal &max_abs) {
+        __int128_t i = 0;
+        __BIGNUM_CHECK_ERROR(!max_abs.is_negative() && !max_abs.to_scaled_int128(m_scale, i) &&
+                                     i < kNoBound,
+                             "Invalid bound of decimal column");
+        set_bound_scaled(static_cast<T>(i));
+}
+
+template <typename T>
+inline void DecimalColumnImpl<T>::set_bound_scaled(T max_abs) {
+        __BIGNUM_CHECK_ERROR(max_abs >= 0 && max_abs < kNoBound, "Invalid bound of decimal column");
+        for (const T p : m_payload) {
+                __BIGNUM_CHECK_ERROR(p >= -max_abs && p <= max_abs,
+                                     "Value out of the bound of decimal column");
+        }
+        m_bound = max_abs;
+}
+
+template <typename T>
+inline void DecimalColumnImpl<T>::check_payload() const {
+#ifndef NDEBUG
+        __BIGNUM_ASSERT(static_cast<size_t>(std::count(m_payload.begin(), m_payload.end(),
+                                                       kWideMarker)) == m_wide_indices.size());
+        for (const T p : m_payload) {
+                __BIGNUM_ASSERT(!has_bound() || in_bound(p));
+        }
+#endif
+}
+
+template <typename T>
+inline void DecimalColumnImpl<T>::push_back(const Decimal &value) {
+        const T p = to_payload(value);
+        check_bound(p);
+        if (p == kWideMarker) {
+                m_wide_indices.push_back(m_payload.size());
+                m_wide_values.push_back(value);
+        }
+        m_payload.push_back(p);
+}
+
+template <typename T>
+inline void DecimalColumnImpl<T>::push_back_scaled(__int128_t i) {
+        check_bound(i);
+        if (i > static_cast<__int128_t>(kWideMarker) &&
+            (std::is_same_v<T, __int128_t> || i <= INT64_MAX)) {
+                m_payload.push_back(static_cast<T>(i));
+                return;
+        }
+        Decimal d(i);
+        d.m_scale = m_scale;
+        m_wide_indices.push_back(m_payload.size());
+        m_wide_values.push_back(d);
+        m_payload.push_back(kWideMarker);
+}
+
+template <typename T>
+inline void DecimalColumnImpl<T>::set(size_t i, const Decimal &value) {
+        __BIGNUM_ASSERT(i < m_payload.size());
+        const T p = to_payload(value);
+        check_bound(p);
+        const size_t pos = find_wide(i);
+        if (is_wide(i)) {
+                if (p == kWideMarker) {
+                        m_wide_values[pos] = value;
+                } else {
+                        m_wide_indices.erase(m_wide_indices.begin() + pos);
+                        m_wide_values.erase(m_wide_values.begin() + pos);
+                }
+        } else if (p == kWideMarker) {
+                m_wide_indices.insert(m_wide_indices.begin() + pos, i);
+                m_wide_values.insert(m_wide_values.begin() + pos, value);
+        }
+        m_payload[i] = p;
+}
+
+template <typename T>
+inline Decimal DecimalColumnImpl<T>::get(size_t i) const {
+        __BIGNUM_ASSERT(i < m_payload.size());
+        const T p = m_payload[i];
+        if (p == kWideMarker) {
+                return m_wide_values[find_wide(i)];
+        }
+        Decimal d;
+        if (std::is_same_v<T, int64_t> || (p >= INT64_MIN && p <= INT64_MAX)) {
+                d = Decimal(static_cast<int64_t>(p));
+        } else {
+                d = Decimal(static_cast<__int128_t>(p));
+        }
+        d.m_scale = m_scale;
+        return d;
+}
+}  // namespace bignum
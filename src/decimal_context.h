@@ -0,0 +1,94 @@
+/*
+ * This file is part of bignum.
+ *
+ * bignum is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * bignum is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bignum.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2024-present  bignum developers
+ */
+#pragma once
+
+#include "assertion.h"
+
+#include <cstdint>
+#include <type_traits>
+
+namespace bignum {
+//=-----------------------------------------------------------------------------
+// How many fractional digits products and quotients get, e.g., a context with max_scale = 8 for
+// prices makes 1 / 3 = 0.3333 and 1.00000000 / 3 = 0.33333333, and rounds 1.5 * 0.00000001 to
+// 0.00000002 rather than keeping 9 digits.
+//
+// Every thread has a context, which is the default one (kMaxScale = 30 and kDivIncreaseScale =
+// 4) unless set otherwise, and is used by the arithmetic operators. Decimal::mul() and
+// Decimal::div() also take a context explicitly. Fewer digits are less work: a quotient of small
+// operands with a small max scale is computed in int128 rather than in gmp.
+//
+//   ScopedDecimalContext guard(DecimalContext{.max_scale = 8});
+//   Decimal avg = sum / Decimal(n);  // at most 8 fractional digits
+//
+// Operations evaluated at compile time always use the default context.
+//=-----------------------------------------------------------------------------
+struct DecimalContext {
+        // Same as Decimal::kMaxScale and Decimal::kDivIncreaseScale
+        constexpr static int32_t kMaxScale = 30;
+        constexpr static int32_t kDefaultDivIncreaseScale = 4;
+
+        // Scale products and quotients are rounded to if they would have more fractional digits,
+        // in [0, kMaxScale].
+        int32_t max_scale = kMaxScale;
+        // Scale a quotient gets over that of its dividend, up to max_scale, in [0, kMaxScale].
+        int32_t div_increase_scale = kDefaultDivIncreaseScale;
+
+        constexpr bool is_valid() const {
+                return max_scale >= 0 && max_scale <= kMaxScale && div_increase_scale >= 0 &&
+                       div_increase_scale <= kMaxScale;
+        }
+};
+
+namespace detail {
+inline thread_local DecimalContext tls_decimal_context;
+
+constexpr inline DecimalContext current_decimal_context() noexcept {
+        if (std::is_constant_evaluated()) {
+                return DecimalContext{};
+        }
+        return tls_decimal_context;
+}
+}  // namespace detail
+
+// Context of the calling thread.
+inline const DecimalContext &get_decimal_context() noexcept { return detail::tls_decimal_context; }
+
+inline void set_decimal_context(const DecimalContext &context) {
+        __BIGNUM_CHECK_ERROR(context.is_valid(), "Invalid decimal context");
+        detail::tls_decimal_context = context;
+}
+
+// Set the context of the calling thread for the lifetime of the guard, and restore the previous
+// one afterwards.
+class ScopedDecimalContext final {
+       public:
+        explicit ScopedDecimalContext(const DecimalContext &context)
+                : m_saved(detail::tls_decimal_context) {
+                set_decimal_context(context);
+        }
+        ~ScopedDecimalContext() { detail::tls_decimal_context = m_saved; }
+
+        ScopedDecimalContext(const ScopedDecimalContext &) = delete;
+        ScopedDecimalContext &operator=(const ScopedDecimalContext &) = delete;
+
+       private:
+        DecimalContext m_saved;
+};
+}  // namespace bignum
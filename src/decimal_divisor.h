@@ -0,0 +1,138 @@
+/*
+ * This file is part of bignum.
+ *
+ * bignum is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * bignum is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bignum.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2024-present  bignum developers
+ */
+#pragma once
+
+#include "decimal.h"
+
+namespace bignum {
+//=-----------------------------------------------------------------------------
+// A precomputed divisor for dividing many decimals by the same value.
+//
+// `Decimal::div()` converts both operands into gmp integers and runs a full multi-precision
+// division for every call. When the same divisor is used over and over again (e.g., an FX rate
+// or a share count), most of that work could be done only once: if the integer representation of
+// the divisor fits into a 64-bit limb, a normalized reciprocal of it is computed at construction,
+// and every subsequent division is done by multiplications only, limb by limb.
+//
+// Results (value, scale and error code) are exactly the same as `Decimal::div()`. Divisors
+// that do not fit into a single limb fall back to `Decimal::div()`.
+//
+//   DecimalDivisor rate("7.0245");
+//   for (auto &d : values) {
+//       ErrCode err = rate.div(d);  // d = d / 7.0245
+//   }
+//=-----------------------------------------------------------------------------
+class DecimalDivisor final {
+       public:
+        explicit DecimalDivisor(const Decimal &divisor) noexcept : m_divisor(divisor) {
+                uint64_t limbs[detail::Gmp320::kNumLimbs] = {0};
+                int32_t n = m_divisor.get_magnitude(limbs);
+                m_scale = m_divisor.m_scale;
+                m_negative = m_divisor.is_negative();
+                m_use_reciprocal = (n == 1);
+                if (m_use_reciprocal) {
+                        m_rcp = detail::make_reciprocal64(limbs[0]);
+                }
+        }
+
+        const Decimal &divisor() const { return m_divisor; }
+
+        // value = value / divisor.
+        //
+        // Return kDivByZero if the divisor is zero, or overflow error if the result exceed the
+        // maximum precision, in which case `value` is left untouched.
+        ErrCode div(Decimal &value) const noexcept;
+
+       private:
+        Decimal m_divisor;
+        detail::Reciprocal64 m_rcp;
+        int32_t m_scale = 0;
+        bool m_negative = false;
+        bool m_use_reciprocal = false;
+};
+
+inline ErrCode DecimalDivisor::div(Decimal &value) const noexcept {
+        if (value.is_poisoned()) {
+                return value.get_error();
+        }
+        const DecimalContext &context = get_decimal_context();
+        const int32_t lscale = value.m_scale;
+        const int32_t res_scale =
+                detail::constexpr_min(context.max_scale, lscale + context.div_increase_scale);
+        if (!m_use_reciprocal || m_scale + res_scale < lscale) {
+                // Zero divisor, multiple-limbs divisor, or a dividend with more fractional digits
+                // than the max scale of the context, which would scale the divisor instead.
+                return value.div(m_divisor);
+        }
+        value.sanity_check();
+        detail::count_decimal_op(DecimalStats::kDiv, value.dispatch_tier(m_divisor));
+
+        // The dividend is multiplied by at most 10^(2 * kMaxScale), which takes 4 extra limbs,
+        // plus 1 limb for the rounding carry.
+        uint64_t limbs[detail::Gmp320::kNumLimbs + 5] = {0};
+        int32_t n = value.get_magnitude(limbs);
+        if (n == 0) {
+                value.set_dtype(Decimal::DType::kInt64);
+                value.m_i64 = 0;
+                value.m_scale = 0;
+                return kSuccess;
+        }
+
+        // Same as `Decimal::div()`:
+        //    quotient = |l| * 10^(rscale + res_scale - lscale + 1) / |r|
+        //    round-half-up on the last digit of quotient
+        //
+        // Truncating twice is the same as truncating once, so we calculate
+        //    quotient = |l| * 10^(rscale + res_scale - lscale) / |r|
+        // and round half up using the remainder instead of an extra digit.
+        n = detail::mul_limbs_power10(limbs, n, m_scale + res_scale - lscale);
+
+        uint64_t remainder = detail::divrem_limbs_preinv(limbs, limbs, n, m_rcp);
+        if (remainder >= m_rcp.divisor() - remainder) {
+                limbs[n] = detail::add_limbs_1(limbs, n, 1);
+                n++;
+        }
+        n = detail::normalized_limbs_size(limbs, n);
+
+        if (detail::limbs_out_of_range(limbs, n)) {
+                return kDecimalMulOverflow;
+        }
+
+        value.store_magnitude(limbs, n, value.is_negative() != m_negative);
+        value.m_scale = res_scale;
+
+#ifdef BIGNUM_DEV_USE_GMP_ONLY
+        value.convert_internal_representation_to_gmp();
+#endif
+        value.sanity_check();
+        return kSuccess;
+}
+
+inline Decimal &operator/=(Decimal &lhs, const DecimalDivisor &rhs) {
+        ErrCode err = rhs.div(lhs);
+        __BIGNUM_CHECK_ERROR(!err, "Decimal division by zero or overflow");
+        return lhs;
+}
+
+inline Decimal operator/(const Decimal &lhs, const DecimalDivisor &rhs) {
+        Decimal res = lhs;
+        res /= rhs;
+        return res;
+}
+}  // namespace bignum
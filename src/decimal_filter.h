@@ -0,0 +1,252 @@
+/*
+ * This file is part of bignum.
+ *
+ * bignum is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * bignum is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bignum.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2024-present  bignum developers
+ */
+#pragma once
+
+#include "decimal.h"
+#include "decimal_column.h"
+
+#include <algorithm>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace bignum {
+enum class CompareOp : int32_t { kLt = 0, kLe, kEq, kNe, kGt, kGe };
+
+namespace detail {
+// floor(v * 10^scale) and whether it is exact. Return -1 or 1 (with f untouched) if the result
+// is below or above the range of int128, and 0 otherwise.
+inline int32_t scaled_floor(const Decimal &v, int32_t scale, __int128_t &f, bool &exact) {
+        if (!v.to_scaled_int128(scale, f)) {
+                exact = true;
+                return 0;
+        }
+        // v has more fractional digits than scale, or is too large. The product must be exact,
+        // which it is with the default context whatever the context of the thread is.
+        Decimal scaled = v;
+        __int128_t i = 0;
+        if (scaled.mul(Decimal(kInt128Power10[scale]), DecimalContext{}) || scaled.to_int128(i)) {
+                return v.is_negative() ? -1 : 1;
+        }
+        exact = scaled == Decimal(i);
+        if (!exact && scaled.is_negative()) {
+                // Truncated toward zero, which is never the minimum of int128
+                i--;
+        }
+        f = i;
+        return 0;
+}
+
+// Range [lo, hi] of payloads (as int128) at some scale, such that a comparison of payloads with
+// the range is equivalent to the comparison of the decimals they represent.
+struct PayloadRange {
+        __int128_t lo = kInt128Min;
+        __int128_t hi = kInt128Max;
+        bool empty = false;
+
+        // Keep payloads x with x >= v (or x > v if strict) only.
+        void intersect_lower(const Decimal &v, int32_t scale, bool strict) {
+                __int128_t f = 0;
+                bool exact = false;
+                const int32_t overflow = scaled_floor(v, scale, f, exact);
+                if (overflow != 0) {
+                        empty = empty || overflow > 0;
+                        return;
+                }
+                if (strict || !exact) {
+                        if (f == kInt128Max) {
+                                empty = true;
+                                return;
+                        }
+                        f++;
+                }
+                lo = std::max(lo, f);
+        }
+
+        // Keep payloads x with x <= v (or x < v if strict) only.
+        void intersect_upper(const Decimal &v, int32_t scale, bool strict) {
+                __int128_t f = 0;
+                bool exact = false;
+                const int32_t overflow = scaled_floor(v, scale, f, exact);
+                if (overflow != 0) {
+                        empty = empty || overflow < 0;
+                        return;
+                }
+                if (strict && exact) {
+                        if (f == kInt128Min) {
+                                empty = true;
+                                return;
+                        }
+                        f--;
+                }
+                hi = std::min(hi, f);
+        }
+};
+
+inline bool compare_decimal(const Decimal &lhs, CompareOp op, const Decimal &rhs) {
+        switch (op) {
+                case CompareOp::kLt:
+                        return lhs < rhs;
+                case CompareOp::kLe:
+                        return lhs <= rhs;
+                case CompareOp::kEq:
+                        return lhs == rhs;
+                case CompareOp::kNe:
+                        return lhs != rhs;
+                case CompareOp::kGt:
+                        return lhs > rhs;
+                case CompareOp::kGe:
+                        return lhs >= rhs;
+        }
+        return false;
+}
+
+// Set bit i of the bitmap iff payload[i] is in [lo, hi] (or not, if negate). Both bounds are
+// checked with a single unsigned comparison, x - lo <= hi - lo, and the results are gathered
+// as one byte per value first, which the compiler turns into SIMD comparisons, and then packed
+// into bits 8 at a time with a multiplication.
+template <typename T>
+inline void select_payload_range(std::span<const T> payload, T lo, T hi, bool empty, bool negate,
+                                 std::span<uint64_t> bitmap) {
+        using U = UnsignedPayload<T>;
+        constexpr size_t kBlock = 64;
+        const size_t n = payload.size();
+        if (empty) {
+                std::fill_n(bitmap.begin(), (n + kBlock - 1) / kBlock, negate ? ~uint64_t{0} : 0);
+        } else {
+                const U ulo = static_cast<U>(lo);
+                const U width = static_cast<U>(hi) - ulo;
+                const uint64_t flip = negate ? ~uint64_t{0} : 0;
+                for (size_t begin = 0; begin < n; begin += kBlock) {
+                        const size_t m = std::min(kBlock, n - begin);
+                        const T *p = payload.data() + begin;
+                        uint8_t selected[kBlock] = {0};
+                        for (size_t j = 0; j < m; ++j) {
+                                selected[j] = static_cast<U>(p[j]) - ulo <= width;
+                        }
+                        uint64_t word = 0;
+                        for (size_t g = 0; g < kBlock / 8; ++g) {
+                                uint64_t bytes = 0;
+                                std::memcpy(&bytes, selected + g * 8, sizeof(bytes));
+                                word |= ((bytes * 0x0102040810204080ull) >> 56) << (g * 8);
+                        }
+                        bitmap[begin / kBlock] = word ^ flip;
+                }
+        }
+        if (n % kBlock) {
+                bitmap[n / kBlock] &= (uint64_t{1} << (n % kBlock)) - 1;
+        }
+}
+
+template <typename T, typename Predicate>
+inline void select(const DecimalColumnImpl<T> &column, const PayloadRange &range, bool negate,
+                   Predicate &&wide_predicate, std::span<uint64_t> bitmap) {
+        __BIGNUM_ASSERT(bitmap.size() >= (column.size() + 63) / 64);
+        // Clamp the range to the payload type
+        constexpr __int128_t kMin = DecimalColumnImpl<T>::kWideMarker;
+        constexpr __int128_t kMax = static_cast<T>(~static_cast<UnsignedPayload<T>>(kMin));
+        const __int128_t lo = std::max(range.lo, kMin);
+        const __int128_t hi = std::min(range.hi, kMax);
+        const bool empty = range.empty || lo > hi;
+        select_payload_range<T>(column.payload(), static_cast<T>(empty ? 0 : lo),
+                                static_cast<T>(empty ? 0 : hi), empty, negate, bitmap);
+
+        // The payloads of values in the side table mean nothing
+        const std::span<const size_t> indices = column.wide_indices();
+        const std::span<const Decimal> values = column.wide_values();
+        for (size_t k = 0; k < indices.size(); ++k) {
+                const size_t i = indices[k];
+                const uint64_t bit = uint64_t{1} << (i % 64);
+                if (wide_predicate(values[k])) {
+                        bitmap[i / 64] |= bit;
+                } else {
+                        bitmap[i / 64] &= ~bit;
+                }
+        }
+}
+}  // namespace detail
+
+//=-----------------------------------------------------------------------------
+// Filter kernels over a decimal column, e.g., `price > 10.5`, producing a selection bitmap where
+// bit (i % 64) of bitmap[i / 64] is set iff value i is selected, for at least
+// (column.size() + 63) / 64 words. Bits after the last value are cleared.
+//
+// The decimal operand is converted once to a range of payloads at the scale of the column
+// (rounding to the inclusive integer bounds if it has more fractional digits), so that the
+// payloads are compared directly as integers, several per instruction. Only values in the side
+// table of the column are compared as decimals.
+//=-----------------------------------------------------------------------------
+
+// Select values with `value op rhs`.
+template <typename T>
+inline void filter(const DecimalColumnImpl<T> &column, CompareOp op, const Decimal &rhs,
+                   std::span<uint64_t> bitmap) {
+        const int32_t scale = column.get_scale();
+        detail::PayloadRange range;
+        bool negate = false;
+        switch (op) {
+                case CompareOp::kLt:
+                        range.intersect_upper(rhs, scale, true);
+                        break;
+                case CompareOp::kLe:
+                        range.intersect_upper(rhs, scale, false);
+                        break;
+                case CompareOp::kNe:
+                        negate = true;
+                        [[fallthrough]];
+                case CompareOp::kEq:
+                        range.intersect_lower(rhs, scale, false);
+                        range.intersect_upper(rhs, scale, false);
+                        break;
+                case CompareOp::kGt:
+                        range.intersect_lower(rhs, scale, true);
+                        break;
+                case CompareOp::kGe:
+                        range.intersect_lower(rhs, scale, false);
+                        break;
+        }
+        detail::select(
+                column, range, negate,
+                [&](const Decimal &v) { return detail::compare_decimal(v, op, rhs); }, bitmap);
+}
+
+// Select values with `lo <= value && value <= hi`.
+template <typename T>
+inline void filter_between(const DecimalColumnImpl<T> &column, const Decimal &lo, const Decimal &hi,
+                           std::span<uint64_t> bitmap) {
+        detail::PayloadRange range;
+        range.intersect_lower(lo, column.get_scale(), false);
+        range.intersect_upper(hi, column.get_scale(), false);
+        detail::select(
+                column, range, false, [&](const Decimal &v) { return lo <= v && v <= hi; },
+                bitmap);
+}
+
+// Indices of the set bits of the first n bits of a selection bitmap, in ascending order.
+inline void selection_to_indices(std::span<const uint64_t> bitmap, size_t n,
+                                 std::vector<uint32_t> &indices) {
+        indices.clear();
+        for (size_t w = 0; w < (n + 63) / 64; ++w) {
+                for (uint64_t word = bitmap[w]; word; word &= word - 1) {
+                        indices.push_back(static_cast<uint32_t>(w * 64 + __builtin_ctzll(word)));
+                }
+        }
+}
+}  // namespace bignum
@@ -0,0 +1,442 @@
+/*
+ * This file is part of bignum.
+ *
+ * bignum is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * bignum is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bignum.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2024-present  bignum developers
+ */
+#pragma once
+
+#include "decimal.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace bignum {
+namespace detail {
+// Canonical encoding of a decimal key: the magnitude without trailing zeros, its sign and
+// the scale reduced accordingly (see Decimal::get_normalized_magnitude()), so that keys which
+// compare equal have the same encoding. Together with the hash it takes 32 bytes.
+struct DecimalKey {
+        uint64_t hash = 0;
+        // The magnitude if it fits into 2 limbs, otherwise `lo` is the index of its limbs in
+        // DecimalFlatMap::m_long_keys.
+        uint64_t lo = 0;
+        uint64_t hi = 0;
+        int16_t scale = 0;
+        bool negative = false;
+        uint8_t num_limbs = 0;
+};
+static_assert(sizeof(DecimalKey) == 32);
+
+// Control byte of a slot: kCtrlEmpty, kCtrlDeleted, or the lowest 7 bits of the hash of the key
+// (always non-negative) if the slot is full.
+constexpr int8_t kCtrlEmpty = -128;
+constexpr int8_t kCtrlDeleted = -2;
+
+// A group of 8 control bytes, matched all at once with 64-bit arithmetic. Every match returns
+// a mask with the highest bit of the matching bytes set.
+struct CtrlGroup {
+        constexpr static int32_t kWidth = 8;
+        constexpr static uint64_t kLsbs = 0x0101010101010101ull;
+        constexpr static uint64_t kMsbs = 0x8080808080808080ull;
+
+        explicit CtrlGroup(const int8_t *ctrl) { std::memcpy(&m_ctrl, ctrl, sizeof(m_ctrl)); }
+
+        // Might have false positives (that are rare and harmless, as keys are compared
+        // afterwards), but no false negatives.
+        uint64_t match(int8_t h2) const {
+                uint64_t x = m_ctrl ^ (kLsbs * static_cast<uint8_t>(h2));
+                return (x - kLsbs) & ~x & kMsbs;
+        }
+
+        // kCtrlEmpty is the only control byte with the highest bit set and the second lowest
+        // bit cleared.
+        uint64_t match_empty() const { return m_ctrl & ~(m_ctrl << 6) & kMsbs; }
+
+        uint64_t match_empty_or_deleted() const { return m_ctrl & kMsbs; }
+
+        // Index of the lowest matching byte of a non-empty mask.
+        static int32_t lowest(uint64_t mask) { return __builtin_ctzll(mask) >> 3; }
+
+        uint64_t m_ctrl = 0;
+};
+}  // namespace detail
+
+//=-----------------------------------------------------------------------------
+// An open addressing hash map with decimal keys, e.g., for GROUP BY or a hash join on decimal
+// columns.
+//
+// Keys are stored as their canonical encoding (see detail::DecimalKey) rather than as 64-byte
+// decimals, together with their precomputed hashes, which are never calculated again when the
+// table grows. As with Decimal::hash(), keys that compare equal are the same key, e.g., "1.5"
+// and "1.50".
+//
+// Slots are probed by groups of 8 control bytes (one per slot, the same layout as SwissTable),
+// so that a lookup mostly touches a single group and compares only the keys whose 7 hash bits
+// in the control byte match. The load factor is at most 7/8.
+//
+// The value type V must be default constructible. Pointers to values are invalidated by
+// insertion.
+//
+//   DecimalFlatMap<int64_t> counts;
+//   for (const Decimal &d : column) {
+//       counts[d]++;
+//   }
+//   const int64_t *n = counts.find("1.5");
+//=-----------------------------------------------------------------------------
+template <typename V>
+class DecimalFlatMap final {
+       public:
+        DecimalFlatMap() = default;
+        explicit DecimalFlatMap(size_t capacity) { reserve(capacity); }
+
+        size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        // Number of slots.
+        size_t capacity() const { return m_ctrl.size(); }
+
+        // Make room for at least n keys without growing the table again.
+        void reserve(size_t n);
+
+        // Remove all keys, the capacity is kept.
+        void clear();
+
+        // The value of key, which is default constructed if key is not in the map yet.
+        V &operator[](const Decimal &key) { return *insert(key, V{}).first; }
+
+        // Insert key with the given value if key is not in the map yet. Return the value of key
+        // and whether it is inserted.
+        std::pair<V *, bool> insert(const Decimal &key, V value);
+
+        // Return nullptr if key is not in the map. A string key is looked up as the decimal it
+        // represents, e.g., "1.50" finds the key "1.5", and is never found if it is invalid.
+        V *find(const Decimal &key) { return find_value(key); }
+        const V *find(const Decimal &key) const { return find_value(key); }
+        V *find(std::string_view key) { return find_value(key); }
+        const V *find(std::string_view key) const { return find_value(key); }
+        V *find(const char *key) { return find_value(std::string_view(key)); }
+        const V *find(const char *key) const { return find_value(std::string_view(key)); }
+
+        bool contains(const Decimal &key) const { return find(key) != nullptr; }
+        bool contains(std::string_view key) const { return find(key) != nullptr; }
+        bool contains(const char *key) const { return find(key) != nullptr; }
+
+        // Return whether key was in the map.
+        bool erase(const Decimal &key);
+
+        // Call f(key, value) for every key in an unspecified order. Keys are given in their
+        // canonical form, i.e., without trailing zeros in the fractional part.
+        template <typename F>
+        void for_each(F &&f) const;
+        template <typename F>
+        void for_each(F &&f);
+
+       private:
+        constexpr static size_t kGroupWidth = detail::CtrlGroup::kWidth;
+        constexpr static size_t kNotFound = ~static_cast<size_t>(0);
+        constexpr static int32_t kNumLimbs = static_cast<int32_t>(detail::Gmp320::kNumLimbs);
+
+        // A key to look up, with the limbs of its magnitude.
+        struct Probe {
+                detail::DecimalKey key;
+                uint64_t limbs[kNumLimbs] = {0};
+        };
+
+        static void encode(const Decimal &d, Probe &probe);
+        Decimal decode(const detail::DecimalKey &key) const;
+        bool key_equal(const detail::DecimalKey &key, const Probe &probe) const;
+
+        static size_t max_load(size_t capacity) { return capacity - capacity / 8; }
+        static int8_t h2(uint64_t hash) { return static_cast<int8_t>(hash & 0x7f); }
+
+        // Slot of the key, or kNotFound.
+        size_t find_slot(const Probe &probe) const;
+        // First empty or deleted slot on the probe sequence of hash.
+        size_t find_insert_slot(uint64_t hash) const;
+
+        // Slot of a Decimal or string key, or kNotFound (also for an invalid string).
+        template <typename K>
+        size_t find_index(const K &key) const;
+        template <typename K>
+        V *find_value(const K &key) {
+                const size_t slot = find_index(key);
+                return slot == kNotFound ? nullptr : &m_values[slot];
+        }
+        template <typename K>
+        const V *find_value(const K &key) const {
+                const size_t slot = find_index(key);
+                return slot == kNotFound ? nullptr : &m_values[slot];
+        }
+
+        void grow();
+        void rehash(size_t capacity);
+
+        std::vector<int8_t> m_ctrl;
+        std::vector<detail::DecimalKey> m_keys;
+        std::vector<V> m_values;
+        std::vector<std::array<uint64_t, kNumLimbs>> m_long_keys;
+        size_t m_size = 0;
+        // Number of empty slots that could still be filled before the table grows.
+        size_t m_growth_left = 0;
+};
+
+template <typename V>
+inline void DecimalFlatMap<V>::encode(const Decimal &d, Probe &probe) {
+        int32_t scale = 0;
+        const int32_t n = d.get_normalized_magnitude(probe.limbs, scale);
+        detail::DecimalKey &key = probe.key;
+        key.negative = n && d.is_negative();
+        key.hash = detail::hash_limbs(probe.limbs, n, key.negative, scale);
+        key.lo = n > 0 ? probe.limbs[0] : 0;
+        key.hi = n > 1 ? probe.limbs[1] : 0;
+        key.scale = static_cast<int16_t>(scale);
+        key.num_limbs = static_cast<uint8_t>(n);
+}
+
+template <typename V>
+inline Decimal DecimalFlatMap<V>::decode(const detail::DecimalKey &key) const {
+        // A negative scale is brought back to 0, which takes at most as many digits as the
+        // original decimal. One more limb for the carry.
+        uint64_t limbs[kNumLimbs + 1] = {0};
+        int32_t n = key.num_limbs;
+        if (n <= 2) {
+                limbs[0] = key.lo;
+                limbs[1] = key.hi;
+        } else {
+                std::copy_n(m_long_keys[key.lo].begin(), n, limbs);
+        }
+        int32_t scale = key.scale;
+        if (scale < 0) {
+                n = detail::mul_limbs_power10(limbs, n, -scale);
+                scale = 0;
+        }
+
+        Decimal d;
+        d.store_magnitude(limbs, n, key.negative);
+        d.m_scale = scale;
+#ifdef BIGNUM_DEV_USE_GMP_ONLY
+        d.convert_internal_representation_to_gmp();
+#endif
+        return d;
+}
+
+template <typename V>
+inline bool DecimalFlatMap<V>::key_equal(const detail::DecimalKey &key, const Probe &probe) const {
+        const detail::DecimalKey &pkey = probe.key;
+        if (key.hash != pkey.hash || key.scale != pkey.scale || key.negative != pkey.negative ||
+            key.num_limbs != pkey.num_limbs) {
+                return false;
+        }
+        if (key.num_limbs <= 2) {
+                return key.lo == pkey.lo && key.hi == pkey.hi;
+        }
+        return std::equal(probe.limbs, probe.limbs + key.num_limbs, m_long_keys[key.lo].begin());
+}
+
+template <typename V>
+inline size_t DecimalFlatMap<V>::find_slot(const Probe &probe) const {
+        if (m_ctrl.empty()) {
+                return kNotFound;
+        }
+        // Quadratic probing over groups, which visits every group as the number of groups is a
+        // power of 2. There is always an empty slot to stop at.
+        const size_t group_mask = m_ctrl.size() / kGroupWidth - 1;
+        const int8_t tag = h2(probe.key.hash);
+        size_t g = (probe.key.hash >> 7) & group_mask;
+        for (size_t i = 1;; ++i) {
+                const detail::CtrlGroup group(&m_ctrl[g * kGroupWidth]);
+                for (uint64_t mask = group.match(tag); mask; mask &= mask - 1) {
+                        const size_t slot = g * kGroupWidth + detail::CtrlGroup::lowest(mask);
+                        if (key_equal(m_keys[slot], probe)) {
+                                return slot;
+                        }
+                }
+                if (group.match_empty()) {
+                        return kNotFound;
+                }
+                g = (g + i) & group_mask;
+        }
+}
+
+template <typename V>
+inline size_t DecimalFlatMap<V>::find_insert_slot(uint64_t hash) const {
+        const size_t group_mask = m_ctrl.size() / kGroupWidth - 1;
+        size_t g = (hash >> 7) & group_mask;
+        for (size_t i = 1;; ++i) {
+                const detail::CtrlGroup group(&m_ctrl[g * kGroupWidth]);
+                const uint64_t mask = group.match_empty_or_deleted();
+                if (mask) {
+                        return g * kGroupWidth + detail::CtrlGroup::lowest(mask);
+                }
+                g = (g + i) & group_mask;
+        }
+}
+
+template <typename V>
+template <typename K>
+inline size_t DecimalFlatMap<V>::find_index(const K &key) const {
+        Probe probe;
+        if constexpr (std::is_same_v<K, std::string_view>) {
+                Decimal d;
+                if (d.assign(key)) {
+                        return kNotFound;
+                }
+                encode(d, probe);
+        } else {
+                encode(key, probe);
+        }
+        return find_slot(probe);
+}
+
+template <typename V>
+inline std::pair<V *, bool> DecimalFlatMap<V>::insert(const Decimal &key, V value) {
+        Probe probe;
+        encode(key, probe);
+        size_t slot = find_slot(probe);
+        if (slot != kNotFound) {
+                return {&m_values[slot], false};
+        }
+
+        if (m_growth_left == 0) {
+                grow();
+        }
+        slot = find_insert_slot(probe.key.hash);
+        if (m_ctrl[slot] == detail::kCtrlEmpty) {
+                // A deleted slot is reused without taking up the growth left.
+                m_growth_left--;
+        }
+        m_ctrl[slot] = h2(probe.key.hash);
+        m_keys[slot] = probe.key;
+        if (probe.key.num_limbs > 2) {
+                m_keys[slot].lo = m_long_keys.size();
+                m_long_keys.emplace_back();
+                std::copy_n(probe.limbs, probe.key.num_limbs, m_long_keys.back().begin());
+        }
+        m_values[slot] = std::move(value);
+        m_size++;
+        return {&m_values[slot], true};
+}
+
+template <typename V>
+inline bool DecimalFlatMap<V>::erase(const Decimal &key) {
+        Probe probe;
+        encode(key, probe);
+        const size_t slot = find_slot(probe);
+        if (slot == kNotFound) {
+                return false;
+        }
+
+        // Lookups stop at the first group with an empty slot. If the group of this slot already
+        // has one, no lookup could have gone past it, so the slot could be empty again rather
+        // than deleted. The limbs of a long key are dropped on the next rehash.
+        const detail::CtrlGroup group(&m_ctrl[slot / kGroupWidth * kGroupWidth]);
+        if (group.match_empty()) {
+                m_ctrl[slot] = detail::kCtrlEmpty;
+                m_growth_left++;
+        } else {
+                m_ctrl[slot] = detail::kCtrlDeleted;
+        }
+        m_values[slot] = V{};
+        m_size--;
+        return true;
+}
+
+template <typename V>
+inline void DecimalFlatMap<V>::reserve(size_t n) {
+        size_t capacity = kGroupWidth;
+        while (max_load(capacity) < n) {
+                capacity *= 2;
+        }
+        if (capacity > m_ctrl.size()) {
+                rehash(capacity);
+        }
+}
+
+template <typename V>
+inline void DecimalFlatMap<V>::clear() {
+        std::fill(m_ctrl.begin(), m_ctrl.end(), detail::kCtrlEmpty);
+        std::fill(m_values.begin(), m_values.end(), V{});
+        m_long_keys.clear();
+        m_size = 0;
+        m_growth_left = max_load(m_ctrl.size());
+}
+
+template <typename V>
+inline void DecimalFlatMap<V>::grow() {
+        // If the table is mostly filled with deleted slots, rehash in place to clean them up.
+        const size_t capacity = m_ctrl.size();
+        if (capacity == 0) {
+                rehash(kGroupWidth);
+        } else if (m_size * 2 <= max_load(capacity)) {
+                rehash(capacity);
+        } else {
+                rehash(capacity * 2);
+        }
+}
+
+template <typename V>
+inline void DecimalFlatMap<V>::rehash(size_t capacity) {
+        std::vector<int8_t> old_ctrl(capacity, detail::kCtrlEmpty);
+        std::vector<detail::DecimalKey> old_keys(capacity);
+        std::vector<V> old_values(capacity);
+        std::vector<std::array<uint64_t, kNumLimbs>> old_long_keys;
+        m_ctrl.swap(old_ctrl);
+        m_keys.swap(old_keys);
+        m_values.swap(old_values);
+        m_long_keys.swap(old_long_keys);
+
+        // Hashes are stored along with the keys, so keys are not hashed again.
+        for (size_t i = 0; i < old_ctrl.size(); ++i) {
+                if (old_ctrl[i] < 0) {
+                        continue;
+                }
+                detail::DecimalKey key = old_keys[i];
+                if (key.num_limbs > 2) {
+                        m_long_keys.push_back(old_long_keys[key.lo]);
+                        key.lo = m_long_keys.size() - 1;
+                }
+                const size_t slot = find_insert_slot(key.hash);
+                m_ctrl[slot] = h2(key.hash);
+                m_keys[slot] = key;
+                m_values[slot] = std::move(old_values[i]);
+        }
+        m_growth_left = max_load(capacity) - m_size;
+}
+
+template <typename V>
+template <typename F>
+inline void DecimalFlatMap<V>::for_each(F &&f) const {
+        for (size_t i = 0; i < m_ctrl.size(); ++i) {
+                if (m_ctrl[i] >= 0) {
+                        f(decode(m_keys[i]), static_cast<const V &>(m_values[i]));
+                }
+        }
+}
+
+template <typename V>
+template <typename F>
+inline void DecimalFlatMap<V>::for_each(F &&f) {
+        for (size_t i = 0; i < m_ctrl.size(); ++i) {
+                if (m_ctrl[i] >= 0) {
+                        f(decode(m_keys[i]), m_values[i]);
+                }
+        }
+}
+}  // namespace bignum
@@ -0,0 +1,863 @@
+/*
+ * This file is part of bignum.
+ *
+ * bignum is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * bignum is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bignum.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2024-present  bignum developers
+ */
+#pragma once
+
+#include "decimal.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+namespace bignum {
+namespace detail {
+// Digits kept of the intermediate powers of pow(). The result has at most 96 digits, and the
+// truncations of up to 63 squarings and 63 multiplications (an exponent below 2^63) lose less
+// than 19 more, so that the result is off only if it is within 10^-18 ulp of a rounding boundary.
+constexpr int32_t kPowDigits = 133;
+// An intermediate power is below 10^134, which fits into 7 limbs, and the product of two of them,
+// with one more limb for the carry of rounding.
+constexpr int32_t kPowLimbs = 7;
+constexpr int32_t kPowProductLimbs = 2 * kPowLimbs + 1;
+
+// r[0, an + bn) = a[0, an) * b[0, bn), where r is neither a nor b. Return the new number of limbs.
+constexpr inline int32_t mul_limbs(uint64_t *r, const uint64_t *a, int32_t an, const uint64_t *b,
+                                   int32_t bn) {
+        for (int32_t i = 0; i < an + bn; ++i) {
+                r[i] = 0;
+        }
+        for (int32_t i = 0; i < an; ++i) {
+                uint64_t carry = 0;
+                for (int32_t j = 0; j < bn; ++j) {
+                        const __uint128_t t =
+                                static_cast<__uint128_t>(a[i]) * b[j] + r[i + j] + carry;
+                        r[i + j] = static_cast<uint64_t>(t);
+                        carry = static_cast<uint64_t>(t >> 64);
+                }
+                r[i + bn] = carry;
+        }
+        return normalized_limbs_size(r, an + bn);
+}
+
+// Number of bits of a normalized magnitude u[0, n), which must not be zero.
+constexpr inline int32_t count_bits_limbs(const uint64_t *u, int32_t n) {
+        return n * 64 - __builtin_clzll(u[n - 1]);
+}
+
+// Magnitude of an intermediate power, u[0, n) * 10^exp, or a lower bound of it if inexact (some
+// nonzero digits were dropped).
+struct PowValue {
+        uint64_t limbs[kPowProductLimbs] = {0};
+        int32_t n = 0;
+        int32_t exp = 0;
+        bool inexact = false;
+
+        // The value is in [10^log10_lower(), 10^log10_upper()), where 1233 / 4096 is slightly
+        // below log10(2), and 1234 / 4096 slightly above.
+        constexpr int32_t log10_lower() const {
+                return ((count_bits_limbs(limbs, n) - 1) * 1233 >> 12) + exp;
+        }
+        constexpr int32_t log10_upper() const {
+                return (count_bits_limbs(limbs, n) * 1234 >> 12) + 1 + exp;
+        }
+
+        // Drop the digits beyond kPowDigits.
+        constexpr void truncate() {
+                int32_t drop = log10_lower() - exp + 1 - kPowDigits;
+                exp += drop > 0 ? drop : 0;
+                while (drop > 0) {
+                        const int32_t e = drop > kMaxUint64Power10 ? kMaxUint64Power10 : drop;
+                        const uint64_t r =
+                                divrem_limbs_preinv(limbs, limbs, n, kPower10Reciprocals[e]);
+                        inexact |= r != 0;
+                        n = normalized_limbs_size(limbs, n);
+                        drop -= e;
+                }
+        }
+};
+
+constexpr inline PowValue mul_pow_values(const PowValue &a, const PowValue &b) {
+        PowValue r;
+        r.n = mul_limbs(r.limbs, a.limbs, a.n, b.limbs, b.n);
+        r.exp = a.exp + b.exp;
+        r.inexact = a.inexact || b.inexact;
+        r.truncate();
+        return r;
+}
+
+enum class PowState : int32_t { kNormal = 0, kTiny, kOverflow };
+
+// Whether a power of |base| tells that base^n rounds as a tiny nonzero value (below 10^-(scale+1),
+// i.e., less than half an ulp) or overflows, where every later power is at least as large if
+// growing (|base| > 1), or at most as large otherwise.
+constexpr inline PowState pow_state(const PowValue &v, bool growing, bool reciprocal,
+                                    int32_t scale) {
+        if (growing) {
+                const int32_t lower = v.log10_lower();
+                if (reciprocal ? lower >= scale + 1 : lower >= kDecimalMaxPrecision) {
+                        return reciprocal ? PowState::kTiny : PowState::kOverflow;
+                }
+        } else {
+                const int32_t upper = v.log10_upper();
+                if (reciprocal ? upper <= -kDecimalMaxPrecision - 1 : upper <= -scale - 1) {
+                        return reciprocal ? PowState::kOverflow : PowState::kTiny;
+                }
+        }
+        return PowState::kNormal;
+}
+
+// Max degree of nth_root(). The radicand of a root with one more digit than the max scale has up
+// to 96 + 31 * n digits, which must fit into GmpRoot, and so must its powers.
+constexpr int32_t kMaxRootDegree = 16;
+using GmpRoot = GmpWrapper<36>;
+
+// floor(sqrt(x)) by Newton's iteration y' = (y + x / y) / 2, which decreases from any y at least
+// the root down to it and then stops decreasing. The initial y is within a few ulps of a double.
+template <typename U>
+constexpr inline U isqrt(U x) {
+        if (x < 2) {
+                return x;
+        }
+        U y = 0;
+        if (std::is_constant_evaluated()) {
+                int32_t bits = 0;
+                for (U v = x; v != 0; v >>= 1) {
+                        bits++;
+                }
+                y = static_cast<U>(1) << ((bits + 1) / 2);
+        } else {
+                y = static_cast<U>(std::sqrt(static_cast<double>(x)) * (1 + 0x1p-40)) + 1;
+        }
+        while (true) {
+                const U z = (y + x / y) / 2;
+                if (z >= y) {
+                        return y;
+                }
+                y = z;
+        }
+}
+
+// p = y^n for n >= 1 by squaring from the leading bit of n, where p is not y.
+inline void pow_root(GmpRoot &p, const GmpRoot &y, int32_t n) {
+        p = y;
+        for (int32_t bit = std::bit_width(static_cast<uint32_t>(n)) - 2; bit >= 0; --bit) {
+                mpz_mul(&p.mpz, &p.mpz, &p.mpz);
+                if ((n >> bit) & 1) {
+                        mpz_mul(&p.mpz, &p.mpz, &y.mpz);
+                }
+        }
+}
+
+// floor(x^(1/n)) of x > 0 by Newton's iteration y' = ((n - 1) * y + x / y^(n - 1)) / n, which
+// decreases from any y at least the root down to it as isqrt() does. With x = f * 2^(q * n + r),
+// the initial y is the root of f * 2^r in double, rounded up and scaled back by 2^q, which is
+// right to about 50 bits.
+inline void root_floor(GmpRoot &y, const GmpRoot &x, int32_t n) {
+        long e = 0;
+        const double f = mpz_get_d_2exp(&e, &x.mpz);
+        const int32_t q = static_cast<int32_t>(e / n);
+        const double estimate = std::pow(std::ldexp(f, static_cast<int32_t>(e % n)), 1.0 / n);
+        if (q <= 52) {
+                mpz_set_d(&y.mpz, std::ldexp(estimate * (1 + 0x1p-40), q) + 1);
+        } else {
+                mpz_set_d(&y.mpz, std::ldexp(estimate * (1 + 0x1p-40), 52) + 1);
+                mpz_mul_2exp(&y.mpz, &y.mpz, q - 52);
+        }
+
+        GmpRoot p;
+        GmpRoot z;
+        while (true) {
+                pow_root(p, y, n - 1);
+                mpz_tdiv_q(&z.mpz, &x.mpz, &p.mpz);
+                mpz_addmul_ui(&z.mpz, &y.mpz, n - 1);
+                mpz_tdiv_q_ui(&z.mpz, &z.mpz, n);
+                if (mpz_cmp(&z.mpz, &y.mpz) >= 0) {
+                        return;
+                }
+                y = z;
+        }
+}
+
+// ln 2 and ln 10 rounded down to kLogConstantBits fractional bits. Fixed-point evaluations at
+// fewer bits shift them down.
+constexpr int32_t kLogConstantBits = 768;
+using GmpLogConstant = GmpWrapper<13>;
+constexpr auto kLn2Fixed = GmpLogConstant(
+        12, 0x256fa0ec7657f74b, 0xb9ea9bc3b136603b, 0x1acbda11317c387e, 0x3e96ca16224ae8c5,
+        0x27573b291169b825, 0xed2eae35c1382144, 0x559552fb4afa1b10, 0xe7b876206debac98,
+        0x8a0d175b8baafa2b, 0x40f343267298b62d, 0xc9e3b39803f2f6af, 0xb17217f7d1cf79ab, 0x0);
+constexpr auto kLn10Fixed = GmpLogConstant(
+        13, 0x4586ed2748671eef, 0xbd9b3ac12acf1be9, 0xd96a9b0ec360c7ef, 0xe0b3e28a2a324479,
+        0xee3de2100b945b59, 0xb1889061042f8b6b, 0x31c32f00b17c35a0, 0x58bc0b5ec6a04173,
+        0x0f187a0807c0b5ca, 0x8a3fb3e76977e43a, 0xa95b58ae0b4c28a3, 0x4d763776aaa2b05b, 0x2);
+constexpr double kLn10Double = 2.302585092994046;
+constexpr double kLn2Double = 0.6931471805599453;
+
+// Fixed-point values of exp() and ln(), with up to a few hundred fractional bits, and their
+// products.
+using GmpFixed = GmpWrapper<24>;
+// Halvings of the argument of exp(), and square roots of that of ln(), before the series.
+constexpr int32_t kExpReduceSteps = 8;
+constexpr int32_t kLnReduceSteps = 4;
+// Bits below the last digit of the result, added 64 at a time while the result is too close to
+// a rounding boundary to round.
+constexpr int32_t kMinGuardBits = 32;
+constexpr int32_t kMaxGuardBits = 160;
+// Bits beyond the guard bits that keep the error of a result below 1/16 of its last guard bit.
+constexpr int32_t kFixedMarginBits = 16;
+
+enum class MathFunc : int32_t { kExp = 0, kLn, kLog10 };
+
+// c = a constant in fixed point with w fractional bits.
+inline void log_constant(GmpFixed &c, const GmpLogConstant &k, int32_t w) {
+        mpz_tdiv_q_2exp(&c.mpz, &k.mpz, kLogConstantBits - w);
+}
+
+// y = exp(r) of |r| < 1 in fixed point with w fractional bits: the Taylor series of
+// exp(r / 2^k) with k = kExpReduceSteps, squared k times. The rounding errors of the series
+// grow by 2^k with the squarings, which the caller covers with k more bits.
+inline void exp_fixed(GmpFixed &y, const GmpFixed &r, int32_t w) {
+        GmpFixed x;
+        mpz_tdiv_q_2exp(&x.mpz, &r.mpz, kExpReduceSteps);
+        GmpFixed term;
+        mpz_set_ui(&term.mpz, 1);
+        mpz_mul_2exp(&term.mpz, &term.mpz, w);
+        y = term;
+        for (uint64_t i = 1; mpz_sgn(&term.mpz) != 0; ++i) {
+                mpz_mul(&term.mpz, &term.mpz, &x.mpz);
+                mpz_tdiv_q_2exp(&term.mpz, &term.mpz, w);
+                mpz_tdiv_q_ui(&term.mpz, &term.mpz, i);
+                mpz_add(&y.mpz, &y.mpz, &term.mpz);
+        }
+        for (int32_t i = 0; i < kExpReduceSteps; ++i) {
+                mpz_mul(&y.mpz, &y.mpz, &y.mpz);
+                mpz_tdiv_q_2exp(&y.mpz, &y.mpz, w);
+        }
+}
+
+// l = ln(f) of f in [1/2, 2) in fixed point with w fractional bits: 2^(k + 1) * atanh(z) of
+// z = (g - 1) / (g + 1) and g = f^(1 / 2^k) after k = kLnReduceSteps square roots, where the
+// series atanh(z) = z + z^3 / 3 + z^5 / 5 + ... gains more than 12 bits per term. The rounding
+// errors grow by 2^(k + 1), which the caller covers with k + 1 more bits.
+inline void ln_fixed(GmpFixed &l, const GmpFixed &f, int32_t w) {
+        GmpFixed g = f;
+        for (int32_t i = 0; i < kLnReduceSteps; ++i) {
+                mpz_mul_2exp(&g.mpz, &g.mpz, w);
+                mpz_sqrt(&g.mpz, &g.mpz);
+        }
+        GmpFixed one;
+        mpz_set_ui(&one.mpz, 1);
+        mpz_mul_2exp(&one.mpz, &one.mpz, w);
+        GmpFixed z;
+        GmpFixed t;
+        mpz_sub(&z.mpz, &g.mpz, &one.mpz);
+        mpz_mul_2exp(&z.mpz, &z.mpz, w);
+        mpz_add(&t.mpz, &g.mpz, &one.mpz);
+        mpz_tdiv_q(&z.mpz, &z.mpz, &t.mpz);
+        GmpFixed z2;
+        mpz_mul(&z2.mpz, &z.mpz, &z.mpz);
+        mpz_tdiv_q_2exp(&z2.mpz, &z2.mpz, w);
+        l = z;
+        t = z;
+        GmpFixed term;
+        for (uint64_t i = 3; mpz_sgn(&t.mpz) != 0; i += 2) {
+                mpz_mul(&t.mpz, &t.mpz, &z2.mpz);
+                mpz_tdiv_q_2exp(&t.mpz, &t.mpz, w);
+                mpz_tdiv_q_ui(&term.mpz, &t.mpz, i);
+                mpz_add(&l.mpz, &l.mpz, &term.mpz);
+        }
+        mpz_mul_2exp(&l.mpz, &l.mpz, kLnReduceSteps + 1);
+}
+
+// Operations that need the internal representation of Decimal.
+struct DecimalMath {
+        template <RoundingMode kMode>
+        static constexpr ErrCode pow(const Decimal &base, int64_t n, Decimal &result,
+                                     int32_t max_scale) noexcept;
+
+        template <RoundingMode kMode>
+        static constexpr ErrCode mul_pow10(Decimal &d, int32_t n, int32_t max_scale) noexcept;
+
+        template <RoundingMode kMode>
+        static constexpr ErrCode root(const Decimal &d, int32_t n, int32_t scale,
+                                      Decimal &result) noexcept;
+
+        template <MathFunc kFunc, RoundingMode kMode>
+        static constexpr ErrCode transcendental(const Decimal &d, int32_t scale,
+                                                Decimal &result) noexcept;
+
+        static constexpr Decimal pow10(int32_t n) {
+                Decimal d;
+                if (n >= 0) {
+                        d.store_gmp_result(kGmp320Power10[n]);
+                } else {
+                        d = Decimal(1);
+                        d.m_scale = -n;
+                }
+                return d;
+        }
+
+       private:
+        // Store a magnitude u[0, n), which might exceed Gmp640, with the given sign and scale.
+        static constexpr ErrCode store(Decimal &d, const uint64_t *u, int32_t n, bool negative,
+                                       int32_t scale, ErrCode overflow) {
+                n = normalized_limbs_size(u, n);
+                if (limbs_out_of_range(u, n)) {
+                        return overflow;
+                }
+                Gmp640 gv;
+                for (int32_t i = 0; i < n; ++i) {
+                        gv.limbs[i] = u[i];
+                }
+                gv.mpz._mp_size = negative ? -n : n;
+                d.store_gmp_result(gv);
+                d.m_scale = scale;
+                return kSuccess;
+        }
+
+        // v * 10^scale as the payload of result, for the exact results of integers v.
+        static constexpr ErrCode store_integer(Decimal &result, int32_t v, int32_t scale) {
+                result.store_int128(static_cast<__int128_t>(v) * kInt128Power10[scale]);
+                result.m_scale = scale;
+                return kSuccess;
+        }
+
+        // Round t, the magnitude of v * 10^scale * 2^guard for an irrational v of the given sign,
+        // computed with an error below its last bit, into result at the scale with kMode. Return
+        // false without touching result if t is too close to a rounding boundary to tell which
+        // way v rounds, unless the guard bits are already kMaxGuardBits.
+        template <RoundingMode kMode>
+        static constexpr bool round_fixed(GmpFixed &t, int32_t guard, bool negative, int32_t scale,
+                                          Decimal &result, ErrCode &err) {
+                constexpr uint64_t kHalf = uint64_t{1} << 63;
+                // The leading 64 guard bits, and two bits of t in their units
+                uint64_t top = 0;
+                uint64_t slack = 2;
+                if (guard >= 64) {
+                        GmpFixed frac;
+                        mpz_tdiv_q_2exp(&frac.mpz, &t.mpz, guard - 64);
+                        top = mpz_getlimbn(&frac.mpz, 0);
+                } else {
+                        top = mpz_getlimbn(&t.mpz, 0) << (64 - guard);
+                        slack <<= 64 - guard;
+                }
+                const uint64_t h = top & (kHalf - 1);
+                if ((h < slack || h >= kHalf - slack) && guard < kMaxGuardBits) {
+                        return false;
+                }
+                mpz_tdiv_q_2exp(&t.mpz, &t.mpz, guard);
+                if (round_away<kMode>(negative, top, kHalf, true, mpz_odd_p(&t.mpz))) {
+                        mpz_add_ui(&t.mpz, &t.mpz, 1);
+                }
+                err = store(result, t.limbs, t.mpz._mp_size, negative, scale,
+                            kDecimalValueOutOfRange);
+                return true;
+        }
+
+        // base^n exactly in int128 with the scale of the product, if it fits.
+        static constexpr bool pow_int128(const Decimal &base, uint64_t n, Decimal &result,
+                                         int32_t max_scale) {
+                const int32_t scale = base.m_scale;
+                if (base.m_dtype > Decimal::DType::kInt128 ||
+                    (scale > 0 && n > static_cast<uint64_t>(max_scale / scale))) {
+                        return false;
+                }
+                __int128_t b = base.m_dtype == Decimal::DType::kInt64 ? base.m_i64 : base.m_i128;
+                __int128_t acc = 1;
+                for (uint64_t e = n;;) {
+                        if ((e & 1) && __builtin_mul_overflow(acc, b, &acc)) {
+                                return false;
+                        }
+                        e >>= 1;
+                        if (e == 0) {
+                                break;
+                        }
+                        if (__builtin_mul_overflow(b, b, &b)) {
+                                return false;
+                        }
+                }
+                result.store_int128(acc);
+                result.m_scale = scale * static_cast<int32_t>(n);
+                return true;
+        }
+};
+
+template <RoundingMode kMode>
+constexpr inline ErrCode DecimalMath::pow(const Decimal &base, int64_t n, Decimal &result,
+                                          int32_t max_scale) noexcept {
+        if (base.is_poisoned()) {
+                const ErrCode err = base.get_error();
+                result.poison(err);
+                return err;
+        }
+        if (n == 0) {
+                result = Decimal(1);
+                return kSuccess;
+        }
+        const bool reciprocal = n < 0;
+        const uint64_t un = reciprocal ? ~static_cast<uint64_t>(n) + 1 : static_cast<uint64_t>(n);
+        if (reciprocal && !base.to_bool()) {
+                return kDivByZero;
+        }
+        if (!reciprocal && pow_int128(base, un, result, max_scale)) {
+                return kSuccess;
+        }
+
+        const bool negative = base.is_negative() && (un & 1);
+        // The scale of the product for n > 0, and of the quotient 1 / base^-n otherwise.
+        int32_t scale = max_scale;
+        if (!reciprocal && base.m_scale == 0) {
+                scale = 0;
+        } else if (!reciprocal && un <= static_cast<uint64_t>(max_scale)) {
+                scale = std::min(base.m_scale * static_cast<int32_t>(un), max_scale);
+        }
+        if (!base.to_bool()) {
+                return store_integer(result, 0, scale);
+        }
+        PowValue b;
+        int32_t base_scale = 0;
+        b.n = base.get_normalized_magnitude(b.limbs, base_scale);
+        b.exp = -base_scale;
+        if (b.n == 1 && b.limbs[0] == 1 && b.exp == 0) {
+                // A base of 1 or -1, e.g., "1.00", whose powers are exact at any scale
+                return store_integer(result, negative ? -1 : 1, scale);
+        }
+        const bool growing = base > Decimal(1) || base < Decimal(-1);
+
+        // Exponentiation by squaring, from the lowest bit of the exponent
+        PowValue acc;
+        bool first = true;
+        PowState state = PowState::kNormal;
+        for (uint64_t e = un;;) {
+                if (e & 1) {
+                        acc = first ? b : mul_pow_values(acc, b);
+                        first = false;
+                        state = pow_state(acc, growing, reciprocal, scale);
+                }
+                e >>= 1;
+                if (e == 0 || state != PowState::kNormal) {
+                        break;
+                }
+                b = mul_pow_values(b, b);
+                state = pow_state(b, growing, reciprocal, scale);
+                if (state != PowState::kNormal) {
+                        break;
+                }
+        }
+
+        const ErrCode overflow = reciprocal ? kDecimalDivOverflow : kDecimalMulOverflow;
+        if (state == PowState::kOverflow) {
+                return overflow;
+        }
+        if (state == PowState::kTiny) {
+                // Any value below half an ulp rounds the same way.
+                uint64_t tiny[2] = {1, 0};
+                const int32_t tn = scale_down_limbs<kMode>(tiny, 1, 1, negative);
+                return store(result, tiny, tn, negative, scale, overflow);
+        }
+
+        if (!reciprocal) {
+                const int32_t exp = acc.exp + scale;
+                if (exp >= 0) {
+                        if (acc.log10_lower() + scale >= kDecimalMaxPrecision) {
+                                return overflow;
+                        }
+                        acc.n = mul_limbs_power10(acc.limbs, acc.n, exp);
+                } else {
+                        acc.n = scale_down_limbs<kMode>(acc.limbs, acc.n, -exp, negative,
+                                                        acc.inexact);
+                }
+                return store(result, acc.limbs, acc.n, negative, scale, overflow);
+        }
+
+        // 1 / (u * 10^exp) at the scale with one more digit is 10^(scale + 1 - exp) / u, where
+        // exp <= scale as the power is below 10^(scale + 1). An inexact power is a lower bound,
+        // so that dividing by u + 1 gives a lower bound of the quotient as well.
+        GmpWrapper<kPowProductLimbs + 1> num;
+        num.limbs[0] = 1;
+        num.mpz._mp_size = mul_limbs_power10(num.limbs, 1, scale + 1 - acc.exp);
+        GmpWrapper<kPowLimbs + 1> den;
+        for (int32_t i = 0; i < acc.n; ++i) {
+                den.limbs[i] = acc.limbs[i];
+        }
+        den.mpz._mp_size = acc.n;
+        if (acc.inexact) {
+                mpz_add_ui(&den.mpz, &den.mpz, 1);
+        }
+        GmpWrapper<kPowProductLimbs + 1> q;
+        GmpWrapper<kPowLimbs + 1> r;
+        mpz_tdiv_qr(&q.mpz, &r.mpz, &num.mpz, &den.mpz);
+        int32_t qn = q.mpz._mp_size;
+        qn = scale_down_limbs<kMode>(q.limbs, qn, 1, negative, acc.inexact || !r.is_zero());
+        return store(result, q.limbs, qn, negative, scale, overflow);
+}
+
+template <RoundingMode kMode>
+constexpr inline ErrCode DecimalMath::mul_pow10(Decimal &d, int32_t n, int32_t max_scale) noexcept {
+        if (d.is_poisoned()) {
+                return d.get_error();
+        }
+        const int64_t scale = static_cast<int64_t>(d.m_scale) - n;
+        if (scale >= 0 && scale <= max_scale) {
+                // Only the scale changes
+                d.m_scale = static_cast<int32_t>(scale);
+                return kSuccess;
+        }
+
+        // Room for the carry of rounding as well
+        Gmp640 gv;
+        int32_t size = d.get_magnitude(gv.limbs);
+        const bool negative = d.is_negative();
+        if (scale < 0) {
+                if (size != 0 && d.precision() - scale > kDecimalMaxPrecision) {
+                        return kDecimalMulOverflow;
+                }
+                size = mul_limbs_power10(gv.limbs, size, static_cast<int32_t>(-scale));
+                return store(d, gv.limbs, size, negative, 0, kDecimalMulOverflow);
+        }
+        // Dropping more digits than the value has rounds the same way.
+        const int64_t drop = std::min<int64_t>(scale - max_scale, kDecimalMaxPrecision + 1);
+        size = scale_down_limbs<kMode>(gv.limbs, size, static_cast<int32_t>(drop), negative);
+        return store(d, gv.limbs, size, negative, max_scale, kDecimalMulOverflow);
+}
+
+template <RoundingMode kMode>
+constexpr inline ErrCode DecimalMath::root(const Decimal &d, int32_t n, int32_t scale,
+                                           Decimal &result) noexcept {
+        if (d.is_poisoned()) {
+                const ErrCode err = d.get_error();
+                result.poison(err);
+                return err;
+        }
+        const bool negative = d.is_negative();
+        if (scale < 0 || scale > kDecimalMaxScale || n < 1 || n > kMaxRootDegree ||
+            (negative && n % 2 == 0)) {
+                return kInvalidArgument;
+        }
+
+        // The root of m / 10^s at scale + extra is the root of x = m * 10^(n * (scale + extra) -
+        // s), with at least one extra digit for rounding.
+        const int32_t extra = std::max(1, (d.m_scale + n - 1) / n - scale);
+        const int32_t exp = n * (scale + extra) - d.m_scale;
+        GmpRoot x;
+        int32_t size = d.get_magnitude(x.limbs);
+        if (size == 0) {
+                result = Decimal(0);
+                result.m_scale = scale;
+                return kSuccess;
+        }
+
+        if (n == 2 && size <= 2 && exp <= kMaxInt128Power10) {
+                const __uint128_t m = (static_cast<__uint128_t>(size == 2 ? x.limbs[1] : 0) << 64) |
+                                      x.limbs[0];
+                __uint128_t x128 = 0;
+                if (!__builtin_mul_overflow(m, static_cast<__uint128_t>(kInt128Power10[exp]),
+                                            &x128)) {
+                        const __uint128_t y = x128 >> 64 == 0
+                                                      ? isqrt(static_cast<uint64_t>(x128))
+                                                      : isqrt(x128);
+                        uint64_t limbs[3] = {static_cast<uint64_t>(y),
+                                             static_cast<uint64_t>(y >> 64), 0};
+                        size = scale_down_limbs<kMode>(limbs, normalized_limbs_size(limbs, 2),
+                                                       extra, false, y * y != x128);
+                        return store(result, limbs, size, false, scale, kDecimalValueOutOfRange);
+                }
+        }
+
+        x.mpz._mp_size = mul_limbs_power10(x.limbs, size, exp);
+        GmpRoot y;
+        if (n == 1) {
+                y = x;
+        } else {
+                root_floor(y, x, n);
+        }
+        GmpRoot p;
+        pow_root(p, y, n);
+        size = scale_down_limbs<kMode>(y.limbs, y.mpz._mp_size, extra, negative,
+                                       mpz_cmp(&p.mpz, &x.mpz) != 0);
+        return store(result, y.limbs, size, negative, scale, kDecimalValueOutOfRange);
+}
+
+template <MathFunc kFunc, RoundingMode kMode>
+constexpr inline ErrCode DecimalMath::transcendental(const Decimal &d, int32_t scale,
+                                                     Decimal &result) noexcept {
+        if (d.is_poisoned()) {
+                const ErrCode err = d.get_error();
+                result.poison(err);
+                return err;
+        }
+        if (scale < 0 || scale > kDecimalMaxScale) {
+                return kInvalidArgument;
+        }
+        // d = m / 10^s
+        GmpFixed m;
+        int32_t s = 0;
+        m.mpz._mp_size = d.get_normalized_magnitude(m.limbs, s);
+        const bool negative = d.is_negative();
+        // Bits of 10^scale, rounded up
+        const int32_t scale_bits = (scale * 3322 + 999) / 1000;
+
+        // Results of exp() are computed in fixed point as 2^k * exp(r) with r = d - k * ln 2, so
+        // that the error relative to the result is what matters. Those of ln() and log10() are
+        // absolute.
+        int64_t k = 0;
+        if constexpr (kFunc == MathFunc::kExp) {
+                if (m.mpz._mp_size == 0) {
+                        return store_integer(result, 1, scale);
+                }
+                const double approx =
+                        (negative ? -1 : 1) * mpz_get_d(&m.mpz) * std::pow(10.0, -s);
+                if (approx > (kDecimalMaxPrecision - scale) * kLn10Double + 1) {
+                        return kDecimalValueOutOfRange;
+                }
+                if (approx < -(scale + 1) * kLn10Double - 1) {
+                        // Below a tenth of an ulp, which rounds as any such value does.
+                        uint64_t tiny[2] = {1, 0};
+                        const int32_t tn = scale_down_limbs<kMode>(tiny, 1, 1, false);
+                        return store(result, tiny, tn, false, scale, kDecimalValueOutOfRange);
+                }
+                k = std::llround(approx / kLn2Double);
+        } else {
+                if (m.mpz._mp_size == 0 || negative) {
+                        return kInvalidArgument;
+                }
+                const bool unit = m.mpz._mp_size == 1 && m.limbs[0] == 1;
+                if (unit && (kFunc == MathFunc::kLog10 || s == 0)) {
+                        return store_integer(result, kFunc == MathFunc::kLog10 ? -s : 0, scale);
+                }
+                // m = f * 2^k with f in [1/sqrt(2), sqrt(2))
+                long e = 0;
+                const double f = mpz_get_d_2exp(&e, &m.mpz);
+                k = f < 0.7071067811865476 ? e - 1 : e;
+        }
+
+        for (int32_t guard = kMinGuardBits;; guard += 64) {
+                GmpFixed c;
+                GmpFixed t;
+                int32_t w = guard + kFixedMarginBits;
+                if constexpr (kFunc == MathFunc::kExp) {
+                        w += kExpReduceSteps;
+                        w += static_cast<int32_t>(std::max<int64_t>(0, k + scale_bits));
+                        // r = m * 2^w / 10^s - k * ln 2
+                        GmpFixed r;
+                        if (s >= 0) {
+                                mpz_mul_2exp(&r.mpz, &m.mpz, w);
+                                mpz_tdiv_q(&r.mpz, &r.mpz, &kGmp320Power10[s].mpz);
+                        } else {
+                                mpz_mul(&r.mpz, &m.mpz, &kGmp320Power10[-s].mpz);
+                                mpz_mul_2exp(&r.mpz, &r.mpz, w);
+                        }
+                        if (negative) {
+                                mpz_neg(&r.mpz, &r.mpz);
+                        }
+                        log_constant(c, kLn2Fixed, w);
+                        if (k >= 0) {
+                                mpz_submul_ui(&r.mpz, &c.mpz, static_cast<uint64_t>(k));
+                        } else {
+                                mpz_addmul_ui(&r.mpz, &c.mpz, static_cast<uint64_t>(-k));
+                        }
+                        exp_fixed(t, r, w);
+                        mpz_mul(&t.mpz, &t.mpz, &kGmp320Power10[scale].mpz);
+                        const int64_t shift = k + guard - w;
+                        if (shift >= 0) {
+                                mpz_mul_2exp(&t.mpz, &t.mpz, shift);
+                        } else {
+                                mpz_tdiv_q_2exp(&t.mpz, &t.mpz, -shift);
+                        }
+                } else {
+                        w += kLnReduceSteps + 1 + scale_bits;
+                        // ln(m / 10^s) = ln(f) + k * ln 2 - s * ln 10
+                        GmpFixed f;
+                        if (w >= k) {
+                                mpz_mul_2exp(&f.mpz, &m.mpz, w - k);
+                        } else {
+                                mpz_tdiv_q_2exp(&f.mpz, &m.mpz, k - w);
+                        }
+                        ln_fixed(t, f, w);
+                        log_constant(c, kLn2Fixed, w);
+                        if (k >= 0) {
+                                mpz_addmul_ui(&t.mpz, &c.mpz, static_cast<uint64_t>(k));
+                        } else {
+                                mpz_submul_ui(&t.mpz, &c.mpz, static_cast<uint64_t>(-k));
+                        }
+                        log_constant(c, kLn10Fixed, w);
+                        if (s >= 0) {
+                                mpz_submul_ui(&t.mpz, &c.mpz, static_cast<uint64_t>(s));
+                        } else {
+                                mpz_addmul_ui(&t.mpz, &c.mpz, static_cast<uint64_t>(-s));
+                        }
+                        if constexpr (kFunc == MathFunc::kLog10) {
+                                mpz_mul_2exp(&t.mpz, &t.mpz, w);
+                                mpz_tdiv_q(&t.mpz, &t.mpz, &c.mpz);
+                        }
+                        mpz_mul(&t.mpz, &t.mpz, &kGmp320Power10[scale].mpz);
+                        mpz_tdiv_q_2exp(&t.mpz, &t.mpz, w - guard);
+                }
+                const bool t_negative = mpz_sgn(&t.mpz) < 0;
+                mpz_abs(&t.mpz, &t.mpz);
+                ErrCode err = kSuccess;
+                if (round_fixed<kMode>(t, guard, t_negative, scale, result, err)) {
+                        return err;
+                }
+        }
+}
+}  // namespace detail
+
+//=-----------------------------------------------------------------------------
+// Powers of decimals.
+//
+// pow(base, n) is base^n by exponentiation by squaring, rounded once (with kMode) rather than at
+// every step as with repeated `*=`, e.g., for compound interest:
+//
+//   Decimal factor = pow(Decimal("1.0001"), 365);  // (1 + r)^n
+//
+// The result has the scale of the exact product, n times that of base, up to the max scale of
+// the DecimalContext, and 1 / base^-n for n < 0 has the max scale. Results of small operands
+// are computed in int128. Otherwise, the intermediate powers keep 133 significant digits, which
+// are exact unless the exact power has more digits than that, as for large n. Returns
+// kDecimalMulOverflow (or kDecimalDivOverflow for n < 0) if the result exceeds the max precision,
+// kDivByZero for 0^n with n < 0, or the error of a poisoned base, which poisons the result.
+// 0^0 is 1.
+//
+// pow10(n) is 10^n for n in [-kMaxScale, kMaxPrecision), and mul_pow10(d, n) multiplies d by
+// 10^n, which only changes the scale of d as long as it stays in [0, max scale].
+//=-----------------------------------------------------------------------------
+
+template <RoundingMode kMode = RoundingMode::kHalfUp>
+constexpr inline ErrCode pow(const Decimal &base, int64_t n, Decimal &result) noexcept {
+        return detail::DecimalMath::pow<kMode>(base, n, result,
+                                               detail::current_decimal_context().max_scale);
+}
+
+template <RoundingMode kMode = RoundingMode::kHalfUp>
+constexpr inline Decimal pow(const Decimal &base, int64_t n) {
+        Decimal result;
+        ErrCode err = pow<kMode>(base, n, result);
+        __BIGNUM_CHECK_ERROR(!err, "Decimal pow err");
+        return result;
+}
+
+constexpr inline Decimal pow10(int32_t n) {
+        __BIGNUM_CHECK_ERROR(n >= -Decimal::kMaxScale && n < Decimal::kMaxPrecision,
+                             "Invalid exponent of pow10");
+        return detail::DecimalMath::pow10(n);
+}
+
+template <RoundingMode kMode = RoundingMode::kHalfUp>
+constexpr inline ErrCode mul_pow10(Decimal &d, int32_t n) noexcept {
+        return detail::DecimalMath::mul_pow10<kMode>(d, n,
+                                                     detail::current_decimal_context().max_scale);
+}
+
+//=-----------------------------------------------------------------------------
+// Roots of decimals.
+//
+// sqrt(d, scale) and nth_root(d, n, scale) are the square root and the n-th root of d (n in
+// [1, kMaxRootDegree]) at the given scale in [0, kMaxScale], rounded with kMode from the exact
+// root, e.g., sqrt(Decimal(2), 4) is 1.4142. They are integer Newton iterations on the payload
+// scaled up to the result scale, in int64 or int128 for square roots of small values, and in
+// wider integers otherwise. A double only seeds the iteration with a value at least the root,
+// from which it converges to the exact integer root, so the result is exact. Return
+// kInvalidArgument for an invalid scale or degree, or the even root of a negative value, or the
+// error of a poisoned d, which poisons the result.
+//=-----------------------------------------------------------------------------
+
+template <RoundingMode kMode = RoundingMode::kHalfUp>
+constexpr inline ErrCode sqrt(const Decimal &d, int32_t scale, Decimal &result) noexcept {
+        return detail::DecimalMath::root<kMode>(d, 2, scale, result);
+}
+
+template <RoundingMode kMode = RoundingMode::kHalfUp>
+constexpr inline Decimal sqrt(const Decimal &d, int32_t scale) {
+        Decimal result;
+        ErrCode err = sqrt<kMode>(d, scale, result);
+        __BIGNUM_CHECK_ERROR(!err, "Decimal sqrt err");
+        return result;
+}
+
+template <RoundingMode kMode = RoundingMode::kHalfUp>
+constexpr inline ErrCode nth_root(const Decimal &d, int32_t n, int32_t scale,
+                                  Decimal &result) noexcept {
+        return detail::DecimalMath::root<kMode>(d, n, scale, result);
+}
+
+template <RoundingMode kMode = RoundingMode::kHalfUp>
+constexpr inline Decimal nth_root(const Decimal &d, int32_t n, int32_t scale) {
+        Decimal result;
+        ErrCode err = nth_root<kMode>(d, n, scale, result);
+        __BIGNUM_CHECK_ERROR(!err, "Decimal nth_root err");
+        return result;
+}
+
+//=-----------------------------------------------------------------------------
+// Exponentials and logarithms of decimals.
+//
+// exp(d, scale), ln(d, scale) and log10(d, scale) are e^d, the natural logarithm and the base-10
+// logarithm of d at the given scale in [0, kMaxScale], correctly rounded with kMode, e.g.,
+// ln(Decimal(2), 4) is 0.6931. They are series evaluations in binary fixed point on wide
+// integers, with a few hundred bits at most: exp() reduces d by multiples of ln 2 and halvings
+// before its Taylor series, and ln() takes square roots before the series of atanh. ln 2 and
+// ln 10 come from constant tables. Doubles only pick the multiple k of ln 2 to reduce by, and
+// spot exp() results far out of range or far below an ulp, with a margin much larger than their
+// error; the result is computed from the exact d either way. Exact results, such as exp(0),
+// ln(1) and log10(1000), are exact in any rounding mode. Return kDecimalValueOutOfRange if exp()
+// exceeds the max precision, kInvalidArgument for an invalid scale or the logarithm of a
+// non-positive value, or the error of a poisoned d, which poisons the result.
+//=-----------------------------------------------------------------------------
+
+template <RoundingMode kMode = RoundingMode::kHalfUp>
+constexpr inline ErrCode exp(const Decimal &d, int32_t scale, Decimal &result) noexcept {
+        return detail::DecimalMath::transcendental<detail::MathFunc::kExp, kMode>(d, scale, result);
+}
+
+template <RoundingMode kMode = RoundingMode::kHalfUp>
+constexpr inline Decimal exp(const Decimal &d, int32_t scale) {
+        Decimal result;
+        ErrCode err = exp<kMode>(d, scale, result);
+        __BIGNUM_CHECK_ERROR(!err, "Decimal exp err");
+        return result;
+}
+
+template <RoundingMode kMode = RoundingMode::kHalfUp>
+constexpr inline ErrCode ln(const Decimal &d, int32_t scale, Decimal &result) noexcept {
+        return detail::DecimalMath::transcendental<detail::MathFunc::kLn, kMode>(d, scale, result);
+}
+
+template <RoundingMode kMode = RoundingMode::kHalfUp>
+constexpr inline Decimal ln(const Decimal &d, int32_t scale) {
+        Decimal result;
+        ErrCode err = ln<kMode>(d, scale, result);
+        __BIGNUM_CHECK_ERROR(!err, "Decimal ln err");
+        return result;
+}
+
+template <RoundingMode kMode = RoundingMode::kHalfUp>
+constexpr inline ErrCode log10(const Decimal &d, int32_t scale, Decimal &result) noexcept {
+        return detail::DecimalMath::transcendental<detail::MathFunc::kLog10, kMode>(d, scale,
+                                                                                    result);
+}
+
+template <RoundingMode kMode = RoundingMode::kHalfUp>
+constexpr inline Decimal log10(const Decimal &d, int32_t scale) {
+        Decimal result;
+        ErrCode err = log10<kMode>(d, scale, result);
+        __BIGNUM_CHECK_ERROR(!err, "Decimal log10 err");
+        return result;
+}
+}  // namespace bignum
@@ -0,0 +1,145 @@
+/*
+ * This file is part of bignum.
+ *
+ * bignum is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * bignum is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bignum.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2024-present  bignum developers
+ */
+#pragma once
+
+#include "decimal.h"
+#include "decimal_column.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+namespace bignum {
+namespace detail {
+// Below this number of values, a reduction is never split across threads.
+constexpr size_t kMinParallelReduceSize = 1 << 16;
+
+// Index of the first smallest (or largest if kMax) payload in [begin, end) that is not
+// kWideMarker, or end if there is none.
+//
+// Payloads are mapped to unsigned keys in the same order, where kWideMarker becomes the identity
+// of the reduction (0 for max, and the maximum for min), so that the loop has no branches and is
+// vectorized. The index is found with a second pass over the chunk.
+template <bool kMax, typename T>
+inline size_t arg_extreme_payload(std::span<const T> payload, size_t begin, size_t end) {
+        using U = UnsignedPayload<T>;
+        constexpr U kMarker = static_cast<U>(DecimalColumnImpl<T>::kWideMarker);
+        constexpr U kIdentity = kMax ? 0 : ~U{0};
+        auto key = [](T x) -> U {
+                if constexpr (kMax) {
+                        return static_cast<U>(x) - kMarker;
+                } else {
+                        return static_cast<U>(x) - kMarker - 1;
+                }
+        };
+
+        const T *p = payload.data();
+        U best = kIdentity;
+        for (size_t i = begin; i < end; ++i) {
+                if constexpr (kMax) {
+                        best = std::max(best, key(p[i]));
+                } else {
+                        best = std::min(best, key(p[i]));
+                }
+        }
+        if (best == kIdentity) {
+                return end;
+        }
+        size_t i = begin;
+        while (key(p[i]) != best) {
+                ++i;
+        }
+        return i;
+}
+
+template <bool kMax, typename T>
+inline size_t arg_extreme(const DecimalColumnImpl<T> &column, int32_t num_threads) {
+        const size_t n = column.size();
+        if (n < kMinParallelReduceSize || num_threads < 1) {
+                num_threads = 1;
+        }
+        const std::span<const T> payload = column.payload();
+        std::vector<size_t> found(num_threads, n);
+        parallel_for_chunks(n, num_threads, [&](size_t begin, size_t end, int32_t t) {
+                const size_t i = arg_extreme_payload<kMax>(payload, begin, end);
+                found[t] = i == end ? n : i;
+        });
+
+        // Chunks are in ascending order, so the first of equal payloads is kept.
+        size_t result = n;
+        for (size_t i : found) {
+                if (i != n && (result == n || (kMax ? payload[i] > payload[result]
+                                                    : payload[i] < payload[result]))) {
+                        result = i;
+                }
+        }
+
+        // Values in the side table are compared as decimals.
+        const std::span<const size_t> indices = column.wide_indices();
+        const std::span<const Decimal> values = column.wide_values();
+        Decimal best;
+        if (result != n) {
+                best = column[result];
+        }
+        for (size_t k = 0; k < indices.size(); ++k) {
+                const Decimal &v = values[k];
+                if (result == n || (kMax ? v > best : v < best) ||
+                    (v == best && indices[k] < result)) {
+                        result = indices[k];
+                        best = v;
+                }
+        }
+        return result;
+}
+}  // namespace detail
+
+//=-----------------------------------------------------------------------------
+// Reductions over a decimal column, e.g., for zone maps or limit checks.
+//
+// The payloads are reduced directly as integers, several per instruction, and only the values
+// in the side table of the column are compared as decimals. The reduction is split across
+// num_threads threads for large columns.
+//
+// argmin() and argmax() return the index of the first smallest or largest value, or
+// column.size() if the column is empty. min() and max() require a non-empty column.
+//=-----------------------------------------------------------------------------
+
+template <typename T>
+inline size_t argmin(const DecimalColumnImpl<T> &column, int32_t num_threads = 1) {
+        return detail::arg_extreme<false>(column, num_threads);
+}
+
+template <typename T>
+inline size_t argmax(const DecimalColumnImpl<T> &column, int32_t num_threads = 1) {
+        return detail::arg_extreme<true>(column, num_threads);
+}
+
+template <typename T>
+inline Decimal min(const DecimalColumnImpl<T> &column, int32_t num_threads = 1) {
+        __BIGNUM_ASSERT(!column.empty());
+        return column[argmin(column, num_threads)];
+}
+
+template <typename T>
+inline Decimal max(const DecimalColumnImpl<T> &column, int32_t num_threads = 1) {
+        __BIGNUM_ASSERT(!column.empty());
+        return column[argmax(column, num_threads)];
+}
+}  // namespace bignum
@@ -0,0 +1,261 @@
+/*
+ * This file is part of bignum.
+ *
+ * bignum is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * bignum is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bignum.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2024-present  bignum developers
+ */
+#pragma once
+
+#include "decimal.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <array>
+#include <span>
+#include <vector>
+
+namespace bignum {
+namespace detail {
+// Below this number of values, sorting is never split across threads.
+constexpr size_t kMinParallelSortSize = 1 << 16;
+
+template <typename K>
+struct RadixSortEntry {
+        K key;
+        uint32_t index;
+};
+
+// Stable LSD radix sort of entries by get_byte(entry, pass) for pass in [0, num_passes), the
+// least significant byte first. A pass is skipped if all entries have the same byte there, e.g.,
+// the high bytes of keys in a narrow range.
+template <typename E, typename GetByte>
+inline void radix_sort(std::vector<E> &entries, int32_t num_passes, GetByte get_byte,
+                       int32_t num_threads) {
+        constexpr int32_t kMaxPasses = 16;
+        using Histogram = std::array<size_t, 256>;
+        __BIGNUM_ASSERT(num_passes <= kMaxPasses);
+        const size_t n = entries.size();
+
+        // Counts of every byte do not change with the order of entries, so they are counted once
+        // for all passes, per thread.
+        std::vector<std::array<Histogram, kMaxPasses>> counts(num_threads);
+        parallel_for_chunks(n, num_threads, [&](size_t begin, size_t end, int32_t t) {
+                std::array<Histogram, kMaxPasses> &c = counts[t];
+                for (int32_t pass = 0; pass < num_passes; ++pass) {
+                        c[pass].fill(0);
+                }
+                for (size_t i = begin; i < end; ++i) {
+                        for (int32_t pass = 0; pass < num_passes; ++pass) {
+                                c[pass][get_byte(entries[i], pass)]++;
+                        }
+                }
+        });
+
+        std::vector<E> buffer(n);
+        E *src = entries.data();
+        E *dst = buffer.data();
+        std::vector<Histogram> offsets(num_threads);
+        for (int32_t pass = 0; pass < num_passes; ++pass) {
+                const uint8_t first = get_byte(src[0], pass);
+                size_t same = 0;
+                for (int32_t t = 0; t < num_threads; ++t) {
+                        same += counts[t][pass][first];
+                }
+                if (same == n) {
+                        continue;
+                }
+
+                // With more threads, each thread scatters its own chunk, which contains different
+                // entries after every pass, so the chunks are counted again.
+                if (num_threads > 1) {
+                        auto count = [&](size_t begin, size_t end, int32_t t) {
+                                Histogram &c = counts[t][pass];
+                                c.fill(0);
+                                for (size_t i = begin; i < end; ++i) {
+                                        c[get_byte(src[i], pass)]++;
+                                }
+                        };
+                        parallel_for_chunks(n, num_threads, count);
+                }
+                size_t offset = 0;
+                for (int32_t b = 0; b < 256; ++b) {
+                        for (int32_t t = 0; t < num_threads; ++t) {
+                                offsets[t][b] = offset;
+                                offset += counts[t][pass][b];
+                        }
+                }
+                parallel_for_chunks(n, num_threads, [&](size_t begin, size_t end, int32_t t) {
+                        Histogram &o = offsets[t];
+                        for (size_t i = begin; i < end; ++i) {
+                                dst[o[get_byte(src[i], pass)]++] = src[i];
+                        }
+                });
+                std::swap(src, dst);
+        }
+        if (src != entries.data()) {
+                entries.swap(buffer);
+        }
+}
+
+// Sort keys are the values at the largest scale among them as int128, minus the smallest key so
+// that they are unsigned and order preserving, and need key_bits bits only.
+//
+// If key_bits plus the bits of an index fit into 64 bits, which is the case for most columns,
+// e.g., prices, each key is packed together with its index into a single word, so that the
+// entries take 8 bytes rather than 16 or 32.
+inline void radix_argsort(std::span<const Decimal> values, int32_t scale, __int128_t min_key,
+                          int32_t key_bits, std::span<uint32_t> indices, int32_t num_threads) {
+        const size_t n = values.size();
+        const int32_t num_passes = (key_bits + 7) / 8;
+        auto get_key = [&](size_t i) {
+                __int128_t key = 0;
+                (void)values[i].to_scaled_int128(scale, key);
+                return static_cast<__uint128_t>(key) - static_cast<__uint128_t>(min_key);
+        };
+
+        const int32_t index_bits = n > 1 ? 64 - __builtin_clzll(n - 1) : 0;
+        if (key_bits + index_bits <= 64) {
+                std::vector<uint64_t> words(n);
+                parallel_for_chunks(n, num_threads, [&](size_t begin, size_t end, int32_t) {
+                        for (size_t i = begin; i < end; ++i) {
+                                words[i] = (static_cast<uint64_t>(get_key(i)) << index_bits) | i;
+                        }
+                });
+                auto get_byte = [index_bits](uint64_t word, int32_t pass) {
+                        return static_cast<uint8_t>(word >> (index_bits + pass * 8));
+                };
+                radix_sort(words, num_passes, get_byte, num_threads);
+                const uint64_t index_mask = (uint64_t{1} << index_bits) - 1;
+                for (size_t i = 0; i < n; ++i) {
+                        indices[i] = static_cast<uint32_t>(words[i] & index_mask);
+                }
+        } else if (key_bits <= 64) {
+                std::vector<RadixSortEntry<uint64_t>> entries(n);
+                parallel_for_chunks(n, num_threads, [&](size_t begin, size_t end, int32_t) {
+                        for (size_t i = begin; i < end; ++i) {
+                                entries[i] = {static_cast<uint64_t>(get_key(i)),
+                                              static_cast<uint32_t>(i)};
+                        }
+                });
+                auto get_byte = [](const RadixSortEntry<uint64_t> &e, int32_t pass) {
+                        return static_cast<uint8_t>(e.key >> (pass * 8));
+                };
+                radix_sort(entries, num_passes, get_byte, num_threads);
+                for (size_t i = 0; i < n; ++i) {
+                        indices[i] = entries[i].index;
+                }
+        } else {
+                std::vector<RadixSortEntry<__uint128_t>> entries(n);
+                parallel_for_chunks(n, num_threads, [&](size_t begin, size_t end, int32_t) {
+                        for (size_t i = begin; i < end; ++i) {
+                                entries[i] = {get_key(i), static_cast<uint32_t>(i)};
+                        }
+                });
+                auto get_byte = [](const RadixSortEntry<__uint128_t> &e, int32_t pass) {
+                        return static_cast<uint8_t>(e.key >> (pass * 8));
+                };
+                radix_sort(entries, num_passes, get_byte, num_threads);
+                for (size_t i = 0; i < n; ++i) {
+                        indices[i] = entries[i].index;
+                }
+        }
+}
+}  // namespace detail
+
+//=-----------------------------------------------------------------------------
+// Sort a column of decimals, much faster than std::sort() which compares two decimals (with a
+// dispatch on their representations and maybe a rescale) O(n log n) times.
+//
+// Values are converted once to fixed width integer keys at the largest scale among them, which
+// are radix sorted with their indices. If some value does not fit into int128 at that scale,
+// the sort falls back to std::stable_sort(). Both are stable, i.e., values that compare equal
+// (such as "1.5" and "1.50") keep their order. Poisoned values (see Decimal::is_poisoned()), which
+// compare with nothing, take the fallback and come last.
+//
+// The sort is split across num_threads threads for large inputs. At most UINT32_MAX values.
+//=-----------------------------------------------------------------------------
+
+// indices[i] is the index of the i-th smallest value. indices must have the size of values.
+inline void argsort(std::span<const Decimal> values, std::span<uint32_t> indices,
+                    int32_t num_threads = 1) {
+        __BIGNUM_ASSERT(values.size() == indices.size());
+        __BIGNUM_ASSERT(values.size() <= UINT32_MAX);
+        const size_t n = values.size();
+        if (n < detail::kMinParallelSortSize || num_threads < 1) {
+                num_threads = 1;
+        }
+
+        int32_t scale = 0;
+        for (const Decimal &v : values) {
+                scale = std::max(scale, v.get_scale());
+        }
+        bool fits = true;
+        __int128_t min_key = detail::kInt128Max;
+        __int128_t max_key = detail::kInt128Min;
+        for (const Decimal &v : values) {
+                __int128_t key = 0;
+                if (v.is_poisoned() || v.to_scaled_int128(scale, key)) {
+                        fits = false;
+                        break;
+                }
+                min_key = std::min(min_key, key);
+                max_key = std::max(max_key, key);
+        }
+
+        if (n == 0) {
+                return;
+        } else if (!fits) {
+                for (size_t i = 0; i < n; ++i) {
+                        indices[i] = static_cast<uint32_t>(i);
+                }
+                std::stable_sort(indices.begin(), indices.end(), [&](uint32_t a, uint32_t b) {
+                        const bool a_poisoned = values[a].is_poisoned();
+                        const bool b_poisoned = values[b].is_poisoned();
+                        if (a_poisoned || b_poisoned) {
+                                return !a_poisoned;
+                        }
+                        return values[a] < values[b];
+                });
+        } else {
+                const __uint128_t range =
+                        static_cast<__uint128_t>(max_key) - static_cast<__uint128_t>(min_key);
+                const uint64_t hi = static_cast<uint64_t>(range >> 64);
+                const uint64_t lo = static_cast<uint64_t>(range);
+                int32_t key_bits = 0;
+                if (hi) {
+                        key_bits = 128 - __builtin_clzll(hi);
+                } else if (lo) {
+                        key_bits = 64 - __builtin_clzll(lo);
+                }
+                detail::radix_argsort(values, scale, min_key, key_bits, indices, num_threads);
+        }
+}
+
+inline void sort(std::span<Decimal> values, int32_t num_threads = 1) {
+        std::vector<uint32_t> indices(values.size());
+        argsort(values, indices, num_threads);
+        std::vector<Decimal> sorted;
+        sorted.reserve(values.size());
+        // Values are gathered in random order, so fetch a few of them ahead.
+        constexpr size_t kPrefetchDistance = 8;
+        for (size_t i = 0; i < indices.size(); ++i) {
+                if (i + kPrefetchDistance < indices.size()) {
+                        __builtin_prefetch(&values[indices[i + kPrefetchDistance]]);
+                }
+                sorted.push_back(values[indices[i]]);
+        }
+        std::copy(sorted.begin(), sorted.end(), values.begin());
+}
+}  // namespace bignum
@@ -0,0 +1,71 @@
+/*
+ * This file is part of bignum.
+ *
+ * bignum is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * bignum is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bignum.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2024-present  bignum developers
+ */
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+namespace bignum {
+//=-----------------------------------------------------------------------------
+// Per-thread counters of arithmetic operations, broken down by the internal representation
+// (int64, int128, int256 or gmp) the operation was dispatched on, i.e., the wider of the two
+// operands. Useful to check how often a workload hits the fast integer paths.
+//
+// Counting is compiled in only if BIGNUM_ENABLE_STATS is defined; otherwise all counters stay
+// zero and there is no runtime overhead. Operations evaluated at compile time are not counted.
+//=-----------------------------------------------------------------------------
+struct DecimalStats {
+        // Same order as the internal representation of Decimal
+        enum Tier : int32_t { kInt64 = 0, kInt128 = 1, kInt256 = 2, kGmp = 3, kNumTiers = 4 };
+
+        enum Op : int32_t { kAdd = 0, kSub = 1, kMul = 2, kDiv = 3, kMod = 4, kNumOps = 5 };
+
+        uint64_t counts[kNumOps][kNumTiers] = {};
+
+        uint64_t get(Op op, Tier tier) const { return counts[op][tier]; }
+
+        uint64_t total(Op op) const {
+                uint64_t sum = 0;
+                for (int32_t t = 0; t < kNumTiers; ++t) {
+                        sum += counts[op][t];
+                }
+                return sum;
+        }
+};
+
+namespace detail {
+inline thread_local DecimalStats tls_decimal_stats;
+
+constexpr inline void count_decimal_op(DecimalStats::Op op, int32_t tier) noexcept {
+#ifdef BIGNUM_ENABLE_STATS
+        if (!std::is_constant_evaluated()) {
+                tls_decimal_stats.counts[op][tier]++;
+        }
+#else
+        (void)op;
+        (void)tier;
+#endif
+}
+}  // namespace detail
+
+// Counters of the calling thread.
+inline const DecimalStats &get_decimal_stats() noexcept { return detail::tls_decimal_stats; }
+
+inline void reset_decimal_stats() noexcept { detail::tls_decimal_stats = DecimalStats{}; }
+}  // namespace bignum
@@ -0,0 +1,174 @@
+/*
+ * This file is part of bignum.
+ *
+ * bignum is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * bignum is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bignum.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2024-present  bignum developers
+ */
+#pragma once
+
+#include "decimal.h"
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <vector>
+
+namespace bignum {
+//=-----------------------------------------------------------------------------
+// Aggregates over a sliding window of the last `window` values pushed, e.g., the rolling sum of
+// prices over the last 1000 ticks, updated in O(1) amortized time per value rather than O(window)
+// for summing up the window again.
+//
+// The results are exactly those of a recomputation over the values in the window, including the
+// scale, e.g., the sum is the value of `Decimal(0) += v` for every v in the window, and the
+// average is that divided by the number of values:
+//
+//   RollingSum sum(/*window=*/3);
+//   for (const Decimal &price : prices) {
+//           sum.push(price);
+//           Decimal avg = sum.avg();
+//   }
+//=-----------------------------------------------------------------------------
+
+// Sum and average by adding the value that enters the window and subtracting the one that
+// leaves. The sum is a Decimal, which widens to int128, int256 or gmp as needed, so it is exact.
+class RollingSum final {
+       public:
+        explicit RollingSum(size_t window) : m_window(window) {
+                __BIGNUM_CHECK_ERROR(window > 0, "Window of rolling sum must not be empty");
+                m_values.reserve(window);
+        }
+
+        size_t window() const { return m_window; }
+        size_t size() const { return m_values.size(); }
+        bool empty() const { return m_values.empty(); }
+
+        void push(const Decimal &value);
+        void clear();
+
+        const Decimal &sum() const { return m_sum; }
+        // Requires a non-empty window.
+        Decimal avg() const {
+                __BIGNUM_ASSERT(!empty());
+                return m_sum / Decimal(static_cast<int64_t>(size()));
+        }
+
+       private:
+        size_t m_window = 0;
+        // Values in the window as a ring buffer, where m_values[m_oldest] leaves next.
+        std::vector<Decimal> m_values;
+        size_t m_oldest = 0;
+
+        // Number of values in the window with each scale. The scale of a recomputed sum is the
+        // largest among them, so the sum drops trailing zeros when the last value of the
+        // largest scale leaves.
+        std::array<size_t, Decimal::kMaxScale + 1> m_scale_counts{};
+        int32_t m_max_scale = 0;
+        Decimal m_sum;
+};
+
+inline void RollingSum::push(const Decimal &value) {
+        const int32_t scale = value.get_scale();
+        if (m_values.size() < m_window) {
+                m_values.push_back(value);
+        } else {
+                // Subtract first, so that the sum never exceeds that of a full window.
+                Decimal &oldest = m_values[m_oldest];
+                m_sum -= oldest;
+                m_scale_counts[oldest.get_scale()]--;
+                oldest = value;
+                m_oldest = m_oldest + 1 == m_window ? 0 : m_oldest + 1;
+        }
+        m_sum += value;
+        m_scale_counts[scale]++;
+
+        m_max_scale = std::max(m_max_scale, scale);
+        while (m_max_scale > 0 && m_scale_counts[m_max_scale] == 0) {
+                m_max_scale--;
+        }
+        if (m_sum.get_scale() > m_max_scale) {
+                // Every value in the window has at most m_max_scale fractional digits
+                ErrCode err = m_sum.trim_scale(m_max_scale);
+                __BIGNUM_ASSERT(!err);
+                (void)err;
+        }
+}
+
+inline void RollingSum::clear() {
+        m_values.clear();
+        m_oldest = 0;
+        m_scale_counts.fill(0);
+        m_max_scale = 0;
+        m_sum = Decimal(0);
+}
+
+// Minimum (or maximum if kMax) with a monotonic deque: a value is dropped once a smaller (or
+// larger) one enters, as it could never be the result again before it leaves the window. Of
+// equal values, the oldest is the result, like std::min_element() over the window.
+template <bool kMax>
+class RollingExtremeImpl final {
+       public:
+        explicit RollingExtremeImpl(size_t window) : m_window(window) {
+                __BIGNUM_CHECK_ERROR(window > 0, "Window of rolling min/max must not be empty");
+        }
+
+        size_t window() const { return m_window; }
+        size_t size() const { return static_cast<size_t>(std::min<uint64_t>(m_count, m_window)); }
+        bool empty() const { return m_count == 0; }
+
+        void push(const Decimal &value);
+        void clear() {
+                m_entries.clear();
+                m_count = 0;
+        }
+
+        // Requires a non-empty window.
+        const Decimal &value() const {
+                __BIGNUM_ASSERT(!empty());
+                return m_entries.front().value;
+        }
+
+       private:
+        struct Entry {
+                // Number of values pushed before this one
+                uint64_t seq;
+                Decimal value;
+        };
+
+        size_t m_window = 0;
+        uint64_t m_count = 0;
+        // Candidates in the order they were pushed, non-decreasing (or non-increasing). Equal
+        // values are all kept, so that the oldest of them is the result and the next one takes
+        // over when it leaves. Popping equal values in push() too would return the newest one
+        // instead, e.g., "1.50" rather than "1.5".
+        std::deque<Entry> m_entries;
+};
+
+using RollingMin = RollingExtremeImpl<false>;
+using RollingMax = RollingExtremeImpl<true>;
+
+template <bool kMax>
+inline void RollingExtremeImpl<kMax>::push(const Decimal &value) {
+        while (!m_entries.empty() &&
+               (kMax ? m_entries.back().value < value : value < m_entries.back().value)) {
+                m_entries.pop_back();
+        }
+        m_entries.push_back(Entry{m_count, value});
+        m_count++;
+        if (m_entries.front().seq + m_window < m_count) {
+                m_entries.pop_front();
+        }
+}
+}  // namespace bignum
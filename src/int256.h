@@ -0,0 +1,223 @@
+/*
+ * This file is part of bignum.
+ *
+ * bignum is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * bignum is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bignum.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2024-present  bignum developers
+ */
+#pragma once
+
+#include "errcode.h"
+
+#include <cstdint>
+
+namespace bignum {
+namespace detail {
+//=-----------------------------------------------------------------------------
+// Signed 256-bit integer (two's complement) made of two 128-bit halves.
+//
+// This is the internal representation between __int128_t and gmp. It holds any integer of up to
+// 76 digits, which covers most intermediate multiplication results and large values with high
+// scale, without calling into gmp. Only the operations needed by Decimal are provided, all of
+// them constexpr.
+//=-----------------------------------------------------------------------------
+struct Int256 {
+        constexpr static int32_t kNumLimbs = 4;
+
+        __uint128_t lo;
+        __int128_t hi;
+
+        Int256() = default;
+        constexpr explicit Int256(__int128_t v) : lo(static_cast<__uint128_t>(v)), hi(v >> 127) {}
+        constexpr Int256(__int128_t h, __uint128_t l) : lo(l), hi(h) {}
+
+        constexpr bool operator==(const Int256 &rhs) const = default;
+
+        constexpr bool is_negative() const { return hi < 0; }
+        constexpr bool is_zero() const { return hi == 0 && lo == 0; }
+
+        // Whether the value fits into a __int128_t.
+        constexpr bool fits_int128() const {
+                return hi == (static_cast<__int128_t>(lo) >> 127);
+        }
+
+        // Two's complement negation. The minimum value stays as is.
+        constexpr Int256 twos_complement() const {
+                __uint128_t l = ~lo + 1;
+                __uint128_t h = ~static_cast<__uint128_t>(hi) + (l == 0 ? 1 : 0);
+                return Int256(static_cast<__int128_t>(h), l);
+        }
+
+        // Copy the magnitude into `limbs` (kNumLimbs limbs, least significant limb first).
+        // Return the number of limbs without the most significant zero limbs.
+        constexpr int32_t get_magnitude(uint64_t *limbs) const {
+                Int256 mag = is_negative() ? twos_complement() : *this;
+                __uint128_t h = static_cast<__uint128_t>(mag.hi);
+                limbs[0] = static_cast<uint64_t>(mag.lo);
+                limbs[1] = static_cast<uint64_t>(mag.lo >> 64);
+                limbs[2] = static_cast<uint64_t>(h);
+                limbs[3] = static_cast<uint64_t>(h >> 64);
+                int32_t n = kNumLimbs;
+                while (n > 0 && limbs[n - 1] == 0) {
+                        n--;
+                }
+                return n;
+        }
+
+        // Whether a magnitude of n limbs (least significant limb first) fits into Int256 with
+        // the given sign.
+        static constexpr bool magnitude_fits(const uint64_t *limbs, int32_t n, bool negative) {
+                if (n < kNumLimbs) {
+                        return true;
+                } else if (n > kNumLimbs) {
+                        return false;
+                }
+                constexpr uint64_t kSignBit = 1ull << 63;
+                if (limbs[3] < kSignBit) {
+                        return true;
+                }
+                // -2^255
+                return negative && limbs[3] == kSignBit && limbs[2] == 0 && limbs[1] == 0 &&
+                       limbs[0] == 0;
+        }
+
+        // Caller guarantees that magnitude_fits(limbs, n, negative).
+        static constexpr Int256 from_magnitude(const uint64_t *limbs, int32_t n, bool negative) {
+                uint64_t l[kNumLimbs] = {0, 0, 0, 0};
+                for (int32_t i = 0; i < n && i < kNumLimbs; ++i) {
+                        l[i] = limbs[i];
+                }
+                Int256 v(static_cast<__int128_t>((static_cast<__uint128_t>(l[3]) << 64) | l[2]),
+                         (static_cast<__uint128_t>(l[1]) << 64) | l[0]);
+                return negative ? v.twos_complement() : v;
+        }
+};
+
+constexpr Int256 kInt256Max = Int256(static_cast<__int128_t>(~static_cast<__uint128_t>(0) >> 1),
+                                     ~static_cast<__uint128_t>(0));
+constexpr Int256 kInt256Min = Int256(static_cast<__int128_t>(static_cast<__uint128_t>(1) << 127),
+                                     0);
+
+constexpr inline int cmp_int256(const Int256 &a, const Int256 &b) {
+        if (a.hi != b.hi) {
+                return a.hi < b.hi ? -1 : 1;
+        } else if (a.lo != b.lo) {
+                return a.lo < b.lo ? -1 : 1;
+        }
+        return 0;
+}
+
+constexpr inline ErrCode safe_add(Int256 &res, const Int256 &lhs, const Int256 &rhs) noexcept {
+        __uint128_t lo = 0;
+        const bool carry = __builtin_add_overflow(lhs.lo, rhs.lo, &lo);
+
+        // The high halves overflow iff exactly one of the two additions overflows: if both
+        // overflow, the first one wraps around and the carry brings it back into range.
+        __int128_t hi = 0;
+        const bool overflow1 = __builtin_add_overflow(lhs.hi, rhs.hi, &hi);
+        const bool overflow2 = __builtin_add_overflow(hi, static_cast<__int128_t>(carry), &hi);
+        if (overflow1 != overflow2) {
+                return kError;
+        }
+        res = Int256(hi, lo);
+        return kSuccess;
+}
+
+constexpr inline ErrCode safe_sub(Int256 &res, const Int256 &lhs, const Int256 &rhs) noexcept {
+        __uint128_t lo = 0;
+        const bool borrow = __builtin_sub_overflow(lhs.lo, rhs.lo, &lo);
+
+        // Same as safe_add(): overflow iff exactly one of the two subtractions overflows.
+        __int128_t hi = 0;
+        const bool overflow1 = __builtin_sub_overflow(lhs.hi, rhs.hi, &hi);
+        const bool overflow2 = __builtin_sub_overflow(hi, static_cast<__int128_t>(borrow), &hi);
+        if (overflow1 != overflow2) {
+                return kError;
+        }
+        res = Int256(hi, lo);
+        return kSuccess;
+}
+
+constexpr inline ErrCode safe_negate(Int256 &res, const Int256 &v) noexcept {
+        if (v == kInt256Min) {
+                return kError;
+        }
+        res = v.twos_complement();
+        return kSuccess;
+}
+
+// Full 256-bit product of two unsigned 128-bit integers: (hi, lo) = a * b.
+constexpr inline void mul_128_128(__uint128_t &hi, __uint128_t &lo, __uint128_t a,
+                                  __uint128_t b) noexcept {
+        const uint64_t a0 = static_cast<uint64_t>(a);
+        const uint64_t a1 = static_cast<uint64_t>(a >> 64);
+        const uint64_t b0 = static_cast<uint64_t>(b);
+        const uint64_t b1 = static_cast<uint64_t>(b >> 64);
+
+        const __uint128_t p00 = static_cast<__uint128_t>(a0) * b0;
+        const __uint128_t p01 = static_cast<__uint128_t>(a0) * b1;
+        const __uint128_t p10 = static_cast<__uint128_t>(a1) * b0;
+        const __uint128_t p11 = static_cast<__uint128_t>(a1) * b1;
+
+        // Middle column, at most 3 * (2^64 - 1) and thus never overflows
+        const __uint128_t mid =
+                (p00 >> 64) + static_cast<uint64_t>(p01) + static_cast<uint64_t>(p10);
+        lo = (mid << 64) | static_cast<uint64_t>(p00);
+        hi = p11 + (p01 >> 64) + (p10 >> 64) + (mid >> 64);
+}
+
+constexpr inline ErrCode safe_mul(Int256 &res, const Int256 &lhs, const Int256 &rhs) noexcept {
+        const bool negative = lhs.is_negative() != rhs.is_negative();
+        const Int256 l = lhs.is_negative() ? lhs.twos_complement() : lhs;
+        const Int256 r = rhs.is_negative() ? rhs.twos_complement() : rhs;
+        // Magnitudes, kInt256Min gives 2^255 as expected
+        const __uint128_t lh = static_cast<__uint128_t>(l.hi);
+        const __uint128_t rh = static_cast<__uint128_t>(r.hi);
+
+        __uint128_t hi = 0;
+        __uint128_t lo = 0;
+        if (lh == 0 && rh == 0) {
+                mul_128_128(hi, lo, l.lo, r.lo);
+        } else if (lh != 0 && rh != 0) {
+                return kError;  // >= 2^256
+        } else {
+                // (h * 2^128 + x) * y = h * y * 2^128 + x * y
+                const __uint128_t h = lh != 0 ? lh : rh;
+                const __uint128_t x = lh != 0 ? l.lo : r.lo;
+                const __uint128_t y = lh != 0 ? r.lo : l.lo;
+                __uint128_t cross = 0;
+                if (__builtin_mul_overflow(h, y, &cross)) {
+                        return kError;
+                }
+                mul_128_128(hi, lo, x, y);
+                if (__builtin_add_overflow(hi, cross, &hi)) {
+                        return kError;
+                }
+        }
+
+        constexpr __uint128_t kSignBit = static_cast<__uint128_t>(1) << 127;
+        if (hi >= kSignBit) {
+                // Only -2^255 is representable
+                if (!negative || hi != kSignBit || lo != 0) {
+                        return kError;
+                }
+                res = kInt256Min;
+                return kSuccess;
+        }
+        const Int256 mag(static_cast<__int128_t>(hi), lo);
+        res = negative ? mag.twos_complement() : mag;
+        return kSuccess;
+}
+}  // namespace detail
+}  // namespace bignum
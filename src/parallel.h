@@ -0,0 +1,45 @@
+/*
+ * This file is part of bignum.
+ *
+ * bignum is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * bignum is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bignum.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2024-present  bignum developers
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace bignum {
+namespace detail {
+// Split [0, n) into num_threads chunks and call f(begin, end, t) for chunk t on its own thread.
+template <typename F>
+inline void parallel_for_chunks(size_t n, int32_t num_threads, F &&f) {
+        const size_t chunk = (n + num_threads - 1) / num_threads;
+        std::vector<std::thread> threads;
+        for (int32_t t = 1; t < num_threads; ++t) {
+                threads.emplace_back([&f, n, chunk, t] {
+                        f(std::min(n, t * chunk), std::min(n, (t + 1) * chunk), t);
+                });
+        }
+        f(0, std::min(n, chunk), 0);
+        for (std::thread &thread : threads) {
+                thread.join();
+        }
+}
+}  // namespace detail
+}  // namespace bignum
@@ -0,0 +1,234 @@
+/*
+ * This file is part of bignum.
+ *
+ * bignum is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * bignum is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bignum.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2024-present  bignum developers
+ */
+
+//=--------------------------------------------------------------------
+// Generated by scripts/generate_gmp_pow10.cc, do NOT edit manually.
+//
+// Powers of 10 and round-half-up thresholds for all internal integer
+// widths. All tables are static constexpr data so that lookups never
+// build anything on the stack.
+//=--------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+
+#include "gmp_wrapper.h"
+
+namespace bignum {
+namespace detail {
+constexpr int32_t kMaxUint64Power10 = 19;
+constexpr int32_t kMaxInt128Power10 = 38;
+constexpr int32_t kMaxGmp320Power10 = 96;
+
+/* clang-format off */
+// 10^i
+inline constexpr uint64_t kUint64Power10[kMaxUint64Power10 + 1] = {
+    /* 0  */ 0x1ull,
+    /* 1  */ 0xaull,
+    /* 2  */ 0x64ull,
+    /* 3  */ 0x3e8ull,
+    /* 4  */ 0x2710ull,
+    /* 5  */ 0x186a0ull,
+    /* 6  */ 0xf4240ull,
+    /* 7  */ 0x989680ull,
+    /* 8  */ 0x5f5e100ull,
+    /* 9  */ 0x3b9aca00ull,
+    /* 10 */ 0x2540be400ull,
+    /* 11 */ 0x174876e800ull,
+    /* 12 */ 0xe8d4a51000ull,
+    /* 13 */ 0x9184e72a000ull,
+    /* 14 */ 0x5af3107a4000ull,
+    /* 15 */ 0x38d7ea4c68000ull,
+    /* 16 */ 0x2386f26fc10000ull,
+    /* 17 */ 0x16345785d8a0000ull,
+    /* 18 */ 0xde0b6b3a7640000ull,
+    /* 19 */ 0x8ac7230489e80000ull,
+};
+
+// 10^i / 2, i.e., 5 * 10^(i-1): a remainder of 10^i rounds up iff it is >= this.
+// 0 for i=0 as nothing is rounded.
+inline constexpr uint64_t kUint64HalfPower10[kMaxUint64Power10 + 1] = {
+    /* 0  */ 0x0ull,
+    /* 1  */ 0x5ull,
+    /* 2  */ 0x32ull,
+    /* 3  */ 0x1f4ull,
+    /* 4  */ 0x1388ull,
+    /* 5  */ 0xc350ull,
+    /* 6  */ 0x7a120ull,
+    /* 7  */ 0x4c4b40ull,
+    /* 8  */ 0x2faf080ull,
+    /* 9  */ 0x1dcd6500ull,
+    /* 10 */ 0x12a05f200ull,
+    /* 11 */ 0xba43b7400ull,
+    /* 12 */ 0x746a528800ull,
+    /* 13 */ 0x48c27395000ull,
+    /* 14 */ 0x2d79883d2000ull,
+    /* 15 */ 0x1c6bf52634000ull,
+    /* 16 */ 0x11c37937e08000ull,
+    /* 17 */ 0xb1a2bc2ec50000ull,
+    /* 18 */ 0x6f05b59d3b20000ull,
+    /* 19 */ 0x4563918244f40000ull,
+};
+
+// 10^i
+inline constexpr __int128_t kInt128Power10[kMaxInt128Power10 + 1] = {
+    /* 0  */ (static_cast<__int128_t>(0x0) << 64) | 0x1,
+    /* 1  */ (static_cast<__int128_t>(0x0) << 64) | 0xa,
+    /* 2  */ (static_cast<__int128_t>(0x0) << 64) | 0x64,
+    /* 3  */ (static_cast<__int128_t>(0x0) << 64) | 0x3e8,
+    /* 4  */ (static_cast<__int128_t>(0x0) << 64) | 0x2710,
+    /* 5  */ (static_cast<__int128_t>(0x0) << 64) | 0x186a0,
+    /* 6  */ (static_cast<__int128_t>(0x0) << 64) | 0xf4240,
+    /* 7  */ (static_cast<__int128_t>(0x0) << 64) | 0x989680,
+    /* 8  */ (static_cast<__int128_t>(0x0) << 64) | 0x5f5e100,
+    /* 9  */ (static_cast<__int128_t>(0x0) << 64) | 0x3b9aca00,
+    /* 10 */ (static_cast<__int128_t>(0x0) << 64) | 0x2540be400,
+    /* 11 */ (static_cast<__int128_t>(0x0) << 64) | 0x174876e800,
+    /* 12 */ (static_cast<__int128_t>(0x0) << 64) | 0xe8d4a51000,
+    /* 13 */ (static_cast<__int128_t>(0x0) << 64) | 0x9184e72a000,
+    /* 14 */ (static_cast<__int128_t>(0x0) << 64) | 0x5af3107a4000,
+    /* 15 */ (static_cast<__int128_t>(0x0) << 64) | 0x38d7ea4c68000,
+    /* 16 */ (static_cast<__int128_t>(0x0) << 64) | 0x2386f26fc10000,
+    /* 17 */ (static_cast<__int128_t>(0x0) << 64) | 0x16345785d8a0000,
+    /* 18 */ (static_cast<__int128_t>(0x0) << 64) | 0xde0b6b3a7640000,
+    /* 19 */ (static_cast<__int128_t>(0x0) << 64) | 0x8ac7230489e80000,
+    /* 20 */ (static_cast<__int128_t>(0x5) << 64) | 0x6bc75e2d63100000,
+    /* 21 */ (static_cast<__int128_t>(0x36) << 64) | 0x35c9adc5dea00000,
+    /* 22 */ (static_cast<__int128_t>(0x21e) << 64) | 0x19e0c9bab2400000,
+    /* 23 */ (static_cast<__int128_t>(0x152d) << 64) | 0x2c7e14af6800000,
+    /* 24 */ (static_cast<__int128_t>(0xd3c2) << 64) | 0x1bcecceda1000000,
+    /* 25 */ (static_cast<__int128_t>(0x84595) << 64) | 0x161401484a000000,
+    /* 26 */ (static_cast<__int128_t>(0x52b7d2) << 64) | 0xdcc80cd2e4000000,
+    /* 27 */ (static_cast<__int128_t>(0x33b2e3c) << 64) | 0x9fd0803ce8000000,
+    /* 28 */ (static_cast<__int128_t>(0x204fce5e) << 64) | 0x3e25026110000000,
+    /* 29 */ (static_cast<__int128_t>(0x1431e0fae) << 64) | 0x6d7217caa0000000,
+    /* 30 */ (static_cast<__int128_t>(0xc9f2c9cd0) << 64) | 0x4674edea40000000,
+    /* 31 */ (static_cast<__int128_t>(0x7e37be2022) << 64) | 0xc0914b2680000000,
+    /* 32 */ (static_cast<__int128_t>(0x4ee2d6d415b) << 64) | 0x85acef8100000000,
+    /* 33 */ (static_cast<__int128_t>(0x314dc6448d93) << 64) | 0x38c15b0a00000000,
+    /* 34 */ (static_cast<__int128_t>(0x1ed09bead87c0) << 64) | 0x378d8e6400000000,
+    /* 35 */ (static_cast<__int128_t>(0x13426172c74d82) << 64) | 0x2b878fe800000000,
+    /* 36 */ (static_cast<__int128_t>(0xc097ce7bc90715) << 64) | 0xb34b9f1000000000,
+    /* 37 */ (static_cast<__int128_t>(0x785ee10d5da46d9) << 64) | 0xf436a000000000,
+    /* 38 */ (static_cast<__int128_t>(0x4b3b4ca85a86c47a) << 64) | 0x98a224000000000,
+};
+
+// 10^i
+inline constexpr Gmp320 kGmp320Power10[kMaxGmp320Power10 + 1] = {
+    /* 0  */ Gmp320(1, 0x1, 0x0, 0x0, 0x0, 0x0),
+    /* 1  */ Gmp320(1, 0xa, 0x0, 0x0, 0x0, 0x0),
+    /* 2  */ Gmp320(1, 0x64, 0x0, 0x0, 0x0, 0x0),
+    /* 3  */ Gmp320(1, 0x3e8, 0x0, 0x0, 0x0, 0x0),
+    /* 4  */ Gmp320(1, 0x2710, 0x0, 0x0, 0x0, 0x0),
+    /* 5  */ Gmp320(1, 0x186a0, 0x0, 0x0, 0x0, 0x0),
+    /* 6  */ Gmp320(1, 0xf4240, 0x0, 0x0, 0x0, 0x0),
+    /* 7  */ Gmp320(1, 0x989680, 0x0, 0x0, 0x0, 0x0),
+    /* 8  */ Gmp320(1, 0x5f5e100, 0x0, 0x0, 0x0, 0x0),
+    /* 9  */ Gmp320(1, 0x3b9aca00, 0x0, 0x0, 0x0, 0x0),
+    /* 10 */ Gmp320(1, 0x2540be400, 0x0, 0x0, 0x0, 0x0),
+    /* 11 */ Gmp320(1, 0x174876e800, 0x0, 0x0, 0x0, 0x0),
+    /* 12 */ Gmp320(1, 0xe8d4a51000, 0x0, 0x0, 0x0, 0x0),
+    /* 13 */ Gmp320(1, 0x9184e72a000, 0x0, 0x0, 0x0, 0x0),
+    /* 14 */ Gmp320(1, 0x5af3107a4000, 0x0, 0x0, 0x0, 0x0),
+    /* 15 */ Gmp320(1, 0x38d7ea4c68000, 0x0, 0x0, 0x0, 0x0),
+    /* 16 */ Gmp320(1, 0x2386f26fc10000, 0x0, 0x0, 0x0, 0x0),
+    /* 17 */ Gmp320(1, 0x16345785d8a0000, 0x0, 0x0, 0x0, 0x0),
+    /* 18 */ Gmp320(1, 0xde0b6b3a7640000, 0x0, 0x0, 0x0, 0x0),
+    /* 19 */ Gmp320(1, 0x8ac7230489e80000, 0x0, 0x0, 0x0, 0x0),
+    /* 20 */ Gmp320(2, 0x6bc75e2d63100000, 0x5, 0x0, 0x0, 0x0),
+    /* 21 */ Gmp320(2, 0x35c9adc5dea00000, 0x36, 0x0, 0x0, 0x0),
+    /* 22 */ Gmp320(2, 0x19e0c9bab2400000, 0x21e, 0x0, 0x0, 0x0),
+    /* 23 */ Gmp320(2, 0x2c7e14af6800000, 0x152d, 0x0, 0x0, 0x0),
+    /* 24 */ Gmp320(2, 0x1bcecceda1000000, 0xd3c2, 0x0, 0x0, 0x0),
+    /* 25 */ Gmp320(2, 0x161401484a000000, 0x84595, 0x0, 0x0, 0x0),
+    /* 26 */ Gmp320(2, 0xdcc80cd2e4000000, 0x52b7d2, 0x0, 0x0, 0x0),
+    /* 27 */ Gmp320(2, 0x9fd0803ce8000000, 0x33b2e3c, 0x0, 0x0, 0x0),
+    /* 28 */ Gmp320(2, 0x3e25026110000000, 0x204fce5e, 0x0, 0x0, 0x0),
+    /* 29 */ Gmp320(2, 0x6d7217caa0000000, 0x1431e0fae, 0x0, 0x0, 0x0),
+    /* 30 */ Gmp320(2, 0x4674edea40000000, 0xc9f2c9cd0, 0x0, 0x0, 0x0),
+    /* 31 */ Gmp320(2, 0xc0914b2680000000, 0x7e37be2022, 0x0, 0x0, 0x0),
+    /* 32 */ Gmp320(2, 0x85acef8100000000, 0x4ee2d6d415b, 0x0, 0x0, 0x0),
+    /* 33 */ Gmp320(2, 0x38c15b0a00000000, 0x314dc6448d93, 0x0, 0x0, 0x0),
+    /* 34 */ Gmp320(2, 0x378d8e6400000000, 0x1ed09bead87c0, 0x0, 0x0, 0x0),
+    /* 35 */ Gmp320(2, 0x2b878fe800000000, 0x13426172c74d82, 0x0, 0x0, 0x0),
+    /* 36 */ Gmp320(2, 0xb34b9f1000000000, 0xc097ce7bc90715, 0x0, 0x0, 0x0),
+    /* 37 */ Gmp320(2, 0xf436a000000000, 0x785ee10d5da46d9, 0x0, 0x0, 0x0),
+    /* 38 */ Gmp320(2, 0x98a224000000000, 0x4b3b4ca85a86c47a, 0x0, 0x0, 0x0),
+    /* 39 */ Gmp320(3, 0x5f65568000000000, 0xf050fe938943acc4, 0x2, 0x0, 0x0),
+    /* 40 */ Gmp320(3, 0xb9f5610000000000, 0x6329f1c35ca4bfab, 0x1d, 0x0, 0x0),
+    /* 41 */ Gmp320(3, 0x4395ca0000000000, 0xdfa371a19e6f7cb5, 0x125, 0x0, 0x0),
+    /* 42 */ Gmp320(3, 0xa3d9e40000000000, 0xbc627050305adf14, 0xb7a, 0x0, 0x0),
+    /* 43 */ Gmp320(3, 0x6682e80000000000, 0x5bd86321e38cb6ce, 0x72cb, 0x0, 0x0),
+    /* 44 */ Gmp320(3, 0x11d100000000000, 0x9673df52e37f2410, 0x47bf1, 0x0, 0x0),
+    /* 45 */ Gmp320(3, 0xb22a00000000000, 0xe086b93ce2f768a0, 0x2cd76f, 0x0, 0x0),
+    /* 46 */ Gmp320(3, 0x6f5a400000000000, 0xc5433c60ddaa1640, 0x1c06a5e, 0x0, 0x0),
+    /* 47 */ Gmp320(3, 0x5986800000000000, 0xb4a05bc8a8a4de84, 0x118427b3, 0x0, 0x0),
+    /* 48 */ Gmp320(3, 0x7f41000000000000, 0xe4395d69670b12b, 0xaf298d05, 0x0, 0x0),
+    /* 49 */ Gmp320(3, 0xf88a000000000000, 0x8ea3da61e066ebb2, 0x6d79f8232, 0x0, 0x0),
+    /* 50 */ Gmp320(3, 0xb564000000000000, 0x926687d2c40534fd, 0x446c3b15f9, 0x0, 0x0),
+    /* 51 */ Gmp320(3, 0x15e8000000000000, 0xb8014e3ba83411e9, 0x2ac3a4edbbf, 0x0, 0x0),
+    /* 52 */ Gmp320(3, 0xdb10000000000000, 0x300d0e549208b31a, 0x1aba4714957d, 0x0, 0x0),
+    /* 53 */ Gmp320(3, 0x8ea0000000000000, 0xe0828f4db456ff0c, 0x10b46c6cdd6e3, 0x0, 0x0),
+    /* 54 */ Gmp320(3, 0x9240000000000000, 0xc51999090b65f67d, 0xa70c3c40a64e6, 0x0, 0x0),
+    /* 55 */ Gmp320(3, 0xb680000000000000, 0xb2fffa5a71fba0e7, 0x6867a5a867f103, 0x0, 0x0),
+    /* 56 */ Gmp320(3, 0x2100000000000000, 0xfdffc78873d4490d, 0x4140c78940f6a24, 0x0, 0x0),
+    /* 57 */ Gmp320(3, 0x4a00000000000000, 0xebfdcb54864ada83, 0x28c87cb5c89a2571, 0x0, 0x0),
+    /* 58 */ Gmp320(4, 0xe400000000000000, 0x37e9f14d3eec8920, 0x97d4df19d6057673, 0x1, 0x0),
+    /* 59 */ Gmp320(4, 0xe800000000000000, 0x2f236d04753d5b48, 0xee50b7025c36a080, 0xf, 0x0),
+    /* 60 */ Gmp320(4, 0x1000000000000000, 0xd762422c946590d9, 0x4f2726179a224501, 0x9f, 0x0),
+    /* 61 */ Gmp320(4, 0xa000000000000000, 0x69d695bdcbf7a87a, 0x17877cec0556b212, 0x639, 0x0),
+    /* 62 */ Gmp320(4, 0x4000000000000000, 0x2261d969f7ac94ca, 0xeb4ae1383562f4b8, 0x3e3a, 0x0),
+    /* 63 */ Gmp320(4, 0x8000000000000000, 0x57d27e23acbdcfe6, 0x30eccc3215dd8f31, 0x26e4d, 0x0),
+    /* 64 */ Gmp320(4, 0x0, 0x6e38ed64bf6a1f01, 0xe93ff9f4daa797ed, 0x184f03, 0x0),
+    /* 65 */ Gmp320(4, 0x0, 0x4e3945ef7a25360a, 0x1c7fc3908a8bef46, 0xf31627, 0x0),
+    /* 66 */ Gmp320(4, 0x0, 0xe3cbb5ac5741c64, 0x1cfda3a5697758bf, 0x97edd87, 0x0),
+    /* 67 */ Gmp320(4, 0x0, 0x8e5f518bb6891be8, 0x21e864761ea97776, 0x5ef4a747, 0x0),
+    /* 68 */ Gmp320(4, 0x0, 0x8fb92f75215b1710, 0x5313ec9d329eaaa1, 0x3b58e88c7, 0x0),
+    /* 69 */ Gmp320(4, 0x0, 0x9d3bda934d8ee6a0, 0x3ec73e23fa32aa4f, 0x25179157c9, 0x0),
+    /* 70 */ Gmp320(4, 0x0, 0x245689c107950240, 0x73c86d67c5faa71c, 0x172ebad6ddc, 0x0),
+    /* 71 */ Gmp320(4, 0x0, 0x6b61618a4bd21680, 0x85d4460dbbca8719, 0xe7d34c64a9c, 0x0),
+    /* 72 */ Gmp320(4, 0x0, 0x31cdcf66f634e100, 0x3a4abc8955e946fe, 0x90e40fbeea1d, 0x0),
+    /* 73 */ Gmp320(4, 0x0, 0xf20a1a059e10ca00, 0x46eb5d5d5b1cc5ed, 0x5a8e89d752524, 0x0),
+    /* 74 */ Gmp320(4, 0x0, 0x746504382ca7e400, 0xc531a5a58f1fbb4b, 0x3899162693736a, 0x0),
+    /* 75 */ Gmp320(4, 0x0, 0x8bf22a31be8ee800, 0xb3f07877973d50f2, 0x235fadd81c2822b, 0x0),
+    /* 76 */ Gmp320(4, 0x0, 0x7775a5f171951000, 0x764b4abe8652979, 0x161bcca7119915b5, 0x0),
+    /* 77 */ Gmp320(4, 0x0, 0xaa987b6e6fd2a000, 0x49ef0eb713f39ebe, 0xdd15fe86affad912, 0x0),
+    /* 78 */ Gmp320(5, 0x0, 0xa9f4d2505e3a4000, 0xe3569326c7843372, 0xa2dbf142dfcc7ab6, 0x8),
+    /* 79 */ Gmp320(5, 0x0, 0xa3903723ae468000, 0xe161bf83cb2a027a, 0x5c976c9cbdfccb24, 0x56),
+    /* 80 */ Gmp320(5, 0x0, 0x63a22764cec10000, 0xcdd17b25efa418ca, 0x9dea3e1f6bdfef70, 0x35f),
+    /* 81 */ Gmp320(5, 0x0, 0xe45589f0138a0000, 0xa2ecf7b5c68f7e7, 0x2b266d3a36bf5a68, 0x21bc),
+    /* 82 */ Gmp320(5, 0x0, 0xeb576360c3640000, 0x65d41ad19c19af0e, 0xaf80444623798810, 0x15159),
+    /* 83 */ Gmp320(5, 0x0, 0x3169e1c7a1e80000, 0xfa490c301900d695, 0xdb02aabd62bf50a3, 0xd2d80),
+    /* 84 */ Gmp320(5, 0x0, 0xee22d1cc53100000, 0xc6da79e0fa0861d3, 0x8e1aab65db792667, 0x83c708),
+    /* 85 */ Gmp320(5, 0x0, 0x4d5c31fb3ea00000, 0xc488c2c9c453d247, 0x8d0ab1fa92bb800d, 0x525c655),
+    /* 86 */ Gmp320(5, 0x0, 0x599f3d072400000, 0xad579be1ab4636c9, 0x826af3c9bb530089, 0x3379bf57),
+    /* 87 */ Gmp320(5, 0x0, 0x3803862476800000, 0xc56c16d0b0be23da, 0x182d85e1513e0560, 0x202c1796b),
+    /* 88 */ Gmp320(5, 0x0, 0x30233d6ca1000000, 0xb638e426e76d6686, 0xf1c73acd2c6c35c7, 0x141b8ebe2e),
+    /* 89 */ Gmp320(5, 0x0, 0xe160663e4a000000, 0x1e38e9850a46013d, 0x71c84c03bc3a19cd, 0xc913936dd5),
+    /* 90 */ Gmp320(5, 0x0, 0xcdc3fe6ee4000000, 0x2e391f3266bc0c6a, 0x71d2f8255a450203, 0x7dac3c24a56),
+    /* 91 */ Gmp320(5, 0x0, 0x9a7f054e8000000, 0xce3b37f803587c2c, 0x723db17586b2141f, 0x4e8ba596e760),
+    /* 92 */ Gmp320(5, 0x0, 0x608f635110000000, 0xe502fb02174d9b8, 0x7668ee9742f4c93e, 0x3117477e509c4),
+    /* 93 */ Gmp320(5, 0x0, 0xc599e12aa0000000, 0x8f21dce14e908133, 0xa01951e89d8fdc6c, 0x1eae8caef261ac),
+    /* 94 */ Gmp320(5, 0x0, 0xb802cbaa40000000, 0x9752a0cd11a50c05, 0x40fd3316279e9c3d, 0x132d17ed577d0be),
+    /* 95 */ Gmp320(5, 0x0, 0x301bf4a680000000, 0xe93a4802b0727839, 0x89e3fedd8c321a67, 0xbfc2ef456ae276e),
+    /* 96 */ Gmp320(5, 0x0, 0xe1178e8100000000, 0x1c46d01ae478b23b, 0x62e7f4a779f5080f, 0x77d9d58b62cd8a51),
+};
+/* clang-format on */
+}  // namespace detail
+}  // namespace bignum
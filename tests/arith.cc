@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "decimal.h"
+#include "decimal_arith.h"
+#include "decimal_column.h"
+#include "test_util.h"
+
+namespace bignum {
+using namespace detail;
+
+namespace {
+template <typename T>
+void expect_column(const DecimalColumnImpl<T> &column, const std::vector<Decimal> &expected,
+                   int32_t scale) {
+        ASSERT_EQ(column.size(), expected.size());
+        EXPECT_EQ(column.get_scale(), scale);
+        for (size_t i = 0; i < expected.size(); ++i) {
+                ASSERT_EQ(column[i], expected[i]) << i;
+        }
+}
+}  // namespace
+
+TEST(DecimalArithTest, Unchecked) {
+        Decimal d("1.25");
+        d.add_unchecked(Decimal("0.005"));
+        EXPECT_EQ(d.to_string(), "1.255");
+        EXPECT_EQ(d.get_scale(), 3);
+        d.sub_unchecked(Decimal(2));
+        EXPECT_EQ(d.to_string(), "-0.745");
+        d.mul_unchecked(Decimal("-0.2"));
+        EXPECT_EQ(d.to_string(), "0.149");
+        EXPECT_EQ(d.get_scale(), 4);
+        d = Decimal(0);
+        d.add_unchecked(Decimal("0.000000000000000000000001"));
+        EXPECT_EQ(d.get_scale(), 24);
+        d = Decimal("0.000000000000000000000001");
+        d.sub_unchecked(Decimal(0));
+        EXPECT_EQ(d.get_scale(), 24);
+
+        // Wider values are the checked operations
+        d = Decimal(kInt128Max);
+        d.sub_unchecked(Decimal(kInt128Max)).add_unchecked(Decimal("123456789012345678901234.5"));
+        EXPECT_EQ(d.to_string(), "123456789012345678901234.5");
+        d.mul_unchecked(Decimal("10000000000000000000000000"));
+        EXPECT_EQ(d.to_string(), "1234567890123456789012345000000000000000000000000");
+
+        std::mt19937_64 rng(20240621);
+        for (int32_t i = 0; i < 100000; ++i) {
+                // Up to 9 digits and scale 9, so that sums, differences and products fit into
+                // int64
+                const int32_t ldigits = 1 + static_cast<int32_t>(rng() % 9);
+                const int32_t rdigits = 1 + static_cast<int32_t>(rng() % 9);
+                const int64_t lm = static_cast<int64_t>(rng() % kUint64Power10[ldigits]) *
+                                   (rng() % 2 ? 1 : -1);
+                const int64_t rm = static_cast<int64_t>(rng() % kUint64Power10[rdigits]) *
+                                   (rng() % 2 ? 1 : -1);
+                const int32_t lscale = static_cast<int32_t>(rng() % 10);
+                const int32_t rscale = static_cast<int32_t>(rng() % 10);
+                const Decimal l = make_decimal(lm, lscale);
+                const Decimal r = make_decimal(rm, rscale);
+
+                Decimal sum = l;
+                sum.add_unchecked(r);
+                Decimal diff = l;
+                diff.sub_unchecked(r);
+                Decimal product = l;
+                product.mul_unchecked(r);
+                ASSERT_EQ(sum, l + r) << l << " + " << r;
+                ASSERT_EQ(sum.get_scale(), (l + r).get_scale());
+                ASSERT_EQ(diff, l - r) << l << " - " << r;
+                ASSERT_EQ(diff.get_scale(), (l - r).get_scale());
+                ASSERT_EQ(product, l * r) << l << " * " << r;
+                ASSERT_EQ(product.get_scale(), (l * r).get_scale());
+        }
+}
+
+TEST(DecimalArithTest, Bound) {
+        DecimalColumn column(2);
+        EXPECT_FALSE(column.has_bound());
+        EXPECT_EQ(column.bound_scaled(), DecimalColumn::kNoBound);
+        column.push_back(Decimal("-99.99"));
+        column.set_bound(Decimal(100));
+        EXPECT_TRUE(column.has_bound());
+        EXPECT_EQ(column.bound_scaled(), 10000);
+        column.push_back(Decimal(100));
+        column.push_back(Decimal("-100.00"));
+        column.push_back_scaled(9999);
+        column.set(0, Decimal("0.5"));
+        EXPECT_EQ(column.size(), 4u);
+        column.clear();
+        EXPECT_TRUE(column.has_bound());
+
+        DecimalColumn128 wide(0);
+        wide.push_back(Decimal(3));
+        wide.set_bound_scaled(3);
+        EXPECT_EQ(wide.bound_scaled(), 3);
+
+#ifdef BIGNUM_ENABLE_EXCEPTIONS
+        EXPECT_THROW(column.push_back(Decimal("100.01")), std::runtime_error);
+        EXPECT_THROW(column.push_back(Decimal("0.001")), std::runtime_error);
+        EXPECT_THROW(column.push_back_scaled(-10001), std::runtime_error);
+        EXPECT_THROW(column.set_bound(Decimal(-1)), std::runtime_error);
+        EXPECT_THROW(column.set_bound(Decimal("0.001")), std::runtime_error);
+        EXPECT_THROW(column.set_bound(Decimal("92233720368547758.07")), std::runtime_error);
+        EXPECT_THROW(wide.set_bound_scaled(2), std::runtime_error);
+        EXPECT_EQ(column.size(), 0u);
+
+        DecimalColumn unbounded(0);
+        unbounded.push_back(Decimal("0.5"));
+        EXPECT_THROW(unbounded.set_bound(Decimal(1)), std::runtime_error);
+        EXPECT_FALSE(unbounded.has_bound());
+#endif
+}
+
+TEST(DecimalArithTest, Column) {
+        DecimalColumn prices(4);
+        DecimalColumn quantities(0);
+        prices.set_bound(Decimal(1000000));
+        quantities.set_bound(Decimal(100000));
+        std::vector<Decimal> expected_sum;
+        std::vector<Decimal> expected_diff;
+        std::vector<Decimal> expected_product;
+        std::mt19937_64 rng(20240622);
+        for (int32_t i = 0; i < 1000; ++i) {
+                const Decimal price =
+                        make_decimal(static_cast<int64_t>(rng() % 20000000001) - 10000000000, 4);
+                const Decimal quantity(static_cast<int64_t>(rng() % 100001));
+                prices.push_back(price);
+                quantities.push_back(quantity);
+                expected_sum.push_back(price + quantity);
+                expected_diff.push_back(price - quantity);
+                expected_product.push_back(price * quantity);
+        }
+
+        DecimalColumn result;
+        mul(prices, quantities, result);
+        expect_column(result, expected_product, 4);
+        EXPECT_EQ(result.bound_scaled(), 1000000000000000);
+        add(prices, quantities, result);
+        expect_column(result, expected_sum, 4);
+        EXPECT_EQ(result.bound_scaled(), 10000000000 + 1000000000);
+        sub(prices, quantities, result);
+        expect_column(result, expected_diff, 4);
+
+        // Without a bound, the results are the same
+        DecimalColumn unbounded(4);
+        for (size_t i = 0; i < prices.size(); ++i) {
+                unbounded.push_back(prices[i]);
+        }
+        mul(unbounded, quantities, result);
+        expect_column(result, expected_product, 4);
+        EXPECT_FALSE(result.has_bound());
+        add(quantities, unbounded, result);
+        expect_column(result, expected_sum, 4);
+        sub(unbounded, quantities, result);
+        expect_column(result, expected_diff, 4);
+
+        // The result might be an operand
+        result = prices;
+        add(result, result, result);
+        for (size_t i = 0; i < prices.size(); ++i) {
+                ASSERT_EQ(result[i], prices[i] * Decimal(2));
+        }
+}
+
+TEST(DecimalArithTest, ColumnOverflow) {
+        // Values in the side table, and results that do not fit the payload
+        DecimalColumn l(2);
+        DecimalColumn r(3);
+        std::vector<Decimal> values = {Decimal("92233720368547758.07"), Decimal("-0.125"),
+                                       Decimal("123456789012345678901234567890"),
+                                       Decimal("0.01")};
+        for (const Decimal &v : values) {
+                l.push_back(v);
+                r.push_back(v);
+        }
+        EXPECT_TRUE(l.is_wide(1));
+        std::vector<Decimal> expected_sum;
+        std::vector<Decimal> expected_product;
+        for (const Decimal &v : values) {
+                expected_sum.push_back(v + v);
+                expected_product.push_back(v * v);
+        }
+        DecimalColumn result;
+        add(l, r, result);
+        expect_column(result, expected_sum, 3);
+        EXPECT_TRUE(result.is_wide(0));
+        mul(l, r, result);
+        expect_column(result, expected_product, 5);
+
+        // Bounds whose results do not fit are computed with checks
+        DecimalColumn a(0);
+        DecimalColumn b(0);
+        a.set_bound_scaled(INT64_MAX / 2);
+        b.set_bound_scaled(INT64_MAX / 2 + 2);
+        a.push_back(Decimal(INT64_MAX / 2));
+        b.push_back(Decimal(INT64_MAX / 2 + 2));
+        add(a, b, result);
+        EXPECT_FALSE(result.has_bound());
+        EXPECT_TRUE(result.is_wide(0));
+        EXPECT_EQ(result[0], Decimal(INT64_MAX / 2) + Decimal(INT64_MAX / 2 + 2));
+
+        // Products beyond the max scale are rounded
+        DecimalColumn128 x(20);
+        DecimalColumn128 y(15);
+        x.set_bound(Decimal(1));
+        y.set_bound(Decimal(1));
+        x.push_back(Decimal("0.12345678901234567891"));
+        y.push_back(Decimal("-0.000000000000005"));
+        DecimalColumn128 z;
+        mul(x, y, z);
+        EXPECT_EQ(z.get_scale(), 30);
+        EXPECT_FALSE(z.has_bound());
+        EXPECT_EQ(z[0].to_string(), "-0.000000000000000617283945061728");
+
+#ifdef BIGNUM_ENABLE_EXCEPTIONS
+        DecimalColumn empty;
+        EXPECT_THROW(add(l, empty, result), std::runtime_error);
+#endif
+}
+}  // namespace bignum
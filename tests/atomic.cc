@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "decimal.h"
+#include "decimal_atomic.h"
+#include "test_util.h"
+
+namespace bignum {
+using namespace detail;
+
+TEST(DecimalAtomicTest, Basic) {
+        AtomicDecimal a;
+        EXPECT_EQ(a.load(), Decimal(0));
+        EXPECT_TRUE(a.is_narrow());
+        EXPECT_EQ(a.add(Decimal("1.25")), ErrCode(kSuccess));
+        EXPECT_EQ(a.load().to_string(), "1.25");
+        EXPECT_EQ(a.load().get_scale(), 2);
+        EXPECT_EQ(a.fetch_add(Decimal(3)).to_string(), "1.25");
+        EXPECT_EQ(a.fetch_sub(Decimal("0.001")).to_string(), "4.25");
+        EXPECT_EQ(a.load().to_string(), "4.249");
+        EXPECT_EQ(a.load().get_scale(), 3);
+        EXPECT_EQ(a.sub(Decimal(10)), ErrCode(kSuccess));
+        EXPECT_EQ(a.load().to_string(), "-5.751");
+
+        a.store(Decimal("-0.5"));
+        EXPECT_EQ(a.load().to_string(), "-0.5");
+        AtomicDecimal b(Decimal(INT64_MIN));
+        EXPECT_EQ(b.fetch_sub(Decimal(1)), Decimal(INT64_MIN));
+        EXPECT_EQ(b.load(), Decimal(INT64_MIN) - Decimal(1));
+        EXPECT_TRUE(b.is_narrow());
+
+        // Payloads of up to 122 bits stay in the word
+        const Decimal big(static_cast<__int128_t>(1) << 120);
+        AtomicDecimal c(big);
+        EXPECT_TRUE(c.is_narrow());
+        EXPECT_EQ(c.load(), big);
+        EXPECT_EQ(c.add(big), ErrCode(kSuccess));
+        EXPECT_EQ(c.load(), big + big);
+        EXPECT_FALSE(c.is_narrow());
+        EXPECT_EQ(c.sub(big), ErrCode(kSuccess));
+        EXPECT_TRUE(c.is_narrow());
+        EXPECT_EQ(c.load(), big);
+        c.store(-Decimal(kInt128Min));
+        EXPECT_FALSE(c.is_narrow());
+        EXPECT_EQ(c.load(), -Decimal(kInt128Min));
+}
+
+TEST(DecimalAtomicTest, Wide) {
+        AtomicDecimal a(power10(80));
+        EXPECT_FALSE(a.is_narrow());
+        EXPECT_EQ(a.fetch_add(Decimal("0.5")), power10(80));
+        EXPECT_EQ(a.load(), power10(80) + Decimal("0.5"));
+        EXPECT_EQ(a.load().get_scale(), 1);
+        EXPECT_EQ(a.sub(-power10(80)), ErrCode(kSuccess));
+        EXPECT_EQ(a.load(), power10(80) + power10(80) + Decimal("0.5"));
+        EXPECT_EQ(a.sub(power10(80) + power10(80)), ErrCode(kSuccess));
+        EXPECT_EQ(a.load().to_string(), "0.5");
+        EXPECT_TRUE(a.is_narrow());
+
+        // A wide operand whose result fits into the word
+        EXPECT_EQ(a.add(power10(60)), ErrCode(kSuccess));
+        EXPECT_FALSE(a.is_narrow());
+        EXPECT_EQ(a.add(-power10(60)), ErrCode(kSuccess));
+        EXPECT_TRUE(a.is_narrow());
+        EXPECT_EQ(a.load().to_string(), "0.5");
+}
+
+TEST(DecimalAtomicTest, Errors) {
+        const Decimal max(std::string(96, '9').c_str());
+        AtomicDecimal a(max);
+        EXPECT_EQ(a.add(Decimal(1)), ErrCode(kDecimalAddSubOverflow));
+        EXPECT_EQ(a.load(), max);
+        a.store(Decimal(1));
+        EXPECT_EQ(a.add(Decimal("0." + std::string(29, '0') + "1")), ErrCode(kSuccess));
+        EXPECT_EQ(a.add(max), ErrCode(kDecimalAddSubOverflow));
+        EXPECT_EQ(a.load().get_scale(), 30);
+
+        Decimal nan;
+        nan.poison(kDivByZero);
+        EXPECT_EQ(a.add(nan), ErrCode(kDivByZero));
+        EXPECT_EQ(a.load().get_scale(), 30);
+
+#ifdef BIGNUM_ENABLE_EXCEPTIONS
+        EXPECT_THROW(a.fetch_sub(-max), std::runtime_error);
+        EXPECT_THROW(a.store(nan), std::runtime_error);
+#endif
+}
+
+TEST(DecimalAtomicTest, Concurrent) {
+        // Every thread adds and subtracts values of different scales, some of which take the
+        // running total to the wide tier and back, while readers only ever see values that are
+        // sums of whole steps.
+        constexpr int32_t kThreads = 8;
+        constexpr int32_t kSteps = 20000;
+        const Decimal wide = power10(50);
+        AtomicDecimal total;
+        std::atomic<bool> done = false;
+        std::thread reader([&]() {
+                while (!done.load()) {
+                        const Decimal d = total.load();
+                        ASSERT_LE(d.get_scale(), 2);
+                        Decimal rest = d;
+                        ASSERT_FALSE(rest.mod(wide));
+                        ASSERT_LE(rest, Decimal(kThreads * kSteps));
+                }
+        });
+        std::vector<std::thread> threads;
+        for (int32_t t = 0; t < kThreads; ++t) {
+                threads.emplace_back([&, t]() {
+                        for (int32_t i = 0; i < kSteps; ++i) {
+                                EXPECT_FALSE(total.add(Decimal("0.25")));
+                                EXPECT_FALSE(total.add(Decimal("0.75")));
+                                if ((i + t) % 64 == 0) {
+                                        EXPECT_FALSE(total.add(wide));
+                                        EXPECT_FALSE(total.sub(wide));
+                                }
+                                if (i % 2 == 0) {
+                                        EXPECT_FALSE(total.fetch_sub(Decimal(1)) < Decimal(0));
+                                        EXPECT_FALSE(total.add(Decimal(1)));
+                                }
+                        }
+                });
+        }
+        for (std::thread &thread : threads) {
+                thread.join();
+        }
+        done = true;
+        reader.join();
+        EXPECT_EQ(total.load(), Decimal(kThreads * kSteps));
+        EXPECT_TRUE(total.is_narrow());
+}
+
+TEST(DecimalAtomicTest, WideTransitions) {
+        // Just below the largest payload of the word, x adds 2e9 (and then takes it back) and y
+        // subtracts 1.5e9 (and then adds it back), so that the value is wide only while x is up
+        // and y is not down, and a locked update that goes wide might fit again once it retries
+        // after a lock-free one. Every step also adds 1 for x and 1000 for y, so that no value
+        // is taken twice. A load must return one of the values taken, which are those before
+        // every step and the last one, never an attempt that was not published.
+        constexpr int32_t kRounds = 40;
+        constexpr int32_t kCycles = 400;
+        const Decimal base = Decimal((static_cast<__int128_t>(1) << 121) - 1) - Decimal(1000000000);
+        const Decimal up_x(2000000000);
+        const Decimal down_y(1500000000);
+        for (int32_t round = 0; round < kRounds; ++round) {
+                AtomicDecimal total(base);
+                std::vector<Decimal> taken;
+                std::vector<Decimal> taken_y;
+                std::vector<Decimal> loaded;
+                std::atomic<bool> done = false;
+                std::thread reader([&]() {
+                        while (!done.load()) {
+                                loaded.push_back(total.load());
+                        }
+                });
+                std::thread y([&]() {
+                        for (int32_t i = 0; i < kCycles; ++i) {
+                                taken_y.push_back(total.fetch_sub(down_y - Decimal(1000)));
+                                taken_y.push_back(total.fetch_add(down_y + Decimal(1000)));
+                        }
+                });
+                for (int32_t i = 0; i < kCycles; ++i) {
+                        taken.push_back(total.fetch_add(up_x + Decimal(1)));
+                        taken.push_back(total.fetch_sub(up_x - Decimal(1)));
+                }
+                y.join();
+                done = true;
+                reader.join();
+
+                const Decimal last = total.load();
+                EXPECT_EQ(last, base + Decimal(2 * kCycles) + Decimal(2000 * kCycles));
+                taken.insert(taken.end(), taken_y.begin(), taken_y.end());
+                taken.push_back(last);
+                std::sort(taken.begin(), taken.end());
+                for (const Decimal &d : loaded) {
+                        ASSERT_TRUE(std::binary_search(taken.begin(), taken.end(), d)) << d;
+                }
+        }
+}
+}  // namespace bignum
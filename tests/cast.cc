@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "decimal.h"
+#include "decimal_cast.h"
+#include "decimal_column.h"
+#include "test_util.h"
+
+namespace bignum {
+using namespace detail;
+
+namespace {
+constexpr RoundingMode kModes[] = {RoundingMode::kHalfUp, RoundingMode::kHalfEven,
+                                   RoundingMode::kHalfDown, RoundingMode::kDown,
+                                   RoundingMode::kUp,     RoundingMode::kFloor,
+                                   RoundingMode::kCeiling};
+
+std::string rescaled(const char *s, int32_t scale, RoundingMode mode) {
+        Decimal d(s);
+        ErrCode err = d.rescale(scale, mode);
+        EXPECT_FALSE(err);
+        EXPECT_EQ(d.get_scale(), scale);
+        return d.to_string();
+}
+
+// m / 10^exp rounded with mode, computed with plain integers.
+int64_t round_div(int64_t m, int32_t exp, RoundingMode mode) {
+        const int64_t p = static_cast<int64_t>(kUint64Power10[exp]);
+        int64_t q = m / p;
+        const int64_t r = m % p;
+        if (r == 0) {
+                return q;
+        }
+        const int64_t twice = 2 * (r < 0 ? -r : r);
+        bool away = false;
+        switch (mode) {
+                case RoundingMode::kHalfUp:
+                        away = twice >= p;
+                        break;
+                case RoundingMode::kHalfEven:
+                        away = twice > p || (twice == p && (q & 1));
+                        break;
+                case RoundingMode::kHalfDown:
+                        away = twice > p;
+                        break;
+                case RoundingMode::kDown:
+                        break;
+                case RoundingMode::kUp:
+                        away = true;
+                        break;
+                case RoundingMode::kFloor:
+                        away = m < 0;
+                        break;
+                case RoundingMode::kCeiling:
+                        away = m > 0;
+                        break;
+        }
+        return away ? q + (m < 0 ? -1 : 1) : q;
+}
+}  // namespace
+
+TEST(DecimalCastTest, Magic64) {
+        std::mt19937_64 rng(20240618);
+        for (int32_t e = 0; e <= kMaxUint64Power10; ++e) {
+                const uint64_t d = kUint64Power10[e];
+                for (uint64_t n : {uint64_t{0}, d - 1, d, d + 1, UINT64_MAX, UINT64_MAX - 1}) {
+                        ASSERT_EQ(div_magic64(n, kPower10Magics[e]), n / d) << n << " / " << d;
+                }
+                for (int32_t i = 0; i < 10000; ++i) {
+                        const uint64_t n = rng() >> (rng() % 64);
+                        ASSERT_EQ(div_magic64(n, kPower10Magics[e]), n / d) << n << " / " << d;
+                }
+        }
+        const Magic64 magic = make_magic64(7);
+        EXPECT_EQ(div_magic64(UINT64_MAX, magic), UINT64_MAX / 7);
+}
+
+TEST(DecimalCastTest, Rescale) {
+        // 2.345, -2.345, 2.5, -2.5, 3.5, 2.1, -2.9 in every mode
+        const char *expected[][7] = {
+                {"2.35", "2.34", "2.34", "2.34", "2.35", "2.34", "2.35"},
+                {"-2.35", "-2.34", "-2.34", "-2.34", "-2.35", "-2.35", "-2.34"},
+                {"3", "2", "2", "2", "3", "2", "3"},
+                {"-3", "-2", "-2", "-2", "-3", "-3", "-2"},
+                {"4", "4", "3", "3", "4", "3", "4"},
+                {"2", "2", "2", "2", "3", "2", "3"},
+                {"-3", "-3", "-3", "-2", "-3", "-3", "-2"},
+        };
+        const char *values[] = {"2.345", "-2.345", "2.5", "-2.5", "3.5", "2.1", "-2.9"};
+        const int32_t scales[] = {2, 2, 0, 0, 0, 0, 0};
+        for (size_t i = 0; i < std::size(values); ++i) {
+                for (size_t m = 0; m < std::size(kModes); ++m) {
+                        EXPECT_EQ(rescaled(values[i], scales[i], kModes[m]), expected[i][m])
+                                << values[i] << " mode " << m;
+                }
+        }
+
+        // Only the first dropped digit decides a tie, unless all the others are zero
+        EXPECT_EQ(rescaled("2.50000000000000000000000001", 0, RoundingMode::kHalfEven), "3");
+        EXPECT_EQ(rescaled("0.4999999999999999999999999", 0, RoundingMode::kHalfUp), "0");
+        EXPECT_EQ(rescaled("2.50000000000000000000000001", 0, RoundingMode::kHalfDown), "3");
+        EXPECT_EQ(rescaled("0.0000000000000000000000001", 0, RoundingMode::kCeiling), "1");
+        EXPECT_EQ(rescaled("-0.0000000000000000000000001", 0, RoundingMode::kFloor), "-1");
+        EXPECT_EQ(rescaled("-0.0000000000000000000000001", 0, RoundingMode::kCeiling), "0");
+        EXPECT_EQ(rescaled("9.999", 2, RoundingMode::kHalfUp), "10");
+
+        // Scale up
+        Decimal d("2.5");
+        EXPECT_FALSE(d.rescale(3));
+        EXPECT_EQ(d.get_scale(), 3);
+        EXPECT_EQ(d, Decimal("2.5"));
+
+        // int128, int256 and gmp values
+        EXPECT_EQ(rescaled("12345678901234567890123456.789", 1, RoundingMode::kHalfUp),
+                  "12345678901234567890123456.8");
+        EXPECT_EQ(rescaled("-1234567890123456789012345678901234567890123456.75", 1,
+                           RoundingMode::kHalfEven),
+                  "-1234567890123456789012345678901234567890123456.8");
+        EXPECT_EQ(rescaled("123456789012345678901234567890123456789012345678901234567890123456789"
+                           ".999999999999999999999999999",
+                           0, RoundingMode::kDown),
+                  "123456789012345678901234567890123456789012345678901234567890123456789");
+
+        // Errors leave the decimal untouched
+        d = Decimal("123456789012345678901234567890123456789012345678901234567890123456789012");
+        EXPECT_EQ(d.rescale(30), ErrCode(kDecimalValueOutOfRange));
+        EXPECT_EQ(d.get_scale(), 0);
+        EXPECT_EQ(d.rescale(31), ErrCode(kInvalidArgument));
+        EXPECT_EQ(d.rescale(-1), ErrCode(kInvalidArgument));
+}
+
+TEST(DecimalCastTest, RescaleRandom) {
+        std::mt19937_64 rng(20240616);
+        for (int32_t i = 0; i < 100000; ++i) {
+                const int64_t m = static_cast<int64_t>(rng() % 2000000000000ull) - 1000000000000;
+                const int32_t scale = static_cast<int32_t>(rng() % 9);
+                const int32_t target = static_cast<int32_t>(rng() % (scale + 1));
+                const RoundingMode mode = kModes[rng() % std::size(kModes)];
+                Decimal d = make_decimal(m, scale);
+                ASSERT_EQ(d.get_scale(), scale);
+                ASSERT_FALSE(d.rescale(target, mode));
+                Decimal expected = make_decimal(round_div(m, scale - target, mode), target);
+                ASSERT_EQ(d, expected) << m << " " << scale << " " << target;
+                ASSERT_EQ(d.get_scale(), target);
+        }
+}
+
+TEST(DecimalCastTest, Column) {
+        DecimalColumn column(4);
+        for (const char *s : {"1.2345", "-1.2355", "99999999.9999", "0.00005", "0.12345",
+                              "123456789012345678901234567890", "-0.0001"}) {
+                column.push_back(Decimal(s));
+        }
+        EXPECT_TRUE(column.is_wide(4));
+        DecimalColumn result(2);
+        std::vector<uint64_t> overflow(1, 0xdeadbeef);
+        // DECIMAL(10, 2)
+        EXPECT_EQ(cast(column, 10, RoundingMode::kHalfUp, result, overflow), 2u);
+        EXPECT_EQ(overflow[0], 0b0100100u);
+        ASSERT_EQ(result.size(), column.size());
+        EXPECT_EQ(result[0].to_string(), "1.23");
+        EXPECT_EQ(result[1].to_string(), "-1.24");
+        EXPECT_EQ(result[2], Decimal(0));
+        EXPECT_EQ(result[3].to_string(), "0");
+        EXPECT_EQ(result[4].to_string(), "0.12");
+        EXPECT_EQ(result[5], Decimal(0));
+        EXPECT_EQ(result[6].to_string(), "0");
+        for (size_t i = 0; i < result.size(); ++i) {
+                EXPECT_EQ(result[i].get_scale(), 2);
+        }
+
+        // DECIMAL(35, 6) in an int128 column, which fits everything but the large value
+        DecimalColumn128 wide(6);
+        EXPECT_EQ(cast(column, 35, RoundingMode::kCeiling, wide, overflow), 1u);
+        EXPECT_EQ(overflow[0], 0b0100000u);
+        EXPECT_EQ(wide[0].to_string(), "1.2345");
+        EXPECT_EQ(wide[4].to_string(), "0.12345");
+        EXPECT_EQ(wide[4].get_scale(), 6);
+        EXPECT_FALSE(wide.is_wide(4));
+        EXPECT_EQ(cast(column, 36, RoundingMode::kCeiling, wide, overflow), 0u);
+        EXPECT_FALSE(wide.is_wide(5));
+        EXPECT_EQ(wide[5].to_string(), "123456789012345678901234567890");
+}
+
+TEST(DecimalCastTest, ColumnRandom) {
+        std::mt19937_64 rng(20240617);
+        DecimalColumn column(4);
+        DecimalColumn128 column128(4);
+        std::vector<Decimal> values;
+        for (int32_t i = 0; i < 5000; ++i) {
+                Decimal d = Decimal(static_cast<int64_t>(rng()) >> (rng() % 64)) / Decimal(10000);
+                if (rng() % 50 == 0) {
+                        d = d / Decimal(3);
+                } else if (rng() % 50 == 0) {
+                        d = d * Decimal("100000000000000000000");
+                }
+                values.push_back(d);
+                column.push_back(d);
+                column128.push_back(d);
+        }
+        std::vector<uint64_t> overflow((values.size() + 63) / 64);
+        for (int32_t scale : {0, 2, 4, 7}) {
+                for (int32_t precision : {1, 9, 18, 25, 38, 50}) {
+                        for (RoundingMode mode : kModes) {
+                                DecimalColumn result(scale);
+                                DecimalColumn128 result128(scale);
+                                size_t num = cast(column, precision, mode, result, overflow);
+                                std::vector<uint64_t> overflow128 = overflow;
+                                EXPECT_EQ(cast(column128, precision, mode, result128, overflow128),
+                                          num);
+                                EXPECT_EQ(overflow128, overflow);
+                                size_t expected_num = 0;
+                                for (size_t i = 0; i < values.size(); ++i) {
+                                        Decimal d = values[i];
+                                        bool fits = !d.rescale(scale, mode) &&
+                                                    d.precision() <= precision;
+                                        expected_num += !fits;
+                                        ASSERT_EQ((overflow[i / 64] >> (i % 64)) & 1, !fits);
+                                        ASSERT_EQ(result[i], fits ? d : Decimal(0));
+                                        ASSERT_EQ(result128[i], result[i]);
+                                }
+                                EXPECT_EQ(num, expected_num);
+                        }
+                }
+        }
+}
+}  // namespace bignum
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "decimal.h"
+#include "decimal_column.h"
+
+namespace bignum {
+using namespace detail;
+
+TEST(DecimalColumnTest, Payload) {
+        DecimalColumn column(2);
+        EXPECT_EQ(column.get_scale(), 2);
+        EXPECT_TRUE(column.empty());
+
+        column.push_back(Decimal("1.5"));
+        column.push_back(Decimal("-0.01"));
+        column.push_back(Decimal(0));
+        column.push_back(Decimal("0.75") * Decimal(2));
+        column.push_back(Decimal("92233720368547758.07"));
+        EXPECT_EQ(column.size(), 5u);
+        EXPECT_TRUE(column.wide_indices().empty());
+
+        std::vector<int64_t> payload(column.payload().begin(), column.payload().end());
+        EXPECT_EQ(payload, (std::vector<int64_t>{150, -1, 0, 150, INT64_MAX}));
+
+        EXPECT_EQ(column[0], Decimal("1.5"));
+        EXPECT_EQ(column[0].get_scale(), 2);
+        EXPECT_EQ(column[1].to_string(), "-0.01");
+        EXPECT_EQ(column[2], Decimal(0));
+        EXPECT_EQ(column[4].to_string(), "92233720368547758.07");
+}
+
+TEST(DecimalColumnTest, SideTable) {
+        DecimalColumn column(2);
+        std::vector<Decimal> values = {Decimal("1.5"),
+                                       Decimal("0.125"),
+                                       Decimal("92233720368547758.08"),
+                                       Decimal("-92233720368547758.08"),
+                                       Decimal("2"),
+                                       Decimal("123456789012345678901234567890.123")};
+        for (const Decimal &v : values) {
+                column.push_back(v);
+        }
+        EXPECT_FALSE(column.is_wide(0));
+        EXPECT_TRUE(column.is_wide(1));
+        EXPECT_TRUE(column.is_wide(2));
+        // Would have the payload INT64_MIN, which marks a wide value
+        EXPECT_TRUE(column.is_wide(3));
+        EXPECT_FALSE(column.is_wide(4));
+        std::vector<size_t> wide(column.wide_indices().begin(), column.wide_indices().end());
+        EXPECT_EQ(wide, (std::vector<size_t>{1, 2, 3, 5}));
+        for (size_t i = 0; i < values.size(); ++i) {
+                EXPECT_EQ(column[i], values[i]);
+        }
+
+        column.set(0, Decimal("0.001"));
+        column.set(1, Decimal("-3.25"));
+        column.set(5, Decimal("0.1"));
+        column.set(4, Decimal("4.4444"));
+        wide.assign(column.wide_indices().begin(), column.wide_indices().end());
+        EXPECT_EQ(wide, (std::vector<size_t>{0, 2, 3, 4}));
+        EXPECT_EQ(column[0].to_string(), "0.001");
+        EXPECT_EQ(column[1].to_string(), "-3.25");
+        EXPECT_EQ(column[4].to_string(), "4.4444");
+        EXPECT_EQ(column[5], Decimal("0.1"));
+        EXPECT_EQ(column[5].get_scale(), 2);
+        EXPECT_EQ(column.payload()[5], 10);
+
+        column.clear();
+        EXPECT_TRUE(column.empty());
+        EXPECT_TRUE(column.wide_indices().empty());
+}
+
+TEST(DecimalColumnTest, Int128Payload) {
+        DecimalColumn128 column(4);
+        column.push_back(Decimal("92233720368547758.08"));
+        column.push_back(Decimal("-1.2345"));
+        column.push_back(Decimal(kInt128Max));
+        EXPECT_FALSE(column.is_wide(0));
+        EXPECT_FALSE(column.is_wide(1));
+        EXPECT_TRUE(column.is_wide(2));
+        EXPECT_TRUE(column.payload()[0] == static_cast<__int128_t>(9223372036854775808ull) * 100);
+        EXPECT_EQ(column[0], Decimal("92233720368547758.08"));
+        EXPECT_EQ(column[0].get_scale(), 4);
+        EXPECT_EQ(column[1], Decimal("-1.2345"));
+        EXPECT_EQ(column[2], Decimal(kInt128Max));
+}
+}  // namespace bignum
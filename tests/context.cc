@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "decimal.h"
+#include "decimal_context.h"
+#include "decimal_divisor.h"
+
+namespace bignum {
+using namespace detail;
+
+TEST(DecimalContextTest, Scoped) {
+        EXPECT_EQ(get_decimal_context().max_scale, Decimal::kMaxScale);
+        EXPECT_EQ(get_decimal_context().div_increase_scale, Decimal::kDivIncreaseScale);
+        EXPECT_EQ((Decimal("1.23456789") / Decimal(3)).get_scale(), 12);
+        {
+                ScopedDecimalContext guard(DecimalContext{.max_scale = 8});
+                EXPECT_EQ((Decimal(1) / Decimal(3)).to_string(), "0.3333");
+                EXPECT_EQ((Decimal("1.23456789") / Decimal(3)).to_string(), "0.41152263");
+                EXPECT_EQ((Decimal("1.5") * Decimal("0.00000001")).to_string(), "0.00000002");
+                EXPECT_EQ((Decimal("1.5") * Decimal("0.0000001")).to_string(), "0.00000015");
+                // More fractional digits than the max scale are rounded by division
+                EXPECT_EQ((Decimal("0.0000000049") / Decimal(1)).to_string(), "0");
+                EXPECT_EQ((Decimal("-0.000000005") / Decimal(1)).to_string(), "-0.00000001");
+                EXPECT_EQ((Decimal("1.2345678951") / DecimalDivisor(Decimal(1))).to_string(),
+                          "1.2345679");
+
+                // Other threads keep their own context
+                std::thread([] {
+                        EXPECT_EQ(get_decimal_context().max_scale, Decimal::kMaxScale);
+                        EXPECT_EQ((Decimal(1) / Decimal(3)).to_string(), "0.3333");
+                        EXPECT_EQ((Decimal("0.0000000049") / Decimal(1)).to_string(),
+                                  "0.0000000049");
+                }).join();
+
+                ScopedDecimalContext inner(
+                        DecimalContext{.max_scale = 30, .div_increase_scale = 12});
+                EXPECT_EQ((Decimal(1) / Decimal(3)).to_string(), "0.333333333333");
+        }
+        EXPECT_EQ(get_decimal_context().max_scale, Decimal::kMaxScale);
+        EXPECT_EQ((Decimal("1.5") * Decimal("0.00000001")).to_string(), "0.000000015");
+}
+
+TEST(DecimalContextTest, Explicit) {
+        const DecimalContext context{.max_scale = 2, .div_increase_scale = 0};
+        Decimal d(2);
+        EXPECT_FALSE(d.div(Decimal(3), context));
+        EXPECT_EQ(d.to_string(), "1");
+        d = Decimal("2.00");
+        EXPECT_FALSE(d.div<RoundingMode::kDown>(Decimal(3), context));
+        EXPECT_EQ(d.get_scale(), 0);
+        d = Decimal("2.5");
+        EXPECT_FALSE(d.div<RoundingMode::kUp>(Decimal(3), context));
+        EXPECT_EQ(d.to_string(), "0.9");
+        d = Decimal("0.125");
+        EXPECT_FALSE(d.mul<RoundingMode::kHalfEven>(Decimal("0.1"), context));
+        EXPECT_EQ(d.to_string(), "0.01");
+        EXPECT_EQ(get_decimal_context().max_scale, Decimal::kMaxScale);
+
+        // Wide values are computed in gmp, with the same result
+        d = Decimal("123456789012345678901234567890123456789012345678.9");
+        EXPECT_FALSE(d.div(Decimal("-0.3"), context));
+        EXPECT_EQ(d.to_string(), "-411522630041152263004115226300411522630041152263");
+        d = Decimal("0.123456789012345678901234567891");
+        EXPECT_FALSE(d.div(Decimal("1.000000000000000000000000000001"), context));
+        EXPECT_EQ(d.to_string(), "0.12");
+
+        EXPECT_EQ(d.div(Decimal(0), context), ErrCode(kDivByZero));
+        EXPECT_EQ(d.div(Decimal(1), DecimalContext{.max_scale = 31}), ErrCode(kInvalidArgument));
+        EXPECT_EQ(d.mul(Decimal(1), DecimalContext{.div_increase_scale = -1}),
+                  ErrCode(kInvalidArgument));
+        EXPECT_EQ(d.to_string(), "0.12");
+}
+
+TEST(DecimalContextTest, Random) {
+        std::mt19937_64 rng(20240620);
+        const DecimalContext exact{.max_scale = 30, .div_increase_scale = 30};
+        for (int32_t i = 0; i < 20000; ++i) {
+                const DecimalContext context{.max_scale = static_cast<int32_t>(rng() % 30),
+                                             .div_increase_scale =
+                                                     static_cast<int32_t>(rng() % 10)};
+                Decimal l(static_cast<int64_t>(rng()) >> (rng() % 64));
+                Decimal r(static_cast<int64_t>(rng()) >> (rng() % 64));
+                l = l * Decimal(("0." + std::string(rng() % 15, '0') + "1").c_str());
+                r = r * Decimal(("0." + std::string(rng() % 15, '0') + "1").c_str());
+                if (l == Decimal(0) || r == Decimal(0)) {
+                        // Zero quotients have scale 0, and zero divisors are an error.
+                        continue;
+                }
+
+                // A product within the max scale is exact, so rounding it once afterwards is the
+                // same.
+                Decimal product = l;
+                ASSERT_FALSE(product.mul<RoundingMode::kFloor>(r, context));
+                Decimal expected = l * r;
+                ASSERT_FALSE(expected.rescale<RoundingMode::kFloor>(
+                        std::min(expected.get_scale(), context.max_scale)));
+                ASSERT_EQ(product, expected) << l << " * " << r;
+                ASSERT_EQ(product.get_scale(), expected.get_scale());
+
+                // Truncating at scale 30 first does not change where the quotient rounds to at
+                // a smaller scale, as long as there is no tie to break.
+                const int32_t res_scale =
+                        std::min(context.max_scale, l.get_scale() + context.div_increase_scale);
+                for (RoundingMode mode : {RoundingMode::kHalfUp, RoundingMode::kDown}) {
+                        Decimal quotient = l;
+                        Decimal expected = l;
+                        ASSERT_FALSE(dispatch_rounding(mode, [&](auto m) {
+                                return quotient.div<decltype(m)::value>(r, context);
+                        }));
+                        ASSERT_FALSE(expected.div<RoundingMode::kDown>(r, exact));
+                        ASSERT_FALSE(expected.rescale(res_scale, mode));
+                        ASSERT_EQ(quotient, expected) << l << " / " << r;
+                        ASSERT_EQ(quotient.get_scale(), expected.get_scale());
+                }
+
+                ScopedDecimalContext guard(context);
+                ASSERT_EQ(l / DecimalDivisor(r), l / r) << l << " / " << r;
+                ASSERT_EQ((l / DecimalDivisor(r)).get_scale(), (l / r).get_scale());
+        }
+}
+}  // namespace bignum
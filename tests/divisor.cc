@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include "decimal_divisor.h"
+
+namespace bignum {
+using namespace detail;
+
+static const std::vector<std::string> kDividends = {
+        "0",
+        "1",
+        "-1",
+        "1.57565",
+        "-123456.00001",
+        "999999.57565",
+        "9223372036854775807",
+        "-9223372036854775808",
+        "0.000000000000000000000000000001",
+        "1.123456789012345678901234567",
+        "-1.123456789012345678901234567890",
+        "170141183460469231731687303715884105727",
+        "-170141183460469231731687303715884105728",
+        "12345678901234567890123456789012345678901234567890.123456789",
+        "-9999999999999999999999999999999999999999999999999999999999999999.999999999999999999999"
+        "999999999",
+        "99999999999999999999999999999999999999999999999999999999999999999999999999999999999999"
+        "9999999999",
+};
+
+static const std::vector<std::string> kDivisors = {
+        "1",
+        "-1",
+        "3",
+        "3.33",
+        "-7.0245",
+        "0.3",
+        "0.000000000000000000000000000007",
+        "18446744073709551615",
+        "-1844674407370955161.5",
+        "18446744073709551616",
+        "123456789012345678901234567890.123",
+        "0",
+};
+
+TEST(DecimalDivisorTest, SameAsDecimalDiv) {
+        for (const auto &rstr : kDivisors) {
+                Decimal rhs(rstr);
+                DecimalDivisor divisor(rhs);
+                for (const auto &lstr : kDividends) {
+                        Decimal expected(lstr);
+                        ErrCode expected_err = expected.div(rhs);
+
+                        Decimal res(lstr);
+                        ErrCode err = divisor.div(res);
+                        EXPECT_EQ(err, expected_err) << lstr << " / " << rstr;
+                        if (!err && !expected_err) {
+                                EXPECT_EQ(res.to_string(), expected.to_string())
+                                        << lstr << " / " << rstr;
+                                EXPECT_EQ(res.get_scale(), expected.get_scale())
+                                        << lstr << " / " << rstr;
+                                EXPECT_TRUE(res == expected) << lstr << " / " << rstr;
+                        }
+                }
+        }
+}
+
+TEST(DecimalDivisorTest, RoundHalfUp) {
+        DecimalDivisor two("2");
+        EXPECT_EQ((Decimal("0.00001") / two).to_string(), "0.000005");
+        EXPECT_EQ((Decimal("-0.00001") / two).to_string(), "-0.000005");
+
+        DecimalDivisor eight("8");
+        EXPECT_EQ((Decimal("1") / eight).to_string(), "0.125");
+        EXPECT_EQ((Decimal("0.1") / eight).to_string(), "0.0125");
+        EXPECT_EQ((Decimal("0.01") / eight).to_string(), "0.00125");
+        EXPECT_EQ((Decimal("0.0000000000000000000000000001") / eight).to_string(),
+                  "0.000000000000000000000000000013");
+        EXPECT_EQ((Decimal("-0.0000000000000000000000000001") / eight).to_string(),
+                  "-0.000000000000000000000000000013");
+
+        // Dividend with scale 30: result scale stays at 30.
+        DecimalDivisor three("3");
+        EXPECT_EQ((Decimal("0.000000000000000000000000000002") / three).to_string(),
+                  "0.000000000000000000000000000001");
+}
+
+TEST(DecimalDivisorTest, DivByZero) {
+        DecimalDivisor zero("0.00");
+        Decimal d("1.23");
+        EXPECT_EQ(zero.div(d), ErrCode(kDivByZero));
+        EXPECT_EQ(d.to_string(), "1.23");
+}
+}  // namespace bignum
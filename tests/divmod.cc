@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+
+#include "decimal.h"
+#include "test_util.h"
+
+namespace bignum {
+using namespace detail;
+
+namespace {
+// l == q * r + rem, where q is an integer and |rem| < |r|.
+void expect_divmod(const Decimal &l, const Decimal &r, const Decimal &q, const Decimal &rem) {
+        EXPECT_EQ(q.get_scale(), 0) << l << " / " << r;
+        EXPECT_EQ(q * r + rem, l) << l << " / " << r;
+        const Decimal abs_rem = rem.is_negative() ? -rem : rem;
+        const Decimal abs_r = r.is_negative() ? -r : r;
+        EXPECT_TRUE(abs_rem < abs_r) << l << " / " << r;
+}
+}  // namespace
+
+TEST(DecimalDivModTest, DivMod) {
+        Decimal q;
+        Decimal rem;
+        EXPECT_EQ(Decimal("10.5").divmod(Decimal(4), q, rem), ErrCode(kSuccess));
+        EXPECT_EQ(q.to_string(), "2");
+        EXPECT_EQ(rem.to_string(), "2.5");
+        EXPECT_EQ(Decimal("-10.5").divmod(Decimal(4), q, rem), ErrCode(kSuccess));
+        EXPECT_EQ(q.to_string(), "-2");
+        EXPECT_EQ(rem.to_string(), "-2.5");
+        EXPECT_EQ(Decimal("10.5").divmod(Decimal("-0.25"), q, rem), ErrCode(kSuccess));
+        EXPECT_EQ(q.to_string(), "-42");
+        EXPECT_EQ(rem, Decimal(0));
+        EXPECT_EQ(rem.get_scale(), 2);
+        EXPECT_EQ(Decimal(0).divmod(Decimal("0.001"), q, rem), ErrCode(kSuccess));
+        EXPECT_EQ(q, Decimal(0));
+        EXPECT_EQ(rem.get_scale(), 0);
+
+        // Quotient and remainder might be the operands
+        Decimal l("7.75");
+        Decimal r(2);
+        EXPECT_EQ(l.divmod(r, l, r), ErrCode(kSuccess));
+        EXPECT_EQ(l.to_string(), "3");
+        EXPECT_EQ(r.to_string(), "1.75");
+        l = Decimal("7.75");
+        r = Decimal(2);
+        EXPECT_EQ(l.divmod(r, r, l), ErrCode(kSuccess));
+        EXPECT_EQ(r.to_string(), "3");
+        EXPECT_EQ(l.to_string(), "1.75");
+
+        // Wide values, and INT64_MIN / -1 or kInt128Min / -1
+        EXPECT_EQ(Decimal(INT64_MIN).divmod(Decimal(-1), q, rem), ErrCode(kSuccess));
+        EXPECT_EQ(q, -Decimal(INT64_MIN));
+        EXPECT_EQ(Decimal(kInt128Min).divmod(Decimal(-1), q, rem), ErrCode(kSuccess));
+        EXPECT_EQ(q, -Decimal(kInt128Min));
+        EXPECT_EQ(rem, Decimal(0));
+        const Decimal big = power10(80) + Decimal(7);
+        EXPECT_EQ(big.divmod(power10(40), q, rem), ErrCode(kSuccess));
+        EXPECT_EQ(q, power10(40));
+        EXPECT_EQ(rem, Decimal(7));
+
+        // Errors leave the results untouched
+        q = Decimal(1);
+        rem = Decimal(2);
+        EXPECT_EQ(Decimal(1).divmod(Decimal(0), q, rem), ErrCode(kDivByZero));
+        EXPECT_EQ(power10(90).divmod(Decimal("0.000001"), q, rem),
+                  ErrCode(kDecimalDivOverflow));
+        EXPECT_EQ(q, Decimal(1));
+        EXPECT_EQ(rem, Decimal(2));
+        Decimal nan;
+        nan.poison(kDecimalMulOverflow);
+        EXPECT_EQ(Decimal(1).divmod(nan, q, rem), ErrCode(kDecimalMulOverflow));
+        EXPECT_EQ(q.get_error(), ErrCode(kDecimalMulOverflow));
+        EXPECT_EQ(rem.get_error(), ErrCode(kDecimalMulOverflow));
+}
+
+TEST(DecimalDivModTest, DivFloor) {
+        Decimal d("10.5");
+        EXPECT_EQ(d.div_floor(Decimal(4)), ErrCode(kSuccess));
+        EXPECT_EQ(d.to_string(), "2");
+        EXPECT_EQ(d.get_scale(), 0);
+        d = Decimal("-10.5");
+        EXPECT_EQ(d.div_floor(Decimal(4)), ErrCode(kSuccess));
+        EXPECT_EQ(d.to_string(), "-3");
+        d = Decimal("10.5");
+        EXPECT_EQ(d.div_floor(Decimal("-0.2")), ErrCode(kSuccess));
+        EXPECT_EQ(d.to_string(), "-53");
+        d = Decimal(-8);
+        EXPECT_EQ(d.div_floor(Decimal(-4)), ErrCode(kSuccess));
+        EXPECT_EQ(d.to_string(), "2");
+        d = -(power10(80) + Decimal(1));
+        EXPECT_EQ(d.div_floor(power10(40)), ErrCode(kSuccess));
+        EXPECT_EQ(d, -power10(40) - Decimal(1));
+        // The floored remainder 0.001 - 10^94 (at scale 3) would not fit, but is not needed
+        d = Decimal("0.001");
+        EXPECT_EQ(d.div_floor(-power10(94)), ErrCode(kSuccess));
+        EXPECT_EQ(d, Decimal(-1));
+        d = Decimal("-0.001");
+        EXPECT_EQ(d.div_floor(power10(94)), ErrCode(kSuccess));
+        EXPECT_EQ(d, Decimal(-1));
+        d = -power10(40) - Decimal(1);
+
+        EXPECT_EQ(d.div_floor(Decimal(0)), ErrCode(kDivByZero));
+        EXPECT_EQ(d, -power10(40) - Decimal(1));
+        Decimal nan;
+        nan.poison(kDivByZero);
+        EXPECT_EQ(d.div_floor(nan), ErrCode(kDivByZero));
+        EXPECT_TRUE(d.is_poisoned());
+}
+
+TEST(DecimalDivModTest, Random) {
+        std::mt19937_64 rng(20240624);
+        auto random_decimal = [&](int32_t max_digits) {
+                std::string s = rng() % 2 ? "-" : "";
+                const int32_t digits = 1 + static_cast<int32_t>(rng() % max_digits);
+                for (int32_t i = 0; i < digits; ++i) {
+                        s += static_cast<char>('0' + rng() % 10);
+                }
+                const int32_t scale = static_cast<int32_t>(rng() % std::min(digits, 31));
+                if (scale > 0) {
+                        s.insert(s.size() - scale, ".");
+                }
+                return Decimal(s.c_str());
+        };
+        for (int32_t i = 0; i < 20000; ++i) {
+                // Mostly values of int64 and int128, and some wider ones
+                const int32_t max_digits = i % 4 == 0 ? 60 : (i % 2 ? 18 : 36);
+                const Decimal l = random_decimal(max_digits);
+                const Decimal r = random_decimal(max_digits);
+                if (r == Decimal(0)) {
+                        continue;
+                }
+                Decimal q;
+                Decimal rem;
+                const ErrCode err = l.divmod(r, q, rem);
+                if (err == ErrCode(kDecimalDivOverflow)) {
+                        continue;
+                }
+                ASSERT_FALSE(err) << l << " / " << r;
+                expect_divmod(l, r, q, rem);
+                ASSERT_EQ(rem, l % r);
+                ASSERT_EQ(rem.get_scale(), (l % r).get_scale());
+                ASSERT_TRUE(rem == Decimal(0) || rem.is_negative() == l.is_negative());
+
+                Decimal floor = l;
+                ASSERT_FALSE(floor.div_floor(r));
+                const bool adjust = rem != Decimal(0) && rem.is_negative() != r.is_negative();
+                ASSERT_EQ(floor, adjust ? q - Decimal(1) : q) << l << " / " << r;
+                ASSERT_EQ(floor.get_scale(), 0);
+        }
+}
+}  // namespace bignum
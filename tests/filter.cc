@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "decimal.h"
+#include "decimal_column.h"
+#include "decimal_filter.h"
+
+namespace bignum {
+using namespace detail;
+
+namespace {
+template <typename T>
+void check_filters(const DecimalColumnImpl<T> &column, const std::vector<Decimal> &values,
+                   const Decimal &rhs) {
+        const CompareOp ops[] = {CompareOp::kLt, CompareOp::kLe, CompareOp::kEq,
+                                 CompareOp::kNe, CompareOp::kGt, CompareOp::kGe};
+        std::vector<uint64_t> bitmap((values.size() + 63) / 64, 0xdeadbeef);
+        for (CompareOp op : ops) {
+                filter(column, op, rhs, bitmap);
+                for (size_t i = 0; i < values.size(); ++i) {
+                        bool selected = (bitmap[i / 64] >> (i % 64)) & 1;
+                        ASSERT_EQ(selected, compare_decimal(values[i], op, rhs))
+                                << values[i] << " " << static_cast<int32_t>(op) << " " << rhs;
+                }
+                if (values.size() % 64) {
+                        EXPECT_EQ(bitmap.back() >> (values.size() % 64), 0u);
+                }
+        }
+        filter_between(column, rhs, rhs + Decimal("1.5"), bitmap);
+        for (size_t i = 0; i < values.size(); ++i) {
+                bool selected = (bitmap[i / 64] >> (i % 64)) & 1;
+                ASSERT_EQ(selected, rhs <= values[i] && values[i] <= rhs + Decimal("1.5"))
+                        << values[i] << " between " << rhs;
+        }
+}
+}  // namespace
+
+TEST(DecimalFilterTest, Basic) {
+        DecimalColumn column(2);
+        for (const char *s : {"1.5", "-2", "10.25", "0.125", "10.24", "99999999999999999999"}) {
+                column.push_back(Decimal(s));
+        }
+        std::vector<uint64_t> bitmap(1);
+        filter(column, CompareOp::kGt, Decimal("10.245"), bitmap);
+        EXPECT_EQ(bitmap[0], 0b100100u);
+        filter(column, CompareOp::kLe, Decimal("1.5"), bitmap);
+        EXPECT_EQ(bitmap[0], 0b001011u);
+        filter(column, CompareOp::kEq, Decimal("0.125"), bitmap);
+        EXPECT_EQ(bitmap[0], 0b001000u);
+        filter(column, CompareOp::kEq, Decimal("10.250"), bitmap);
+        EXPECT_EQ(bitmap[0], 0b000100u);
+        filter(column, CompareOp::kNe, Decimal("10.255"), bitmap);
+        EXPECT_EQ(bitmap[0], 0b111111u);
+        filter_between(column, Decimal("0.1"), Decimal("10.24"), bitmap);
+        EXPECT_EQ(bitmap[0], 0b011001u);
+
+        std::vector<uint32_t> indices;
+        selection_to_indices(bitmap, column.size(), indices);
+        EXPECT_EQ(indices, (std::vector<uint32_t>{0, 3, 4}));
+}
+
+TEST(DecimalFilterTest, NonDefaultContext) {
+        // The filter does not depend on the scale products get in the calling thread
+        ScopedDecimalContext guard(DecimalContext{.max_scale = 2});
+        DecimalColumn column(2);
+        column.push_back(Decimal("1.01"));
+        column.push_back(Decimal("1.00"));
+        std::vector<uint64_t> bitmap(1);
+        filter(column, CompareOp::kGt, Decimal("1.00999"), bitmap);
+        EXPECT_EQ(bitmap[0], 0b01u);
+        filter(column, CompareOp::kLe, Decimal("1.00999"), bitmap);
+        EXPECT_EQ(bitmap[0], 0b10u);
+        filter(column, CompareOp::kEq, Decimal("1.00999"), bitmap);
+        EXPECT_EQ(bitmap[0], 0u);
+        filter(column, CompareOp::kLt, Decimal("-1.00001"), bitmap);
+        EXPECT_EQ(bitmap[0], 0u);
+        filter_between(column, Decimal("1.00001"), Decimal("1.01001"), bitmap);
+        EXPECT_EQ(bitmap[0], 0b01u);
+}
+
+TEST(DecimalFilterTest, Random) {
+        std::mt19937_64 rng(20240613);
+        std::vector<Decimal> values;
+        DecimalColumn column(2);
+        DecimalColumn128 column128(3);
+        for (int32_t i = 0; i < 1000; ++i) {
+                Decimal d = Decimal(static_cast<int64_t>(rng() % 2000) - 1000) / Decimal(100);
+                if (rng() % 50 == 0) {
+                        d = d * Decimal("100000000000000000000");
+                } else if (rng() % 50 == 0) {
+                        d = d / Decimal(8);
+                }
+                values.push_back(d);
+                column.push_back(d);
+                column128.push_back(d);
+        }
+        const char *thresholds[] = {"0",
+                                    "-0.01",
+                                    "3.5",
+                                    "3.505",
+                                    "-3.505",
+                                    "-9.99",
+                                    "10",
+                                    "-1000000000000000000000000000000000000000000000",
+                                    "1000000000000000000000000000000000000000000000",
+                                    "170141183460469231731687303715884105.727",
+                                    "-170141183460469231731687303715884105.728",
+                                    "92233720368547758.07",
+                                    "-92233720368547758.08",
+                                    "0.000000000000000000000000000001"};
+        for (const char *t : thresholds) {
+                check_filters(column, values, Decimal(t));
+                check_filters(column128, values, Decimal(t));
+        }
+        for (int32_t i = 0; i < 50; ++i) {
+                Decimal t = values[rng() % values.size()];
+                check_filters(column, values, t);
+                check_filters(column128, values, t);
+        }
+}
+}  // namespace bignum
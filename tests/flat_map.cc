@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <string>
+
+#include "decimal.h"
+#include "decimal_flat_map.h"
+
+namespace bignum {
+using namespace detail;
+
+TEST(DecimalFlatMapTest, Basic) {
+        DecimalFlatMap<int64_t> map;
+        EXPECT_TRUE(map.empty());
+        EXPECT_EQ(map.find(Decimal(1)), nullptr);
+        EXPECT_EQ(map.find("1"), nullptr);
+
+        map[Decimal("1.5")] += 1;
+        map[Decimal("1.50")] += 1;
+        map[Decimal("0.75") * Decimal(2)] += 1;
+        map[Decimal("-1.5")] += 10;
+        map[Decimal(1000)] += 100;
+        map[Decimal("12.5") * Decimal(80)] += 100;
+        map[Decimal(0)] += 1000;
+        map[-(Decimal("0.00") * Decimal("1.5"))] += 1000;
+        EXPECT_EQ(map.size(), 4u);
+
+        ASSERT_NE(map.find(Decimal("1.5")), nullptr);
+        EXPECT_EQ(*map.find(Decimal("1.5")), 3);
+        EXPECT_EQ(*map.find("1.500"), 3);
+        EXPECT_EQ(*map.find(std::string_view("-1.5")), 10);
+        EXPECT_EQ(*map.find("1000.0"), 200);
+        EXPECT_EQ(*map.find("-0.0"), 2000);
+        EXPECT_EQ(map.find("15"), nullptr);
+        EXPECT_EQ(map.find("0.15"), nullptr);
+        EXPECT_EQ(map.find("100"), nullptr);
+        EXPECT_EQ(map.find("1.5x"), nullptr);
+        EXPECT_EQ(map.find("1..5"), nullptr);
+        EXPECT_TRUE(map.contains("1.5"));
+        EXPECT_FALSE(map.contains(Decimal("2.5")));
+
+        auto [value, inserted] = map.insert(Decimal("1.5"), 42);
+        EXPECT_FALSE(inserted);
+        EXPECT_EQ(*value, 3);
+        std::tie(value, inserted) = map.insert(Decimal("2.5"), 42);
+        EXPECT_TRUE(inserted);
+        EXPECT_EQ(*value, 42);
+        EXPECT_EQ(map.size(), 5u);
+
+        EXPECT_TRUE(map.erase(Decimal("2.50")));
+        EXPECT_FALSE(map.erase(Decimal("2.5")));
+        EXPECT_FALSE(map.contains("2.5"));
+        EXPECT_EQ(map.size(), 4u);
+
+        // Keys are given back in their canonical form
+        std::map<std::string, int64_t> entries;
+        map.for_each([&](const Decimal &key, int64_t &v) { entries[key.to_string()] = v++; });
+        std::map<std::string, int64_t> expected = {
+                {"1.5", 3}, {"-1.5", 10}, {"1000", 200}, {"0", 2000}};
+        EXPECT_EQ(entries, expected);
+        EXPECT_EQ(*map.find("1.5"), 4);
+
+        map.clear();
+        EXPECT_TRUE(map.empty());
+        EXPECT_FALSE(map.contains("1.5"));
+        EXPECT_GE(map.capacity(), 8u);
+}
+
+TEST(DecimalFlatMapTest, LargeKeys) {
+        DecimalFlatMap<std::string> map;
+        const std::string keys[] = {
+                "170141183460469231731687303715884105727",
+                "-170141183460469231731687303715884105728",
+                "12345678901234567890123456789012345678901234567890.12345678901234",
+                "-99999999999999999999999999999999999999999999999999999999999999999.9",
+                "10000000000000000000000000000000000000000000000000000000000000000000",
+        };
+        for (const std::string &key : keys) {
+                map[Decimal(key)] = key;
+        }
+        EXPECT_EQ(map.size(), 5u);
+
+        Decimal d0 = Decimal(kInt128Max) * Decimal("1.000");
+        ASSERT_NE(map.find(d0), nullptr);
+        EXPECT_EQ(*map.find(d0), keys[0]);
+        Decimal d1 = Decimal(keys[2]) * Decimal("1000.000000");
+        EXPECT_EQ(map.find(d1), nullptr);
+        EXPECT_EQ(*map.find(d1 / Decimal(1000)), keys[2]);
+        EXPECT_EQ(*map.find(keys[3] + "00"), keys[3]);
+
+        map.for_each([&](const Decimal &key, const std::string &v) {
+                EXPECT_EQ(key, Decimal(v));
+                EXPECT_EQ(key.to_string(), v);
+        });
+
+        EXPECT_TRUE(map.erase(Decimal(keys[2])));
+        EXPECT_FALSE(map.contains(keys[2]));
+        EXPECT_EQ(*map.find(keys[4]), keys[4]);
+}
+
+TEST(DecimalFlatMapTest, Random) {
+        // Against std::map, including a lot of erasures to have
+        // deleted slots cleaned up by rehashing.
+        std::mt19937_64 rng(20240611);
+        DecimalFlatMap<int64_t> map;
+        std::map<Decimal, int64_t> expected;
+        for (int32_t i = 0; i < 100000; ++i) {
+                Decimal key = Decimal(static_cast<int64_t>(rng() % 5000)) / Decimal(100);
+                if (rng() % 4 == 0) {
+                        key = key * Decimal("1000000000000000000000000000000.0");
+                }
+                bool erased = map.erase(key);
+                EXPECT_EQ(erased, expected.erase(key) > 0);
+                if (!erased || rng() % 2 == 0) {
+                        map[key] += i;
+                        expected[key] += i;
+                }
+                if (i % 1000 == 0) {
+                        ASSERT_EQ(map.size(), expected.size());
+                }
+        }
+        ASSERT_EQ(map.size(), expected.size());
+        size_t n = 0;
+        map.for_each([&](const Decimal &key, int64_t v) {
+                auto iter = expected.find(key);
+                ASSERT_NE(iter, expected.end());
+                EXPECT_EQ(iter->second, v);
+                n++;
+        });
+        EXPECT_EQ(n, expected.size());
+
+        DecimalFlatMap<int64_t> reserved(100000);
+        const size_t capacity = reserved.capacity();
+        for (int64_t i = 0; i < 100000; ++i) {
+                reserved[Decimal(i)] = i;
+        }
+        EXPECT_EQ(reserved.capacity(), capacity);
+        EXPECT_EQ(*reserved.find("99999.000"), 99999);
+}
+}  // namespace bignum
@@ -69,6 +69,23 @@ TEST_F(GmpTest, gmp_constant) {
                 auto gmp_v = get_gmp320_power10(i);
                 ASSERT_EQ(my_mpz_to_string(&gmp_v.mpz, /*scale*/ 0), gmp_pow_values[i]);
         }
+
+        // Powers of 10 for all widths, up to kDecimalMaxPrecision
+        for (int i = 0; i <= kDecimalMaxPrecision; i++) {
+                std::string expected = "1" + std::string(i, '0');
+                auto gmp_v = get_gmp320_power10(i);
+                ASSERT_EQ(my_mpz_to_string(&gmp_v.mpz, /*scale*/ 0), expected);
+                if (i <= kMaxInt128Power10) {
+                        Gmp320 gmp_i128 = conv_128_to_gmp320(get_int128_power10(i));
+                        ASSERT_EQ(my_mpz_to_string(&gmp_i128.mpz, /*scale*/ 0), expected);
+                }
+                if (i <= kMaxUint64Power10) {
+                        ASSERT_EQ(std::to_string(kUint64Power10[i]), expected);
+                        ASSERT_EQ(kUint64HalfPower10[i], kUint64Power10[i] / 2);
+                }
+        }
+        ASSERT_EQ(get_gmp320_power10(kDecimalMaxPrecision + 1), kGmpValueMinus1);
+        ASSERT_EQ(get_int64_power10(kMaxUint64Power10), -1);
 }
 
 TEST_F(GmpTest, init_gmp_with_int64_raw) {
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "decimal.h"
+
+#ifdef BIGNUM_DEV_USE_GMP_ONLY
+        #define BIGNUM_TEST_CONSTEXPR
+#else
+        #define BIGNUM_TEST_CONSTEXPR constexpr
+#endif
+
+namespace bignum {
+using namespace detail;
+
+TEST(DecimalHashTest, EqualValues) {
+        {
+                BIGNUM_TEST_CONSTEXPR Decimal d0("1.5");
+                BIGNUM_TEST_CONSTEXPR Decimal d1 = Decimal("0.75") * Decimal(2);
+                BIGNUM_TEST_CONSTEXPR uint64_t h0 = d0.hash();
+                BIGNUM_TEST_CONSTEXPR uint64_t h1 = d1.hash();
+                EXPECT_EQ(h0, h1);
+                EXPECT_EQ(h0, Decimal("1.50").hash());
+                EXPECT_NE(h0, Decimal("-1.5").hash());
+                EXPECT_NE(h0, Decimal("15").hash());
+                EXPECT_NE(h0, Decimal("0.15").hash());
+        }
+        {
+                // Zero with different scales
+                Decimal d0 = Decimal("0.00") * Decimal("1.5");
+                EXPECT_EQ(d0, Decimal(0));
+                EXPECT_EQ(d0.hash(), Decimal(0).hash());
+                EXPECT_EQ((-d0).hash(), Decimal().hash());
+        }
+        {
+                // Trailing zeros in the integral part
+                Decimal d0 = Decimal("12.5") * Decimal(80);
+                EXPECT_EQ(d0.hash(), Decimal(1000).hash());
+                EXPECT_EQ(Decimal("1000").hash(), Decimal(1000).hash());
+                EXPECT_NE(Decimal(1000).hash(), Decimal(100).hash());
+        }
+        {
+                // Different internal representations
+                Decimal d0(kInt128Max);
+                Decimal d1 = Decimal(kInt128Max) * Decimal("1.000");
+                EXPECT_EQ(d0.hash(), d1.hash());
+                EXPECT_EQ(d0.hash(), Decimal("170141183460469231731687303715884105727").hash());
+
+                Decimal d2 = Decimal(INT64_MIN);
+                Decimal d3 = Decimal(INT64_MIN) * Decimal("-1.0");
+                EXPECT_EQ((-d2).hash(), d3.hash());
+                EXPECT_EQ(d2.hash(), (-d3).hash());
+
+                Decimal d4("12345678901234567890123456789012345678901234567890.12345678901234");
+                Decimal d5 = d4 * Decimal("1000.000000");
+                Decimal d6("12345678901234567890123456789012345678901234567890123.45678901234");
+                EXPECT_EQ(d5, d6);
+                EXPECT_EQ(d5.hash(), d6.hash());
+                EXPECT_NE(d4.hash(), d6.hash());
+        }
+}
+
+TEST(DecimalHashTest, Distribution) {
+        std::unordered_set<uint64_t> hashes;
+        for (int64_t i = 0; i < 10000; ++i) {
+                Decimal d(i);
+                hashes.insert(d.hash());
+                hashes.insert((-d).hash());
+                hashes.insert((d / Decimal(1000)).hash());
+        }
+        // Duplicates: -0, 0 / 1000, and 1000 / 1000 ... 9000 / 1000, which are 1 ... 9.
+        EXPECT_EQ(hashes.size(), 3u * 10000 - 11);
+}
+
+TEST(DecimalHashTest, StdHashAndBatch) {
+        std::vector<Decimal> values = {Decimal("1.5"),
+                                       Decimal("-2"),
+                                       Decimal("0.001"),
+                                       Decimal(kInt128Min),
+                                       Decimal("99999999999999999999999999999999999999999.9"),
+                                       Decimal("1.50") * Decimal("1.0"),
+                                       Decimal("-4") / Decimal(2)};
+
+        std::unordered_map<Decimal, int> counts;
+        for (const Decimal &v : values) {
+                counts[v]++;
+        }
+        EXPECT_EQ(counts.size(), 5u);
+        EXPECT_EQ(counts[Decimal("1.5")], 2);
+        EXPECT_EQ(counts[Decimal("-2.000")], 2);
+
+        std::vector<uint64_t> hashes(values.size());
+        hash(values, hashes);
+        for (size_t i = 0; i < values.size(); ++i) {
+                EXPECT_EQ(hashes[i], values[i].hash());
+                EXPECT_EQ(hashes[i], std::hash<Decimal>{}(values[i]));
+        }
+}
+}  // namespace bignum
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "decimal.h"
+
+#ifdef BIGNUM_DEV_USE_GMP_ONLY
+        #define BIGNUM_TEST_CONSTEXPR
+#else
+        #define BIGNUM_TEST_CONSTEXPR constexpr
+#endif
+
+namespace bignum {
+using namespace detail;
+
+TEST(Int256Test, SafeAdd) {
+        Int256 res(0);
+        const Int256 one(1);
+        const Int256 minus_one(-1);
+
+        EXPECT_TRUE(!!safe_add(res, kInt256Max, one));
+        EXPECT_TRUE(!!safe_add(res, kInt256Min, minus_one));
+        EXPECT_TRUE(!!safe_add(res, kInt256Max, kInt256Max));
+        EXPECT_TRUE(!!safe_add(res, kInt256Min, kInt256Min));
+
+        EXPECT_TRUE(!safe_add(res, kInt256Max, kInt256Min));
+        EXPECT_EQ(res, minus_one);
+        EXPECT_TRUE(!safe_add(res, kInt256Max, minus_one));
+        EXPECT_TRUE(!safe_add(res, res, one));
+        EXPECT_EQ(res, kInt256Max);
+
+        // Carry from the low half into the high half
+        Int256 lo_max(0, ~static_cast<__uint128_t>(0));
+        EXPECT_TRUE(!safe_add(res, lo_max, one));
+        EXPECT_EQ(res, Int256(1, 0));
+        EXPECT_TRUE(!safe_add(res, res, minus_one));
+        EXPECT_EQ(res, lo_max);
+}
+
+TEST(Int256Test, SafeMul) {
+        Int256 res(0);
+        const Int256 two(2);
+        const Int256 minus_one(-1);
+        const Int256 i128min(kInt128Min);
+
+        EXPECT_TRUE(!safe_mul(res, Int256(123), Int256(-456)));
+        EXPECT_EQ(res, Int256(-56088));
+
+        // |int128 * int128| <= 2^254
+        EXPECT_TRUE(!safe_mul(res, i128min, i128min));
+        EXPECT_EQ(res, Int256(static_cast<__int128_t>(1) << 126, 0));
+
+        // -2^128 * 2^127 == kInt256Min
+        const Int256 pow2_127(0, static_cast<__uint128_t>(1) << 127);
+        EXPECT_TRUE(!safe_mul(res, Int256(-1, 0), pow2_127));
+        EXPECT_EQ(res, kInt256Min);
+        EXPECT_TRUE(!!safe_mul(res, Int256(1, 0), pow2_127));
+
+        EXPECT_TRUE(!!safe_mul(res, kInt256Max, two));
+        EXPECT_TRUE(!!safe_mul(res, kInt256Min, minus_one));
+        EXPECT_TRUE(!!safe_mul(res, kInt256Max, kInt256Max));
+        EXPECT_TRUE(!safe_mul(res, kInt256Min, Int256(1)));
+        EXPECT_EQ(res, kInt256Min);
+        EXPECT_TRUE(!safe_mul(res, kInt256Max, minus_one));
+        EXPECT_TRUE(!safe_add(res, res, minus_one));
+        EXPECT_EQ(res, kInt256Min);
+}
+
+TEST(Int256Test, ToString) {
+        EXPECT_EQ(decimal_256_to_string(Int256(0), 0), "0");
+        EXPECT_EQ(decimal_256_to_string(Int256(-123), 2), "-1.23");
+        EXPECT_EQ(decimal_256_to_string(kInt256Max, 0),
+                  "57896044618658097711785492504343953926634992332820282019728792003956564819967");
+        EXPECT_EQ(decimal_256_to_string(kInt256Min, 30),
+                  "-57896044618658097711785492504343953926634992332."
+                  "820282019728792003956564819968");
+}
+
+TEST(Int256Test, DecimalArithmetic) {
+        {
+                BIGNUM_TEST_CONSTEXPR Decimal d0("1234567890123456789012345678.12345678");
+                BIGNUM_TEST_CONSTEXPR Decimal d1("-9876543210987654321098765432.1234567");
+                BIGNUM_TEST_CONSTEXPR Decimal d2 = d0 * d1;
+                EXPECT_EQ(d2.to_string(),
+                          "-12193263113702179522618503265721688554322512802221002994."
+                          "890413126651426");
+                BIGNUM_TEST_CONSTEXPR Decimal d3 = d2 - d2 + d0;
+                EXPECT_EQ(d3, d0);
+                BIGNUM_TEST_CONSTEXPR bool lt = d2 < d1;
+                EXPECT_TRUE(lt);
+        }
+        {
+                BIGNUM_TEST_CONSTEXPR Decimal d0 = Decimal(kInt128Max);
+                BIGNUM_TEST_CONSTEXPR Decimal d1 = d0 + d0;
+                EXPECT_EQ(d1.to_string(), "340282366920938463463374607431768211454");
+                EXPECT_TRUE(d1 > d0);
+                EXPECT_TRUE(-d1 < -d0);
+        }
+        {
+                Decimal d0("12345678901234567890123456789.123456789");
+                Decimal d1("98765432109876543210987654321.987654321");
+                EXPECT_EQ((d0 * d1).to_string(),
+                          "1219326311370217952261850327360615759547340344433609205911."
+                          "347203169112635269");
+                Decimal d2("99999999999999999999999999999999999999.9999999999");
+                EXPECT_EQ((d2 + d2).to_string(),
+                          "199999999999999999999999999999999999999.9999999998");
+        }
+        {
+                // Rounding when the scale overflows
+                Decimal d0("1234567890.123456789012345678901234567891");
+                Decimal d1("-3.00000000000000000000000000005");
+                EXPECT_EQ((d0 * d1).to_string(), "-3703703670.370370367037037036765432098179");
+        }
+        {
+                // int128 min value negation
+                Decimal d0 = Decimal(kInt128Min);
+                EXPECT_EQ((-d0).to_string(), "170141183460469231731687303715884105728");
+                EXPECT_EQ(-(-d0), d0);
+        }
+        {
+                // Beyond 76 digits: fall back to gmp
+                Decimal d0("123456789012345678901234567890123456789.5");
+                EXPECT_EQ((d0 * d0).to_string(),
+                          "152415787532388367504953515625666819451287913466377076667762536"
+                          "19888873647310.25");
+                Decimal d1("5789604461865809771178549250434395392663499233282028201972879200395656"
+                           "481996.7");
+                EXPECT_EQ((d1 + Decimal("0.3")).to_string(),
+                          "5789604461865809771178549250434395392663499233282028201972879200395656"
+                          "481997");
+                EXPECT_EQ((d1 * Decimal("10")) / Decimal("10"), d1);
+        }
+        {
+                // Comparison with different scales
+                Decimal d0("57896044618658097711785492504343953926634."
+                           "992332820282019728792003956564");
+                Decimal d1("57896044618658097711785492504343953926634."
+                           "99233282028201972879200395656");
+                EXPECT_TRUE(d0 > d1);
+                EXPECT_TRUE(-d0 < -d1);
+                EXPECT_TRUE(d0 != d1);
+                EXPECT_EQ(d1, Decimal("57896044618658097711785492504343953926634."
+                                      "992332820282019728792003956560"));
+        }
+}
+}  // namespace bignum
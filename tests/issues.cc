@@ -70,4 +70,26 @@ TEST(IssueTest, case007) {
         Decimal res = d1 - d2;
         EXPECT_EQ(static_cast<std::string>(res), "-0.2129776087703600575");
 }
+
+// int64 + int64 overflows int128 when scaling up by 10^27
+TEST(IssueTest, case008) {
+        Decimal d1("0.000000000001326568022144442789");
+        Decimal d2("-47926743022094.054");
+        Decimal res = d1 + d2;
+        EXPECT_EQ(static_cast<std::string>(res), "-47926743022094.053999999998673431977855557211");
+        res = d2 + d1;
+        EXPECT_EQ(static_cast<std::string>(res), "-47926743022094.053999999998673431977855557211");
+}
+
+// int64 vs int64 with scales 19 or more apart, where 10^scale_diff does not fit into int64
+TEST(IssueTest, case009) {
+        Decimal d1("4.88");
+        Decimal d2("0.000000000000000000000000000001");
+        EXPECT_TRUE(d1 > d2);
+        EXPECT_TRUE(d2 < d1);
+        EXPECT_FALSE(d1 < d2);
+        EXPECT_FALSE(d1 == d2);
+        EXPECT_TRUE(Decimal("-4.88") < d2);
+        EXPECT_TRUE(Decimal(0) < d2);
+}
 }  // namespace bignum
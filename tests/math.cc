@@ -0,0 +1,376 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+
+#include "decimal.h"
+#include "decimal_math.h"
+
+namespace bignum {
+using namespace detail;
+
+TEST(DecimalMathTest, Pow) {
+        EXPECT_EQ(pow(Decimal("1.05"), 10).to_string(), "1.62889462677744140625");
+        EXPECT_EQ(pow(Decimal("1.05"), 10).get_scale(), 20);
+        EXPECT_EQ(pow(Decimal("-1.5"), 3).to_string(), "-3.375");
+        EXPECT_EQ(pow(Decimal(2), 64), Decimal(static_cast<__int128_t>(1) << 64));
+        EXPECT_EQ(pow(Decimal(2), 300).to_string(),
+                  "2037035976334486086268445688409378161051468393665936250636140449354381299763"
+                  "336706183397376");
+        EXPECT_EQ(pow(Decimal(100), 40), pow10(80));
+        EXPECT_EQ(pow(Decimal("-0.1"), 30).to_string(), "0." + std::string(29, '0') + "1");
+        EXPECT_EQ(pow(Decimal("123.456"), 19).to_string(),
+                  "5479385182077336791503487705285398982172.768024285426671647475884910361");
+
+        // Rounded once rather than at every step
+        EXPECT_EQ(pow(Decimal("1.0001"), 365).to_string(), "1.037172411302551929902028017056");
+        EXPECT_EQ(pow(Decimal("1.000136986301369863013698630137"), 10950).to_string(),
+                  "4.4812286885245152477522800865");
+        EXPECT_EQ(pow(Decimal("-1.5"), 101).to_string(),
+                  "-609841766302822856.095919561350562506515581835949");
+        EXPECT_EQ(pow(Decimal("1.000000000001"), 100000000000000).to_string(),
+                  "26881171416817295913252685294913191337689554.759557159341837996432601804705");
+        {
+                ScopedDecimalContext guard(DecimalContext{.max_scale = 10});
+                EXPECT_EQ(pow(Decimal("1.000000000001"), 100000000000000).to_string(),
+                          "26881171416817295913252685294913191337689554.7595571593");
+        }
+
+        // Values below half an ulp
+        EXPECT_EQ(pow(Decimal("0.9"), 700), Decimal(0));
+        EXPECT_EQ(pow<RoundingMode::kUp>(Decimal("0.9"), 700).to_string(),
+                  "0." + std::string(29, '0') + "1");
+        EXPECT_EQ(pow<RoundingMode::kFloor>(Decimal("-0.9"), 701).to_string(),
+                  "-0." + std::string(29, '0') + "1");
+        EXPECT_EQ(pow(Decimal("0.99999999"), 10000000000), Decimal(0));
+        EXPECT_EQ(pow(Decimal("0.5"), INT64_MAX), Decimal(0));
+
+        // Negative exponents
+        EXPECT_EQ(pow(Decimal("1.05"), -10).to_string(), "0.613913253540759374358546898604");
+        EXPECT_EQ(pow(Decimal(2), -100).to_string(), "0." + std::string(29, '0') + "1");
+        EXPECT_EQ(pow(Decimal("1.23456789"), -50).to_string(), "0.000026561410973026775212160887");
+        EXPECT_EQ(pow<RoundingMode::kFloor>(Decimal("1.23456789"), -50).to_string(),
+                  "0.000026561410973026775212160886");
+        EXPECT_EQ(pow(Decimal("0.5"), -3), Decimal(8));
+        EXPECT_EQ(pow(Decimal(3), INT64_MIN), Decimal(0));
+
+        EXPECT_EQ(pow(Decimal(0), 0), Decimal(1));
+        EXPECT_EQ(pow(Decimal(0), 5), Decimal(0));
+        EXPECT_EQ(pow(Decimal("123.45"), 0), Decimal(1));
+        EXPECT_EQ(pow(Decimal(-1), INT64_MAX), Decimal(-1));
+        EXPECT_EQ(pow(Decimal("-1.000"), -4), Decimal(1));
+
+        // Powers of 1, -1 and 0 have the scale of any other power
+        const Decimal one = Decimal("0.25") * Decimal(4);  // 1.00
+        const Decimal zero = Decimal(0) * Decimal("0.01");  // 0.00
+        ASSERT_EQ(one.get_scale(), 2);
+        ASSERT_EQ(zero.get_scale(), 2);
+        EXPECT_EQ(pow(one, 3).get_scale(), 6);
+        EXPECT_EQ(pow(one, 20), Decimal(1));
+        EXPECT_EQ(pow(one, 20).get_scale(), 30);
+        EXPECT_EQ(pow(-one, 21), Decimal(-1));
+        EXPECT_EQ(pow(-one, 21).get_scale(), 30);
+        EXPECT_EQ(pow(-one, -2), Decimal(1));
+        EXPECT_EQ(pow(-one, -2).get_scale(), 30);
+        EXPECT_EQ(pow(zero, 3).get_scale(), 6);
+        EXPECT_EQ(pow(zero, 20), Decimal(0));
+        EXPECT_EQ(pow(zero, 20).get_scale(), 30);
+        {
+                ScopedDecimalContext guard(DecimalContext{.max_scale = 10});
+                EXPECT_EQ(pow(one, 20).get_scale(), 10);
+                EXPECT_EQ(pow(one, -1).get_scale(), 10);
+        }
+
+        Decimal result(7);
+        EXPECT_EQ(pow(Decimal(0), -1, result), ErrCode(kDivByZero));
+        EXPECT_EQ(pow(Decimal(10), 96, result), ErrCode(kDecimalMulOverflow));
+        EXPECT_EQ(pow(Decimal("1.01"), INT64_MAX, result), ErrCode(kDecimalMulOverflow));
+        EXPECT_EQ(pow(Decimal("0.1"), -96, result), ErrCode(kDecimalDivOverflow));
+        EXPECT_EQ(result, Decimal(7));
+        EXPECT_EQ(pow(Decimal(10), 95, result), ErrCode(kSuccess));
+        EXPECT_EQ(result, pow10(95));
+        Decimal nan;
+        nan.poison(kDivByZero);
+        EXPECT_EQ(pow(nan, 2, result), ErrCode(kDivByZero));
+        EXPECT_TRUE(result.is_poisoned());
+
+        // The result might be the base
+        result = Decimal("1.1");
+        EXPECT_EQ(pow(result, 2, result), ErrCode(kSuccess));
+        EXPECT_EQ(result.to_string(), "1.21");
+
+#ifdef BIGNUM_ENABLE_EXCEPTIONS
+        EXPECT_THROW(pow(Decimal(0), -1), std::runtime_error);
+#endif
+}
+
+TEST(DecimalMathTest, PowRandom) {
+        // Exact powers against repeated multiplications
+        std::mt19937_64 rng(20240625);
+        for (int32_t i = 0; i < 20000; ++i) {
+                std::string s = rng() % 2 ? "-" : "";
+                const int32_t digits = 1 + static_cast<int32_t>(rng() % 12);
+                for (int32_t j = 0; j < digits; ++j) {
+                        s += static_cast<char>('0' + rng() % 10);
+                }
+                const int32_t scale = static_cast<int32_t>(rng() % std::min(digits, 4));
+                if (scale > 0) {
+                        s.insert(s.size() - scale, ".");
+                }
+                const Decimal base(s.c_str());
+                const int64_t n = static_cast<int64_t>(rng() % 8);
+                Decimal expected(1);
+                for (int64_t j = 0; j < n; ++j) {
+                        expected *= base;
+                }
+                Decimal result;
+                ASSERT_FALSE(pow(base, n, result)) << base << "^" << n;
+                ASSERT_EQ(result, expected) << base << "^" << n;
+                ASSERT_EQ(result.get_scale(), expected.get_scale()) << base << "^" << n;
+        }
+}
+
+TEST(DecimalMathTest, Pow10) {
+        EXPECT_EQ(pow10(0), Decimal(1));
+        EXPECT_EQ(pow10(3), Decimal(1000));
+        EXPECT_EQ(pow10(-3).to_string(), "0.001");
+        EXPECT_EQ(pow10(-30).get_scale(), 30);
+        EXPECT_EQ(pow10(95).to_string(), "1" + std::string(95, '0'));
+#ifdef BIGNUM_ENABLE_EXCEPTIONS
+        EXPECT_THROW(pow10(96), std::runtime_error);
+        EXPECT_THROW(pow10(-31), std::runtime_error);
+#endif
+
+        Decimal d("123.45");
+        EXPECT_EQ(mul_pow10(d, 1), ErrCode(kSuccess));
+        EXPECT_EQ(d.to_string(), "1234.5");
+        EXPECT_EQ(mul_pow10(d, -4), ErrCode(kSuccess));
+        EXPECT_EQ(d.to_string(), "0.12345");
+        EXPECT_EQ(d.get_scale(), 5);
+        EXPECT_EQ(mul_pow10(d, 10), ErrCode(kSuccess));
+        EXPECT_EQ(d.to_string(), "1234500000");
+        EXPECT_EQ(d.get_scale(), 0);
+        EXPECT_EQ(mul_pow10(d, -35), ErrCode(kSuccess));
+        EXPECT_EQ(d.to_string(), "0." + std::string(25, '0') + "12345");
+        EXPECT_EQ(mul_pow10(d, -3), ErrCode(kSuccess));
+        EXPECT_EQ(d.to_string(), "0." + std::string(28, '0') + "12");
+        d = Decimal("-0.5");
+        EXPECT_EQ(mul_pow10(d, -30), ErrCode(kSuccess));
+        EXPECT_EQ(d.to_string(), "-0." + std::string(29, '0') + "1");
+        EXPECT_EQ(mul_pow10<RoundingMode::kDown>(d, -INT32_MAX), ErrCode(kSuccess));
+        EXPECT_EQ(d, Decimal(0));
+
+        d = Decimal(12);
+        EXPECT_EQ(mul_pow10(d, 94), ErrCode(kSuccess));
+        EXPECT_EQ(d.to_string(), "12" + std::string(94, '0'));
+        d = Decimal(12);
+        EXPECT_EQ(mul_pow10(d, 95), ErrCode(kDecimalMulOverflow));
+        EXPECT_EQ(d, Decimal(12));
+        d = Decimal(0);
+        EXPECT_EQ(mul_pow10(d, INT32_MAX), ErrCode(kSuccess));
+        EXPECT_EQ(d, Decimal(0));
+}
+
+TEST(DecimalMathTest, Sqrt) {
+        EXPECT_EQ(sqrt(Decimal(2), 30).to_string(), "1.41421356237309504880168872421");
+        EXPECT_EQ(sqrt(Decimal(2), 4).to_string(), "1.4142");
+        EXPECT_EQ(sqrt(Decimal(2), 4).get_scale(), 4);
+        EXPECT_EQ(sqrt(Decimal(144), 0), Decimal(12));
+        EXPECT_EQ(sqrt(Decimal("2.25"), 0), Decimal(2));
+        EXPECT_EQ(sqrt(Decimal("6.25"), 0), Decimal(3));
+        EXPECT_EQ(sqrt<RoundingMode::kHalfEven>(Decimal("0.0625"), 1).to_string(), "0.2");
+        EXPECT_EQ(sqrt<RoundingMode::kUp>(Decimal(2), 2).to_string(), "1.42");
+        EXPECT_EQ(sqrt(Decimal("0.0000000000000000000000000002"), 30).to_string(),
+                  "0.00000000000001414213562373095");
+        EXPECT_EQ(sqrt(Decimal(std::string(96, '9').c_str()), 30).to_string(),
+                  "1" + std::string(48, '0'));
+        EXPECT_EQ(sqrt(Decimal("12345678901234567890123456789012345678901234567890.1234567890123"
+                               "45678901234567890"),
+                       30)
+                          .to_string(),
+                  "3513641828820144253111222.381699882939174840877239400337");
+        EXPECT_EQ(sqrt(Decimal(0), 3).get_scale(), 3);
+
+        Decimal result(7);
+        EXPECT_EQ(sqrt(Decimal(-1), 2, result), ErrCode(kInvalidArgument));
+        EXPECT_EQ(sqrt(Decimal(2), 31, result), ErrCode(kInvalidArgument));
+        EXPECT_EQ(sqrt(Decimal(2), -1, result), ErrCode(kInvalidArgument));
+        EXPECT_EQ(result, Decimal(7));
+        Decimal nan;
+        nan.poison(kDivByZero);
+        EXPECT_EQ(sqrt(nan, 2, result), ErrCode(kDivByZero));
+        EXPECT_TRUE(result.is_poisoned());
+
+        EXPECT_EQ(nth_root(Decimal("1.05"), 12, 30).to_string(),
+                  "1.004074123783648301605419602672");
+        EXPECT_EQ(nth_root(Decimal("-27.5"), 3, 20).to_string(), "-3.01840536839884294526");
+        EXPECT_EQ(nth_root(Decimal("123456789.123456789"), 16, 30).to_string(),
+                  "3.204200516573232882581812531678");
+        EXPECT_EQ(nth_root(Decimal(-8), 3, 0), Decimal(-2));
+        EXPECT_EQ(nth_root(Decimal("1.25"), 1, 1).to_string(), "1.3");
+        EXPECT_EQ(nth_root(Decimal(-16), 4, 2, result), ErrCode(kInvalidArgument));
+        EXPECT_EQ(nth_root(Decimal(2), 17, 2, result), ErrCode(kInvalidArgument));
+        EXPECT_EQ(nth_root(Decimal(2), 0, 2, result), ErrCode(kInvalidArgument));
+
+#ifdef BIGNUM_ENABLE_EXCEPTIONS
+        EXPECT_THROW(sqrt(Decimal(-1), 2), std::runtime_error);
+#endif
+}
+
+TEST(DecimalMathTest, RootRandom) {
+        // A root r truncated to the scale has r^n <= d < (r + ulp)^n
+        std::mt19937_64 rng(20240626);
+        for (int32_t i = 0; i < 20000; ++i) {
+                const int32_t n = 1 + static_cast<int32_t>(rng() % 4);
+                std::string s = n % 2 && rng() % 2 ? "-" : "";
+                const int32_t digits = 1 + static_cast<int32_t>(rng() % 40);
+                for (int32_t j = 0; j < digits; ++j) {
+                        s += static_cast<char>('0' + rng() % 10);
+                }
+                const int32_t dscale = static_cast<int32_t>(rng() % std::min(digits, 31));
+                if (dscale > 0) {
+                        s.insert(s.size() - dscale, ".");
+                }
+                const Decimal d(s.c_str());
+                const int32_t scale = static_cast<int32_t>(rng() % (30 / n + 1));
+                const Decimal ulp = pow10(-scale);
+
+                const Decimal r = nth_root<RoundingMode::kDown>(d, n, scale);
+                ASSERT_EQ(r.get_scale(), scale);
+                const Decimal abs_d = d.is_negative() ? -d : d;
+                const Decimal abs_r = r.is_negative() ? -r : r;
+                ASSERT_LE(pow(abs_r, n), abs_d) << d << " " << n << " " << scale;
+                ASSERT_GT(pow(abs_r + ulp, n), abs_d) << d << " " << n << " " << scale;
+
+                const Decimal rounded = nth_root(d, n, scale);
+                ASSERT_TRUE(rounded == r || rounded == r + (d.is_negative() ? -ulp : ulp));
+        }
+}
+TEST(DecimalMathTest, Exp) {
+        EXPECT_EQ(exp(Decimal(1), 30).to_string(), "2.718281828459045235360287471353");
+        EXPECT_EQ(exp(Decimal(-1), 30).to_string(), "0.367879441171442321595523770161");
+        EXPECT_EQ(exp(Decimal("-0.5"), 30).to_string(), "0.606530659712633423603799534991");
+        EXPECT_EQ(exp(Decimal("12.345678"), 20).to_string(), "229963.98760140015784124382");
+        EXPECT_EQ(exp(Decimal(221), 0).to_string(),
+                  "9529727902367202538635563498630489223513238831294354101555561209622211317847"
+                  "66072183161032772769");
+        EXPECT_EQ(exp<RoundingMode::kDown>(Decimal(1), 2).to_string(), "2.71");
+        EXPECT_EQ(exp<RoundingMode::kUp>(Decimal(1), 2).to_string(), "2.72");
+        const Decimal tiny(("0." + std::string(29, '0') + "1").c_str());
+        EXPECT_EQ(exp<RoundingMode::kDown>(tiny, 30), Decimal(1) + tiny);
+        EXPECT_EQ(exp(Decimal(-70), 30), Decimal(0));
+        EXPECT_EQ(exp<RoundingMode::kUp>(Decimal(-70), 30), tiny);
+        EXPECT_EQ(exp<RoundingMode::kUp>(Decimal(-1000), 30), tiny);
+
+        // Exact results
+        EXPECT_EQ(exp<RoundingMode::kUp>(Decimal(0), 5), Decimal(1));
+        EXPECT_EQ(exp(Decimal(0), 5).get_scale(), 5);
+
+        Decimal result(7);
+        EXPECT_EQ(exp(Decimal(222), 0, result), ErrCode(kDecimalValueOutOfRange));
+        EXPECT_EQ(exp(Decimal(221), 1, result), ErrCode(kDecimalValueOutOfRange));
+        EXPECT_EQ(exp(Decimal(1000000), 0, result), ErrCode(kDecimalValueOutOfRange));
+        EXPECT_EQ(exp(Decimal(1), 31, result), ErrCode(kInvalidArgument));
+        EXPECT_EQ(result, Decimal(7));
+        Decimal nan;
+        nan.poison(kDivByZero);
+        EXPECT_EQ(exp(nan, 2, result), ErrCode(kDivByZero));
+        EXPECT_TRUE(result.is_poisoned());
+}
+
+TEST(DecimalMathTest, Ln) {
+        EXPECT_EQ(ln(Decimal(2), 30).to_string(), "0.693147180559945309417232121458");
+        EXPECT_EQ(ln(Decimal("0.5"), 30).to_string(), "-0.693147180559945309417232121458");
+        EXPECT_EQ(ln(Decimal("1.05"), 30).to_string(), "0.048790164169432003065374404223");
+        EXPECT_EQ(ln(Decimal("0.05"), 10).to_string(), "-2.9957322736");
+        EXPECT_EQ(ln(Decimal("1.0000001"), 30).to_string(), "0.000000099999995000000333333308");
+        EXPECT_EQ(ln(Decimal(std::string(96, '9').c_str()), 30).to_string(),
+                  "221.048168927428385665727179649699");
+        EXPECT_EQ(ln(Decimal(("0." + std::string(29, '0') + "1").c_str()), 30).to_string(),
+                  "-69.077552789821370520539743640531");
+        EXPECT_EQ(log10(Decimal(2), 30).to_string(), "0.301029995663981195213738894724");
+        EXPECT_EQ(log10(Decimal(2), 4).to_string(), "0.301");
+        EXPECT_EQ(log10(Decimal(2), 4).get_scale(), 4);
+        EXPECT_EQ(log10(Decimal("12345678901234567890.123"), 30).to_string(),
+                  "19.091514977212699895710814209377");
+
+        // Exact results
+        EXPECT_EQ(ln<RoundingMode::kUp>(Decimal(1), 30), Decimal(0));
+        EXPECT_EQ(log10<RoundingMode::kUp>(Decimal(1000), 30), Decimal(3));
+        EXPECT_EQ(log10<RoundingMode::kDown>(Decimal("0.001"), 30), Decimal(-3));
+        EXPECT_EQ(log10(Decimal("100.00"), 2).get_scale(), 2);
+
+        Decimal result(7);
+        EXPECT_EQ(ln(Decimal(0), 2, result), ErrCode(kInvalidArgument));
+        EXPECT_EQ(ln(Decimal(-1), 2, result), ErrCode(kInvalidArgument));
+        EXPECT_EQ(log10(Decimal(-10), 2, result), ErrCode(kInvalidArgument));
+        EXPECT_EQ(log10(Decimal(2), 31, result), ErrCode(kInvalidArgument));
+        EXPECT_EQ(result, Decimal(7));
+
+#ifdef BIGNUM_ENABLE_EXCEPTIONS
+        EXPECT_THROW(ln(Decimal(0), 2), std::runtime_error);
+#endif
+}
+
+TEST(DecimalMathTest, ExpLnRandom) {
+        // Results of inexact values truncated and rounded up are one ulp apart, and exp() and
+        // ln() are inverse to each other up to rounding.
+        std::mt19937_64 rng(20240627);
+        auto random_decimal = [&](int32_t max_digits) {
+                std::string s = rng() % 2 ? "-" : "";
+                const int32_t digits = 1 + static_cast<int32_t>(rng() % max_digits);
+                for (int32_t i = 0; i < digits; ++i) {
+                        s += static_cast<char>('0' + rng() % 10);
+                }
+                const int32_t scale = static_cast<int32_t>(rng() % std::min(digits, 31));
+                if (scale > 0) {
+                        s.insert(s.size() - scale, ".");
+                }
+                return Decimal(s.c_str());
+        };
+        for (int32_t i = 0; i < 2000; ++i) {
+                const int32_t scale = static_cast<int32_t>(rng() % 31);
+                const Decimal ulp = pow10(-scale);
+                // In [-200, 200], where larger values overflow at larger scales
+                const Decimal x = Decimal(static_cast<int64_t>(rng() % 401) - 200) +
+                                  random_decimal(30) * pow10(-30);
+                Decimal down;
+                Decimal up;
+                Decimal e;
+                const ErrCode err = exp<RoundingMode::kDown>(x, scale, down);
+                if (err) {
+                        ASSERT_EQ(err, ErrCode(kDecimalValueOutOfRange)) << x << " " << scale;
+                } else if (x != Decimal(0)) {
+                        ASSERT_FALSE(exp<RoundingMode::kUp>(x, scale, up));
+                        ASSERT_EQ(up, down + ulp) << x << " " << scale;
+                        ASSERT_FALSE(exp(x, scale, e));
+                        ASSERT_TRUE(e == down || e == up);
+                }
+
+                Decimal d = random_decimal(60);
+                if (d.is_negative()) {
+                        d = -d;
+                }
+                if (d == Decimal(0) || d == Decimal(1)) {
+                        continue;
+                }
+                const Decimal lower = ln<RoundingMode::kFloor>(d, scale);
+                ASSERT_EQ(ln<RoundingMode::kCeiling>(d, scale), lower + ulp) << d << " " << scale;
+                std::string digits = d.to_string();
+                std::erase(digits, '0');
+                std::erase(digits, '.');
+                if (digits != "1") {
+                        // Not a power of 10
+                        ASSERT_EQ(log10<RoundingMode::kCeiling>(d, scale),
+                                  log10<RoundingMode::kFloor>(d, scale) + ulp)
+                                << d << " " << scale;
+                }
+
+                // exp(ln(d)) is d up to its own ulp and the error of ln(d) at scale 30
+                Decimal back;
+                ASSERT_FALSE(exp(ln(d, 30), 30, back));
+                const Decimal diff = back > d ? back - d : d - back;
+                ASSERT_LE(diff, d * Decimal("0.0000000000000000000000000001") + pow10(-30))
+                        << d;
+        }
+}
+}  // namespace bignum
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 #include "decimal.h"
 
@@ -1932,6 +1934,102 @@ TEST_F(BIGNUM_DECIMAL_FIXTURE, unsigned_value_constructor) {
         }
 }
 
+TEST_F(BIGNUM_DECIMAL_FIXTURE, precision_and_trailing_zeros) {
+        {
+                BIGNUM_TEST_CONSTEXPR Decimal d0;
+                BIGNUM_TEST_CONSTEXPR Decimal d1("-123.4500");
+                BIGNUM_TEST_CONSTEXPR Decimal d2("12300");
+                BIGNUM_TEST_CONSTEXPR int32_t p0 = d0.precision();
+                BIGNUM_TEST_CONSTEXPR int32_t p1 = d1.precision();
+                BIGNUM_TEST_CONSTEXPR int32_t z2 = d2.trailing_zeros();
+                BIGNUM_TEST_CONSTEXPR Decimal d3 = -d1 * d2;
+                BIGNUM_TEST_CONSTEXPR int32_t p3 = d3.precision();
+                EXPECT_EQ(p0, 1);
+                EXPECT_EQ(d0.trailing_zeros(), 0);
+                EXPECT_EQ(p1, 5);
+                EXPECT_EQ(d1.trailing_zeros(), 0);
+                EXPECT_EQ(d2.precision(), 5);
+                EXPECT_EQ(z2, 2);
+                EXPECT_EQ(p3, 9);
+                EXPECT_EQ(d3.trailing_zeros(), 2);
+        }
+        {
+                // 30 with scale 1
+                Decimal d0 = Decimal("1.5") * Decimal(2);
+                EXPECT_EQ(d0.precision(), 2);
+                EXPECT_EQ(d0.trailing_zeros(), 1);
+
+                // The cache is dropped on change, but kept on copy and negation
+                Decimal d1 = d0;
+                d0 += Decimal("0.01");
+                EXPECT_EQ(d0.precision(), 3);
+                EXPECT_EQ(d0.trailing_zeros(), 0);
+                d1 = -d1;
+                EXPECT_EQ(d1.precision(), 2);
+                EXPECT_EQ(d1.trailing_zeros(), 1);
+        }
+        {
+                Decimal d0(INT64_MIN);
+                EXPECT_EQ(d0.precision(), 19);
+                EXPECT_EQ((-d0).precision(), 19);
+                Decimal d1(kInt128Min);
+                EXPECT_EQ((-d1).precision(), 39);
+                Decimal d2("-9999999999999999999999999999999999999999999999999999999999999999999999"
+                           "99999999999999999999999999");
+                EXPECT_EQ(d2.precision(), 96);
+                EXPECT_EQ((d2 + Decimal(1)).trailing_zeros(), 0);
+                EXPECT_EQ((d2 - Decimal(-1)).precision(), 96);
+                Decimal d3("10000000000000000000000000000000000000000000000000000000000000000000000"
+                           "0000000000000000000000000");
+                EXPECT_EQ(d3.precision(), 96);
+                EXPECT_EQ(d3.trailing_zeros(), 95);
+        }
+        {
+                // Equality and comparison with cached metadata
+                Decimal d0("1.5");
+                Decimal d1 = Decimal("0.75") * Decimal(2);
+                EXPECT_EQ(d0.trailing_zeros() + d1.trailing_zeros(), 1);
+                EXPECT_EQ(d0, d1);
+                Decimal d2("1.05");
+                (void)d2.trailing_zeros();
+                EXPECT_NE(d0, d2);
+                EXPECT_NE(Decimal("0.00") * Decimal("1.5"), d0);
+                EXPECT_EQ(Decimal("0.00") * Decimal("1.5"), Decimal(0));
+
+                Decimal d3("12345678901234567890123456789012345678901234567890.12");
+                Decimal d4("9999999999999999999999999999999999999999999999999.99999");
+                EXPECT_GT(d3, d4);
+                EXPECT_LT(-d3, -d4);
+                EXPECT_EQ(d3, d3 * Decimal("1.00"));
+                EXPECT_GT(d3 * Decimal("1.001"), d3);
+        }
+        {
+                // Threads filling in the cache of a shared const decimal at the same time (run it
+                // under -fsanitize=thread to check there is no data race)
+                const Decimal shared = Decimal("123.45") / Decimal(7);
+                const Decimal other("17.6357");
+                const int32_t digits = (Decimal("123.45") / Decimal(7)).precision();
+                const int32_t sum_digits = (Decimal("123.45") / Decimal(7) + other).precision();
+                std::vector<std::thread> threads;
+                std::vector<int> mismatches(4);
+                for (int t = 0; t < 4; t++) {
+                        threads.emplace_back([&, t]() {
+                                for (int i = 0; i < 100; i++) {
+                                        Decimal copy(shared);
+                                        mismatches[t] += shared.precision() != digits;
+                                        mismatches[t] += copy.trailing_zeros() != 0;
+                                        mismatches[t] += shared == other;
+                                        mismatches[t] += (shared + other).precision() != sum_digits;
+                                }
+                        });
+                }
+                for (auto &thread : threads) {
+                        thread.join();
+                }
+                EXPECT_EQ(mismatches, std::vector<int>(4));
+        }
+}
+
 #if 0
 TEST_F(BIGNUM_DECIMAL_FIXTURE, min_max_decimal_value) {
         Decimal dmin = std::numeric_limits<Decimal>::min();
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "decimal.h"
+#include "decimal_column.h"
+#include "decimal_reduce.h"
+
+namespace bignum {
+using namespace detail;
+
+namespace {
+template <typename T>
+void check_reductions(const DecimalColumnImpl<T> &column, const std::vector<Decimal> &values) {
+        // std::min_element and std::max_element return the first of equal values as well
+        size_t expected_min = std::min_element(values.begin(), values.end()) - values.begin();
+        size_t expected_max = std::max_element(values.begin(), values.end()) - values.begin();
+        for (int32_t num_threads : {1, 3}) {
+                EXPECT_EQ(argmin(column, num_threads), expected_min);
+                EXPECT_EQ(argmax(column, num_threads), expected_max);
+                EXPECT_EQ(min(column, num_threads), values[expected_min]);
+                EXPECT_EQ(max(column, num_threads), values[expected_max]);
+        }
+}
+}  // namespace
+
+TEST(DecimalReduceTest, Basic) {
+        DecimalColumn column(2);
+        EXPECT_EQ(argmin(column), 0u);
+        EXPECT_EQ(argmax(column), 0u);
+
+        for (const char *s : {"1.5", "-2", "10.25", "-2.00", "10.25"}) {
+                column.push_back(Decimal(s));
+        }
+        EXPECT_EQ(argmin(column), 1u);
+        EXPECT_EQ(argmax(column), 2u);
+        EXPECT_EQ(min(column).to_string(), "-2");
+        EXPECT_EQ(max(column).to_string(), "10.25");
+
+        // The smallest and the largest values are in the side table
+        column.push_back(Decimal("-2.001"));
+        column.push_back(Decimal("99999999999999999999"));
+        EXPECT_EQ(argmin(column), 5u);
+        EXPECT_EQ(argmax(column), 6u);
+        EXPECT_EQ(min(column).to_string(), "-2.001");
+
+        // The first of equal values in the side table, where the payload INT64_MIN is wide as well
+        column.set(0, Decimal("99999999999999999999.000"));
+        EXPECT_EQ(argmax(column), 0u);
+        column.set(3, Decimal("-92233720368547758.08"));
+        column.set(5, Decimal("-92233720368547758.080"));
+        EXPECT_TRUE(column.is_wide(3));
+        EXPECT_EQ(argmin(column), 3u);
+        EXPECT_EQ(argmax(column, 4), 0u);
+
+        // All values in the side table
+        DecimalColumn wide(0);
+        wide.push_back(Decimal("0.5"));
+        wide.push_back(Decimal("-0.5"));
+        EXPECT_EQ(argmin(wide), 1u);
+        EXPECT_EQ(argmax(wide), 0u);
+
+        DecimalColumn128 column128(0);
+        column128.push_back(Decimal(kInt128Max));
+        column128.push_back(Decimal(kInt128Min + 1));
+        column128.push_back(Decimal(kInt128Min));
+        EXPECT_EQ(argmin(column128), 2u);
+        EXPECT_EQ(argmax(column128), 0u);
+}
+
+TEST(DecimalReduceTest, Random) {
+        std::mt19937_64 rng(20240614);
+        for (int64_t range : {int64_t{100}, int64_t{1} << 40, INT64_MAX}) {
+                std::vector<Decimal> values;
+                DecimalColumn column(2);
+                DecimalColumn128 column128(3);
+                for (size_t i = 0; i < 3 * kMinParallelReduceSize; ++i) {
+                        Decimal d = Decimal(static_cast<int64_t>(rng() % range) - range / 2) /
+                                    Decimal(100);
+                        if (rng() % 1000 == 0) {
+                                d = d / Decimal(8);
+                        }
+                        values.push_back(d);
+                        column.push_back(d);
+                        column128.push_back(d);
+                }
+                check_reductions(column, values);
+                check_reductions(column128, values);
+        }
+}
+}  // namespace bignum
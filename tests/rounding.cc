@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <string>
+
+#include "decimal.h"
+#include "test_util.h"
+
+namespace bignum {
+using namespace detail;
+
+namespace {
+// n / d rounded to an integer with kMode, for integers n and d, computed with the remainder.
+template <RoundingMode kMode>
+Decimal round_div(const Decimal &n, const Decimal &d) {
+        const Decimal zero(0);
+        const Decimal r = n % d;
+        const Decimal q = (n - r) / d;
+        if (r == zero) {
+                return q;
+        }
+        const Decimal twice = (r < zero ? -r : r) * Decimal(2);
+        const Decimal abs_d = d < zero ? -d : d;
+        const bool negative = (n < zero) != (d < zero);
+        bool away = false;
+        if constexpr (kMode == RoundingMode::kHalfUp) {
+                away = !(twice < abs_d);
+        } else if constexpr (kMode == RoundingMode::kHalfEven) {
+                away = abs_d < twice || (twice == abs_d && q % Decimal(2) != zero);
+        } else if constexpr (kMode == RoundingMode::kHalfDown) {
+                away = abs_d < twice;
+        } else if constexpr (kMode == RoundingMode::kUp) {
+                away = true;
+        } else if constexpr (kMode == RoundingMode::kFloor) {
+                away = negative;
+        } else if constexpr (kMode == RoundingMode::kCeiling) {
+                away = !negative;
+        }
+        return away ? q + Decimal(negative ? -1 : 1) : q;
+}
+
+// A random value of up to max_digits digits with the given scale, where the last digit is never
+// zero, so that the scale is kept on parsing. `integer` is the value times 10^scale.
+Decimal random_decimal(std::mt19937_64 &rng, int32_t max_digits, int32_t scale,
+                       Decimal &integer) {
+        const int32_t num_digits = 1 + static_cast<int32_t>(rng() % max_digits);
+        std::string digits;
+        for (int32_t i = 0; i + 1 < num_digits; ++i) {
+                digits += static_cast<char>('0' + rng() % 10);
+        }
+        digits += static_cast<char>('1' + rng() % 9);
+        if (rng() % 2) {
+                digits = "-" + digits;
+        }
+        integer = Decimal(digits.c_str());
+        return integer * make_decimal(1, scale);
+}
+
+template <RoundingMode kMode>
+void check_random(std::mt19937_64 &rng) {
+        for (int32_t i = 0; i < 2000; ++i) {
+                // The product is beyond the max scale, so it is rounded.
+                const int32_t lscale = 1 + static_cast<int32_t>(rng() % 30);
+                const int32_t rscale = 31 - lscale + static_cast<int32_t>(rng() % lscale);
+                const int32_t max_digits = 1 + static_cast<int32_t>(rng() % 40);
+                Decimal li, ri;
+                Decimal l = random_decimal(rng, max_digits, lscale, li);
+                Decimal r = random_decimal(rng, max_digits, rscale, ri);
+                ASSERT_EQ(l.get_scale(), lscale);
+                ASSERT_EQ(r.get_scale(), rscale);
+
+                Decimal product = l;
+                ASSERT_FALSE(product.mul<kMode>(r));
+                const int32_t k = lscale + rscale - Decimal::kMaxScale;
+                Decimal expected =
+                        round_div<kMode>(li * ri, power10(k)) * make_decimal(1, Decimal::kMaxScale);
+                ASSERT_EQ(product, expected) << l << " * " << r;
+                ASSERT_EQ(product.get_scale(), Decimal::kMaxScale);
+
+                // l / r at scale s, i.e., (li * 10^(rscale - lscale + s)) / ri
+                Decimal quotient = l;
+                ASSERT_FALSE(quotient.div<kMode>(r));
+                const int32_t s = std::min(Decimal::kMaxScale, lscale + 4);
+                const Decimal scaled = li * power10(rscale - lscale + s);
+                expected = round_div<kMode>(scaled, ri) * make_decimal(1, s);
+                ASSERT_EQ(quotient, expected) << l << " / " << r;
+                ASSERT_EQ(quotient.get_scale(), s);
+        }
+}
+}  // namespace
+
+TEST(DecimalRoundingTest, Basic) {
+        // 2.5 and -2.5 units of the max scale
+        const Decimal l("0.000000000000001");
+        const Decimal r("0.0000000000000025");
+        const Decimal unit("0.000000000000000000000000000001");
+        Decimal d = l;
+        EXPECT_FALSE(d.mul(r));
+        EXPECT_EQ(d, unit * Decimal(3));
+        EXPECT_EQ(d.get_scale(), 30);
+
+        auto product = [&](auto mode, const Decimal &rhs) {
+                Decimal p = l;
+                EXPECT_FALSE(p.mul<decltype(mode)::value>(rhs));
+                return p / unit;
+        };
+        auto quotient = [&](auto mode, const char *lhs, int64_t rhs) {
+                Decimal q(lhs);
+                EXPECT_FALSE(q.div<decltype(mode)::value>(Decimal(rhs)));
+                return q.to_string();
+        };
+        using HalfUp = std::integral_constant<RoundingMode, RoundingMode::kHalfUp>;
+        using HalfEven = std::integral_constant<RoundingMode, RoundingMode::kHalfEven>;
+        using HalfDown = std::integral_constant<RoundingMode, RoundingMode::kHalfDown>;
+        using Down = std::integral_constant<RoundingMode, RoundingMode::kDown>;
+        using Up = std::integral_constant<RoundingMode, RoundingMode::kUp>;
+        using Floor = std::integral_constant<RoundingMode, RoundingMode::kFloor>;
+        using Ceiling = std::integral_constant<RoundingMode, RoundingMode::kCeiling>;
+
+        EXPECT_EQ(product(HalfUp(), r), Decimal(3));
+        EXPECT_EQ(product(HalfEven(), r), Decimal(2));
+        EXPECT_EQ(product(HalfDown(), r), Decimal(2));
+        EXPECT_EQ(product(Down(), r), Decimal(2));
+        EXPECT_EQ(product(Up(), r), Decimal(3));
+        EXPECT_EQ(product(Floor(), r), Decimal(2));
+        EXPECT_EQ(product(Ceiling(), r), Decimal(3));
+        EXPECT_EQ(product(HalfUp(), -r), Decimal(-3));
+        EXPECT_EQ(product(HalfEven(), -r), Decimal(-2));
+        EXPECT_EQ(product(HalfDown(), -r), Decimal(-2));
+        EXPECT_EQ(product(Down(), -r), Decimal(-2));
+        EXPECT_EQ(product(Up(), -r), Decimal(-3));
+        EXPECT_EQ(product(Floor(), -r), Decimal(-3));
+        EXPECT_EQ(product(Ceiling(), -r), Decimal(-2));
+
+        EXPECT_EQ(quotient(HalfUp(), "1", 3), "0.3333");
+        EXPECT_EQ(quotient(Down(), "2", 3), "0.6666");
+        EXPECT_EQ(quotient(HalfDown(), "2", 3), "0.6667");
+        EXPECT_EQ(quotient(Up(), "1", 3), "0.3334");
+        EXPECT_EQ(quotient(Ceiling(), "-1", 3), "-0.3333");
+        EXPECT_EQ(quotient(Floor(), "-1", 3), "-0.3334");
+        // 62.5 units of the max scale, an exact tie
+        const char *tiny = "0.000000000000000000000000001";
+        EXPECT_EQ(quotient(HalfUp(), tiny, 16), "0.000000000000000000000000000063");
+        EXPECT_EQ(quotient(HalfEven(), tiny, 16), "0.000000000000000000000000000062");
+        EXPECT_EQ(quotient(HalfDown(), tiny, 16), "0.000000000000000000000000000062");
+        EXPECT_EQ(quotient(HalfDown(), tiny, -15), "-0.000000000000000000000000000067");
+        EXPECT_EQ(quotient(Ceiling(), tiny, -15), "-0.000000000000000000000000000066");
+
+        // Wide values go the same way
+        const Decimal wide("12345678901234567890123456789.000000000000000001");
+        d = wide;
+        EXPECT_FALSE(d.mul<RoundingMode::kCeiling>(Decimal("0.0000000000001")));
+        EXPECT_EQ(d.to_string(), "1234567890123456.789012345678900000000000000001");
+        d = wide;
+        EXPECT_FALSE(d.mul<RoundingMode::kDown>(Decimal("0.0000000000001")));
+        EXPECT_EQ(d, Decimal("1234567890123456.7890123456789"));
+}
+
+TEST(DecimalRoundingTest, Random) {
+        std::mt19937_64 rng(20240619);
+        check_random<RoundingMode::kHalfUp>(rng);
+        check_random<RoundingMode::kHalfEven>(rng);
+        check_random<RoundingMode::kHalfDown>(rng);
+        check_random<RoundingMode::kDown>(rng);
+        check_random<RoundingMode::kUp>(rng);
+        check_random<RoundingMode::kFloor>(rng);
+        check_random<RoundingMode::kCeiling>(rng);
+}
+}  // namespace bignum
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "decimal.h"
+#include "decimal_arith.h"
+#include "decimal_column.h"
+
+namespace bignum {
+using namespace detail;
+
+namespace {
+const std::string kNines(96, '9');
+
+// 96 nines with `scale` of them after the decimal point
+std::string max_string(int32_t scale) {
+        if (scale == 0) {
+                return kNines;
+        }
+        return kNines.substr(0, 96 - scale) + "." + kNines.substr(0, scale);
+}
+}  // namespace
+
+TEST(DecimalSaturateTest, MaxValue) {
+        EXPECT_EQ(Decimal::max_value().to_string(), kNines);
+        EXPECT_EQ(Decimal::min_value().to_string(), "-" + kNines);
+        EXPECT_EQ(Decimal::max_value(4).to_string(), max_string(4));
+        EXPECT_EQ(Decimal::max_value(4).get_scale(), 4);
+        EXPECT_EQ(Decimal::min_value(30).to_string(), "-" + max_string(30));
+        EXPECT_EQ(Decimal::max_value(2), Decimal(max_string(2).c_str()));
+}
+
+TEST(DecimalSaturateTest, Scalar) {
+        const Decimal max = Decimal::max_value();
+        const Decimal min = Decimal::min_value();
+        Decimal d = max;
+        EXPECT_EQ(d.add_saturating(Decimal(1)), max);
+        EXPECT_EQ(d.add_saturating(max), max);
+        EXPECT_EQ(d.sub_saturating(Decimal(-1)), max);
+        EXPECT_EQ(d.sub_saturating(max), Decimal(0));
+        d = min;
+        EXPECT_EQ(d.sub_saturating(Decimal(1)), min);
+        EXPECT_EQ(d.add_saturating(Decimal("-0.5")), Decimal::min_value(1));
+        EXPECT_EQ(d.get_scale(), 1);
+
+        // Results that fit are those of the checked operations
+        d = Decimal("1.5");
+        EXPECT_EQ(d.add_saturating(Decimal("2.25")).to_string(), "3.75");
+        EXPECT_EQ(d.sub_saturating(Decimal(4)).to_string(), "-0.25");
+        EXPECT_EQ(d.mul_saturating(Decimal("-0.2")).to_string(), "0.05");
+        const Decimal tiny(("0." + std::string(28, '0') + "1").c_str());
+        EXPECT_EQ(d.mul_saturating<RoundingMode::kDown>(tiny).to_string(), "0");
+
+        // Overflow from aligning the scales, where the exact result has a smaller magnitude
+        d = Decimal(("1" + std::string(91, '0')).c_str());
+        EXPECT_EQ(d.sub_saturating(Decimal("0.000001")), Decimal::max_value(6));
+        d = Decimal(("-1" + std::string(91, '0')).c_str());
+        EXPECT_EQ(d.add_saturating(Decimal("0.000001")), Decimal::min_value(6));
+
+        // Products
+        const Decimal big(("1" + std::string(60, '0')).c_str());
+        d = big;
+        EXPECT_EQ(d.mul_saturating(big), max);
+        d = big;
+        EXPECT_EQ(d.mul_saturating(-big), min);
+        d = -big;
+        EXPECT_EQ(d.mul_saturating(-big), max);
+        d = Decimal(("1" + std::string(80, '0')).c_str());
+        EXPECT_EQ(d.mul_saturating(Decimal("-1234567890123456.78")), Decimal::min_value(2));
+        {
+                ScopedDecimalContext guard(DecimalContext{.max_scale = 3});
+                d = big;
+                const Decimal r("1234567890123456789012345678901234567890.12345");
+                EXPECT_EQ(d.mul_saturating(r), Decimal::max_value(3));
+        }
+
+        // Errors other than overflows stick
+        d = Decimal(1);
+        d.div_sticky(Decimal(0));
+        EXPECT_TRUE(d.add_saturating(max).is_poisoned());
+        EXPECT_EQ(d.get_error(), ErrCode(kDivByZero));
+        d.poison(kDecimalAddSubOverflow);
+        EXPECT_EQ(d.add_saturating(Decimal(1)).get_error(), ErrCode(kDecimalAddSubOverflow));
+        EXPECT_EQ(d.mul_saturating(Decimal(1)).get_error(), ErrCode(kDecimalAddSubOverflow));
+}
+
+TEST(DecimalSaturateTest, Random) {
+        std::mt19937_64 rng(20240623);
+        auto random_decimal = [&]() {
+                std::string s = rng() % 2 ? "-" : "";
+                const int32_t digits = 1 + static_cast<int32_t>(rng() % 96);
+                for (int32_t i = 0; i < digits; ++i) {
+                        s += static_cast<char>('0' + rng() % 10);
+                }
+                const int32_t scale = static_cast<int32_t>(rng() % std::min(digits, 31));
+                if (scale > 0) {
+                        s.insert(s.size() - scale, ".");
+                }
+                return Decimal(s.c_str());
+        };
+        for (int32_t i = 0; i < 20000; ++i) {
+                const Decimal l = random_decimal();
+                const Decimal r = random_decimal();
+                Decimal expected = l;
+                Decimal d = l;
+                d.add_saturating(r);
+                if (expected.add(r)) {
+                        const int32_t scale = std::max(l.get_scale(), r.get_scale());
+                        expected = (l < -r) ? Decimal::min_value(scale) : Decimal::max_value(scale);
+                }
+                ASSERT_EQ(d, expected) << l << " + " << r;
+                ASSERT_EQ(d.get_scale(), expected.get_scale());
+
+                expected = l;
+                d = l;
+                d.mul_saturating(r);
+                if (expected.mul(r)) {
+                        const int32_t scale = std::min(l.get_scale() + r.get_scale(), 30);
+                        expected = (l.is_negative() != r.is_negative())
+                                           ? Decimal::min_value(scale)
+                                           : Decimal::max_value(scale);
+                }
+                ASSERT_EQ(d, expected) << l << " * " << r;
+                ASSERT_EQ(d.get_scale(), expected.get_scale());
+        }
+}
+
+TEST(DecimalSaturateTest, Column) {
+        DecimalColumn l(2);
+        DecimalColumn r(0);
+        const std::vector<Decimal> lvalues = {Decimal("1.25"), Decimal::max_value(2),
+                                              Decimal::min_value(2), Decimal("-0.01")};
+        const std::vector<Decimal> rvalues = {Decimal(3), Decimal(1), Decimal(2),
+                                              Decimal(("1" + std::string(95, '0')).c_str())};
+        for (size_t i = 0; i < lvalues.size(); ++i) {
+                l.push_back(lvalues[i]);
+                r.push_back(rvalues[i]);
+        }
+        DecimalColumn result;
+        add_saturating(l, r, result);
+        EXPECT_EQ(result.get_scale(), 2);
+        EXPECT_EQ(result[0].to_string(), "4.25");
+        EXPECT_EQ(result[1], Decimal::max_value(2));
+        EXPECT_EQ(result[2], Decimal::min_value(2) + Decimal(2));
+        EXPECT_EQ(result[3], Decimal::max_value(2));
+
+        sub_saturating(l, r, result);
+        EXPECT_EQ(result[0].to_string(), "-1.75");
+        EXPECT_EQ(result[1], Decimal::max_value(2) - Decimal(1));
+        EXPECT_EQ(result[2], Decimal::min_value(2));
+        EXPECT_EQ(result[3], Decimal::min_value(2));
+
+        mul_saturating(l, r, result);
+        EXPECT_EQ(result[0].to_string(), "3.75");
+        EXPECT_EQ(result[1], Decimal::max_value(2));
+        EXPECT_EQ(result[2], Decimal::min_value(2));
+        EXPECT_EQ(result[3], -Decimal(("1" + std::string(93, '0')).c_str()));
+
+#ifdef BIGNUM_ENABLE_EXCEPTIONS
+        EXPECT_THROW(add(l, r, result), std::runtime_error);
+        EXPECT_THROW(mul(l, r, result), std::runtime_error);
+#endif
+}
+}  // namespace bignum
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "decimal.h"
+#include "decimal_sort.h"
+
+namespace bignum {
+using namespace detail;
+
+TEST(DecimalSortTest, ToScaledInt128) {
+        __int128_t i = 0;
+        EXPECT_FALSE(Decimal("1.5").to_scaled_int128(3, i));
+        EXPECT_EQ(i, 1500);
+        EXPECT_FALSE(Decimal("-1.5").to_scaled_int128(1, i));
+        EXPECT_EQ(i, -15);
+        EXPECT_FALSE(Decimal(0).to_scaled_int128(30, i));
+        EXPECT_EQ(i, 0);
+        EXPECT_FALSE(Decimal(kInt128Min).to_scaled_int128(0, i));
+        EXPECT_EQ(i, kInt128Min);
+        EXPECT_EQ(Decimal("1.25").to_scaled_int128(1, i), ErrCode(kDecimalScaleOverflow));
+        EXPECT_FALSE((Decimal("0.75") * Decimal(2)).to_scaled_int128(1, i));
+        EXPECT_EQ(i, 15);
+        Decimal wide = Decimal("1000000000000000000000000000000000000000") *
+                       Decimal("0.000000000000000000000000000001");
+        EXPECT_FALSE(wide.to_scaled_int128(0, i));
+        EXPECT_EQ(i, 1000000000);
+        EXPECT_EQ(Decimal(kInt128Max).to_scaled_int128(1, i), ErrCode(kDecimalValueOutOfRange));
+        EXPECT_EQ(Decimal("1").to_scaled_int128(39, i), ErrCode(kDecimalValueOutOfRange));
+        EXPECT_EQ(Decimal("100000000000000000000000000000000000000").to_scaled_int128(1, i),
+                  ErrCode(kDecimalValueOutOfRange));
+        EXPECT_EQ(Decimal("123456789012345678901234567890123456789012").to_scaled_int128(0, i),
+                  ErrCode(kDecimalValueOutOfRange));
+}
+
+TEST(DecimalSortTest, Sort) {
+        std::vector<Decimal> values = {Decimal("1.5"),
+                                       Decimal("-2"),
+                                       Decimal("0.001"),
+                                       Decimal("0.75") * Decimal(2),
+                                       Decimal(INT64_MIN),
+                                       Decimal(INT64_MAX),
+                                       Decimal("-0.001"),
+                                       Decimal(0)};
+        std::vector<uint32_t> indices(values.size());
+        argsort(values, indices);
+        EXPECT_EQ(indices, (std::vector<uint32_t>{4, 1, 6, 7, 2, 0, 3, 5}));
+
+        // Keys wider than 64 bits
+        values.push_back(Decimal(kInt128Max) / Decimal(10000000000));
+        values.push_back(Decimal(kInt128Min) / Decimal(10000000000));
+        indices.resize(values.size());
+        argsort(values, indices);
+        EXPECT_EQ(indices, (std::vector<uint32_t>{9, 4, 1, 6, 7, 2, 0, 3, 5, 8}));
+
+        // Falls back to comparison as some value does not fit into int128
+        values.push_back(Decimal("-100000000000000000000000000000000000000000000000000"));
+        indices.resize(values.size());
+        argsort(values, indices);
+        EXPECT_EQ(indices, (std::vector<uint32_t>{10, 9, 4, 1, 6, 7, 2, 0, 3, 5, 8}));
+
+        sort(values);
+        EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+        EXPECT_EQ(values[6].to_string(), "0.001");
+        // Stable: "1.5" is still before the equal "1.50" (1.5 with scale 2)
+        EXPECT_EQ(values[7].get_scale(), 1);
+        EXPECT_EQ(values[8].get_scale(), 2);
+
+        // Poisoned values come last, in their order
+        std::vector<Decimal> poisoned = {Decimal("1.5"), Decimal(3), Decimal("-2"), Decimal(1)};
+        poisoned[1].poison(kDivByZero);
+        poisoned[3].poison(kDecimalMulOverflow);
+        indices.resize(poisoned.size());
+        argsort(poisoned, indices);
+        EXPECT_EQ(indices, (std::vector<uint32_t>{2, 0, 1, 3}));
+
+        std::vector<Decimal> empty;
+        sort(empty);
+        EXPECT_TRUE(empty.empty());
+}
+
+TEST(DecimalSortTest, Random) {
+        std::mt19937_64 rng(20240612);
+        for (int64_t range : {int64_t{1000}, int64_t{1} << 40, INT64_MAX}) {
+                std::vector<Decimal> values;
+                for (int32_t i = 0; i < 200000; ++i) {
+                        Decimal d(static_cast<int64_t>(rng() % range) - range / 2);
+                        values.push_back(d / Decimal(kUint64Power10[rng() % 6]));
+                }
+                std::vector<Decimal> expected = values;
+                std::stable_sort(expected.begin(), expected.end());
+                for (int32_t num_threads : {1, 4}) {
+                        std::vector<Decimal> sorted = values;
+                        sort(sorted, num_threads);
+                        ASSERT_EQ(sorted.size(), expected.size());
+                        for (size_t i = 0; i < sorted.size(); ++i) {
+                                ASSERT_EQ(sorted[i], expected[i]);
+                                ASSERT_EQ(sorted[i].get_scale(), expected[i].get_scale());
+                        }
+                }
+        }
+}
+}  // namespace bignum
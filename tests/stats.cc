@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "decimal.h"
+#include "decimal_divisor.h"
+
+namespace bignum {
+
+TEST(DecimalStatsTest, Count) {
+        Decimal d0("1.5");
+        Decimal d1("12345678901234567890.5");
+        Decimal d2("123456789012345678901234567890123456789012345.5");
+        Decimal d3("123456789012345678901234567890123456789012345678901234567890123456789012345678"
+                   "9.5");
+
+        reset_decimal_stats();
+        (void)(d0 + d0);
+        (void)(d0 - d1);
+        (void)(d1 * d2);
+        (void)(d2 / d0);
+        (void)(d3 % d0);
+
+        const DecimalStats &stats = get_decimal_stats();
+#ifdef BIGNUM_DEV_USE_GMP_ONLY
+        EXPECT_EQ(stats.get(DecimalStats::kAdd, DecimalStats::kGmp), 1u);
+        EXPECT_EQ(stats.get(DecimalStats::kSub, DecimalStats::kGmp), 1u);
+        EXPECT_EQ(stats.get(DecimalStats::kMul, DecimalStats::kGmp), 1u);
+        EXPECT_EQ(stats.get(DecimalStats::kDiv, DecimalStats::kGmp), 1u);
+#else
+        EXPECT_EQ(stats.get(DecimalStats::kAdd, DecimalStats::kInt64), 1u);
+        EXPECT_EQ(stats.get(DecimalStats::kSub, DecimalStats::kInt128), 1u);
+        EXPECT_EQ(stats.get(DecimalStats::kMul, DecimalStats::kInt256), 1u);
+        EXPECT_EQ(stats.get(DecimalStats::kDiv, DecimalStats::kInt256), 1u);
+#endif
+        EXPECT_EQ(stats.get(DecimalStats::kMod, DecimalStats::kGmp), 1u);
+        EXPECT_EQ(stats.total(DecimalStats::kAdd), 1u);
+        EXPECT_EQ(stats.total(DecimalStats::kSub), 1u);
+        EXPECT_EQ(stats.total(DecimalStats::kMul), 1u);
+        EXPECT_EQ(stats.total(DecimalStats::kDiv), 1u);
+        EXPECT_EQ(stats.total(DecimalStats::kMod), 1u);
+
+        reset_decimal_stats();
+        EXPECT_EQ(stats.total(DecimalStats::kAdd), 0u);
+}
+
+// Results calculated with gmp are narrowed down, so that subsequent operations on them take the
+// fast integer paths.
+TEST(DecimalStatsTest, NarrowestRepresentation) {
+#ifdef BIGNUM_DEV_USE_GMP_ONLY
+        GTEST_SKIP() << "All values are stored in gmp";
+#endif
+        Decimal big("123456789012345678901234567890123456789012345678901234567890123456789012345"
+                    "678901234567890");
+        Decimal big2 = big + Decimal(1);
+        Decimal small("2.5");
+
+        Decimal q = big2 / big;
+        Decimal r = big2 % big;
+        Decimal d = big2 - big;
+        const Decimal tiny("0.000000000000000000000000000001");
+        Decimal m = big * tiny * tiny * tiny * Decimal("0.000000000000000000000000001");
+        EXPECT_EQ(q.to_string(), "1");
+        EXPECT_EQ(r.to_string(), "1");
+        EXPECT_EQ(d.to_string(), "1");
+        EXPECT_EQ(m.to_string(), "0.000000000000000000000000000123");
+
+        reset_decimal_stats();
+        (void)(q + small);
+        (void)(r + small);
+        (void)(d + small);
+        (void)(m + small);
+        EXPECT_EQ(get_decimal_stats().get(DecimalStats::kAdd, DecimalStats::kInt64), 4u);
+
+        Decimal i256("12345678901234567890123456789012345678901234567890.1");
+        Decimal p = i256 * tiny * tiny;
+        EXPECT_EQ(p.to_string(), "0.00000000001234567890123456789");
+        Decimal z = i256 - i256;
+        Decimal n = -(-Decimal(INT64_MIN));
+
+        reset_decimal_stats();
+        (void)(p + small);
+        (void)(z + small);
+        (void)(n + small);
+        EXPECT_EQ(get_decimal_stats().get(DecimalStats::kAdd, DecimalStats::kInt128), 1u);
+        EXPECT_EQ(get_decimal_stats().get(DecimalStats::kAdd, DecimalStats::kInt64), 2u);
+}
+
+TEST(DecimalStatsTest, DecimalDivisor) {
+        DecimalDivisor three("3");
+        reset_decimal_stats();
+        (void)(Decimal("1.5") / three);
+        EXPECT_EQ(get_decimal_stats().total(DecimalStats::kDiv), 1u);
+}
+}  // namespace bignum
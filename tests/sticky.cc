@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "decimal.h"
+#include "decimal_divisor.h"
+#include "test_util.h"
+
+namespace bignum {
+using namespace detail;
+
+TEST(DecimalStickyTest, Poison) {
+        Decimal d("1.5");
+        EXPECT_FALSE(d.is_poisoned());
+        EXPECT_EQ(d.get_error(), ErrCode(kSuccess));
+
+        d.poison(kDivByZero);
+        EXPECT_TRUE(d.is_poisoned());
+        EXPECT_EQ(d.get_error(), ErrCode(kDivByZero));
+        EXPECT_EQ(d.to_string(), "NaN");
+        EXPECT_EQ(d.get_scale(), 0);
+
+        Decimal copy = d;
+        EXPECT_TRUE(copy.is_poisoned());
+        EXPECT_EQ(copy.get_error(), ErrCode(kDivByZero));
+        copy = -d;
+        EXPECT_EQ(copy.get_error(), ErrCode(kDivByZero));
+        EXPECT_EQ(copy.rescale(2), ErrCode(kDivByZero));
+        EXPECT_TRUE(copy.is_poisoned());
+        copy = Decimal(2);
+        EXPECT_FALSE(copy.is_poisoned());
+
+        // A gmp value turns into a poisoned one and back
+        Decimal wide("1234567890123456789012345678901234567890123456789012345678901234567890");
+        wide.poison(kDecimalMulOverflow);
+        EXPECT_EQ(wide.get_error(), ErrCode(kDecimalMulOverflow));
+        wide = Decimal("1234567890123456789012345678901234567890123456789012345678901234567890");
+        EXPECT_EQ(wide.to_string(),
+                  "1234567890123456789012345678901234567890123456789012345678901234567890");
+}
+
+TEST(DecimalStickyTest, Propagate) {
+        Decimal nan;
+        nan.poison(kDecimalAddSubOverflow);
+        Decimal other;
+        other.poison(kDivByZero);
+        const Decimal values[] = {Decimal(0), Decimal("-2.5"), Decimal(kInt128Max), power10(90)};
+        for (const Decimal &v : values) {
+                Decimal d = v;
+                EXPECT_EQ(d.add(nan), ErrCode(kDecimalAddSubOverflow));
+                EXPECT_EQ(d.get_error(), ErrCode(kDecimalAddSubOverflow));
+                d = v;
+                EXPECT_EQ(d.sub(nan), ErrCode(kDecimalAddSubOverflow));
+                EXPECT_TRUE(d.is_poisoned());
+                d = v;
+                EXPECT_EQ(d.mul(nan), ErrCode(kDecimalAddSubOverflow));
+                EXPECT_TRUE(d.is_poisoned());
+                d = v;
+                EXPECT_EQ(d.div(nan), ErrCode(kDecimalAddSubOverflow));
+                EXPECT_TRUE(d.is_poisoned());
+                d = v;
+                EXPECT_EQ(d.mod(nan), ErrCode(kDecimalAddSubOverflow));
+                EXPECT_TRUE(d.is_poisoned());
+
+                d = nan;
+                EXPECT_EQ(d.add(v), ErrCode(kDecimalAddSubOverflow));
+                EXPECT_EQ(d.div(v), ErrCode(kDecimalAddSubOverflow));
+                EXPECT_EQ(d.get_error(), ErrCode(kDecimalAddSubOverflow));
+                EXPECT_EQ(v / DecimalDivisor(Decimal(3)), v / Decimal(3));
+                EXPECT_EQ(DecimalDivisor(Decimal(3)).div(d), ErrCode(kDecimalAddSubOverflow));
+
+                // Like a NaN
+                EXPECT_FALSE(v == nan);
+                EXPECT_FALSE(nan == v);
+                EXPECT_TRUE(v != nan);
+                EXPECT_FALSE(v < nan);
+                EXPECT_FALSE(nan < v);
+                EXPECT_FALSE(v <= nan);
+                EXPECT_FALSE(nan <= v);
+                EXPECT_FALSE(v > nan);
+                EXPECT_FALSE(nan > v);
+                EXPECT_FALSE(v >= nan);
+                EXPECT_FALSE(nan >= v);
+        }
+        EXPECT_FALSE(nan == nan);
+        EXPECT_TRUE(nan != nan);
+
+        // The first error sticks
+        Decimal d = nan;
+        EXPECT_EQ(d.mul(other), ErrCode(kDecimalAddSubOverflow));
+        d = other;
+        EXPECT_EQ(d.mul(nan), ErrCode(kDivByZero));
+        EXPECT_EQ(d.get_error(), ErrCode(kDivByZero));
+}
+
+TEST(DecimalStickyTest, Sticky) {
+        Decimal d(1);
+        d.div_sticky(Decimal(0)).add_sticky(Decimal(1)).mul_sticky(Decimal(2));
+        EXPECT_EQ(d.get_error(), ErrCode(kDivByZero));
+
+        d = power10(90);
+        d.mul_sticky(power10(10)).div_sticky(Decimal(0));
+        EXPECT_EQ(d.get_error(), ErrCode(kDecimalMulOverflow));
+
+        d = Decimal(std::string(96, '9').c_str());
+        d.add_sticky(Decimal(1)).sub_sticky(Decimal(1));
+        EXPECT_EQ(d.get_error(), ErrCode(kDecimalAddSubOverflow));
+
+        d = Decimal(7);
+        d.mod_sticky(Decimal(0));
+        EXPECT_TRUE(d.is_poisoned());
+
+        d = Decimal("2.5");
+        d.mul_sticky<RoundingMode::kHalfEven>(Decimal(3)).div_sticky<RoundingMode::kDown>(
+                Decimal(4));
+        EXPECT_FALSE(d.is_poisoned());
+        EXPECT_EQ(d.to_string(), "1.875");
+        d.sub_sticky(Decimal("0.875")).mod_sticky(Decimal(2));
+        EXPECT_EQ(d, Decimal(1));
+
+        // Straight-line batch, checked once per row: (a * b - c) / d
+        const std::vector<Decimal> a = {Decimal(1), power10(60), Decimal("2.5"), Decimal(4)};
+        const std::vector<Decimal> b = {Decimal(2), power10(40), Decimal(2), Decimal(1)};
+        const std::vector<Decimal> c = {Decimal(1), Decimal(0), Decimal(1), Decimal(4)};
+        const std::vector<Decimal> e = {Decimal(4), Decimal(1), Decimal(0), Decimal(3)};
+        std::vector<Decimal> result(a.size());
+        for (size_t i = 0; i < a.size(); ++i) {
+                result[i] = a[i];
+                result[i].mul_sticky(b[i]).sub_sticky(c[i]).div_sticky(e[i]);
+        }
+        EXPECT_EQ(result[0].to_string(), "0.25");
+        EXPECT_EQ(result[1].get_error(), ErrCode(kDecimalMulOverflow));
+        EXPECT_EQ(result[2].get_error(), ErrCode(kDivByZero));
+        EXPECT_EQ(result[3], Decimal(0));
+}
+}  // namespace bignum
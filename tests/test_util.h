@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "decimal.h"
+
+// Helpers shared by several unit tests.
+namespace bignum {
+// 10^n
+inline Decimal power10(int32_t n) { return Decimal(("1" + std::string(n, '0')).c_str()); }
+
+// m / 10^scale, exactly.
+inline Decimal make_decimal(int64_t m, int32_t scale) {
+        if (scale == 0) {
+                return Decimal(m);
+        }
+        return Decimal(m) * Decimal(("0." + std::string(scale - 1, '0') + "1").c_str());
+}
+}  // namespace bignum
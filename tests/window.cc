@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "decimal.h"
+#include "decimal_window.h"
+
+namespace bignum {
+using namespace detail;
+
+TEST(DecimalWindowTest, TrimScale) {
+        Decimal d = Decimal("0.75") * Decimal(2);
+        EXPECT_EQ(d.get_scale(), 2);
+        EXPECT_FALSE(d.trim_scale(1));
+        EXPECT_EQ(d.get_scale(), 1);
+        EXPECT_EQ(d, Decimal("1.5"));
+        EXPECT_EQ(d.trim_scale(0), ErrCode(kDecimalScaleOverflow));
+        EXPECT_EQ(d.get_scale(), 1);
+        EXPECT_FALSE(d.trim_scale(3));
+        EXPECT_EQ(d.get_scale(), 1);
+
+        d = Decimal("1.000") - Decimal("1.000");
+        EXPECT_FALSE(d.trim_scale(0));
+        EXPECT_EQ(d.get_scale(), 0);
+        EXPECT_EQ(d, Decimal(0));
+
+        // 10^60 with scale 30, internally a gmp integer
+        d = Decimal("1000000000000000000000000000000") *
+            Decimal("1.000000000000000000000000000000");
+        EXPECT_FALSE(d.trim_scale(0));
+        EXPECT_EQ(d.to_string(), "1000000000000000000000000000000");
+        d = -d;
+        d += Decimal("0.5");
+        EXPECT_FALSE(d.trim_scale(1));
+        EXPECT_EQ(d.get_scale(), 1);
+        EXPECT_EQ(d.to_string(), "-999999999999999999999999999999.5");
+}
+
+TEST(DecimalWindowTest, Basic) {
+        RollingSum sum(3);
+        RollingMin min(3);
+        RollingMax max(3);
+        const char *values[] = {"1", "2.5", "-1", "0.25", "4", "4.0", "-3"};
+        const char *sums[] = {"1", "3.5", "2.5", "1.75", "3.25", "8.25", "5"};
+        const char *mins[] = {"1", "1", "-1", "-1", "-1", "0.25", "-3"};
+        const char *maxs[] = {"1", "2.5", "2.5", "2.5", "4", "4", "4"};
+        for (size_t i = 0; i < std::size(values); ++i) {
+                sum.push(Decimal(values[i]));
+                min.push(Decimal(values[i]));
+                max.push(Decimal(values[i]));
+                EXPECT_EQ(sum.size(), std::min<size_t>(i + 1, 3));
+                EXPECT_EQ(sum.sum().to_string(), sums[i]);
+                EXPECT_EQ(min.value().to_string(), mins[i]);
+                EXPECT_EQ(max.value().to_string(), maxs[i]);
+        }
+        // "0.25" left the window, and so did the fractional digits of the sum ("4.0" is parsed
+        // with scale 0)
+        EXPECT_EQ(sum.sum().get_scale(), 0);
+        EXPECT_EQ(sum.avg().to_string(), "1.6667");
+
+        sum.clear();
+        min.clear();
+        EXPECT_TRUE(sum.empty());
+        EXPECT_TRUE(min.empty());
+        EXPECT_EQ(sum.sum(), Decimal(0));
+}
+
+TEST(DecimalWindowTest, Random) {
+        std::mt19937_64 rng(20240615);
+        std::vector<Decimal> values;
+        for (int32_t i = 0; i < 3000; ++i) {
+                Decimal d(static_cast<int64_t>(rng() % 20000) - 10000);
+                d = d / Decimal(kUint64Power10[rng() % 4]);
+                if (rng() % 100 == 0) {
+                        d = d * Decimal("10000000000000000000000000000000000000000");
+                } else if (rng() % 100 == 0) {
+                        d = d * Decimal("0.000000000000000000000001");
+                }
+                values.push_back(d);
+        }
+        for (size_t window : {1, 2, 7, 100}) {
+                RollingSum sum(window);
+                RollingMin min(window);
+                RollingMax max(window);
+                for (size_t i = 0; i < values.size(); ++i) {
+                        sum.push(values[i]);
+                        min.push(values[i]);
+                        max.push(values[i]);
+
+                        const size_t begin = i + 1 > window ? i + 1 - window : 0;
+                        const auto first = values.begin() + begin;
+                        const auto last = values.begin() + i + 1;
+                        Decimal expected(0);
+                        for (auto it = first; it != last; ++it) {
+                                expected += *it;
+                        }
+                        ASSERT_EQ(sum.sum(), expected);
+                        ASSERT_EQ(sum.sum().get_scale(), expected.get_scale());
+                        Decimal avg = expected / Decimal(static_cast<int64_t>(last - first));
+                        ASSERT_EQ(sum.avg(), avg);
+                        ASSERT_EQ(sum.avg().get_scale(), avg.get_scale());
+
+                        auto it = std::min_element(first, last);
+                        ASSERT_EQ(min.value(), *it);
+                        ASSERT_EQ(min.value().get_scale(), it->get_scale());
+                        it = std::max_element(first, last);
+                        ASSERT_EQ(max.value(), *it);
+                        ASSERT_EQ(max.value().get_scale(), it->get_scale());
+                }
+        }
+}
+}  // namespace bignum